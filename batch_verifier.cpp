@@ -0,0 +1,118 @@
+#include "batch_verifier.h"
+
+#include <array>
+#include <stdexcept>
+
+#include "binary/gear_file.h"
+#include "data/brand.h"
+#include "helpers/parallel.h"
+
+
+#pragma mark - SubmissionBatch
+void SubmissionBatch::add(const std::string_view brand, const uint32_t initialSeed, const RollSequence& rollSequence) {
+    if (rollSequence.hasUncertainDrinks()) {
+        throw std::invalid_argument("Cannot verify submission: Some drinks in the roll sequence are uncertain.");
+    }
+    const auto brandIndex = GearFile::getBrandIndex(brand);
+
+    brandIndices.push_back(brandIndex);
+    initialSeeds.push_back(initialSeed);
+    for (const auto [abilities, drinks]: rollSequence) {
+        rolls.push_back(PackedRoll{abilities.getMask(), static_cast<uint8_t>(AbilityHelper::getIndex(drinks.getSingle()))});
+    }
+    rollStarts.push_back(rolls.size());
+}
+
+
+#pragma mark - BatchVerifier
+BatchVerifier::BatchVerifier(): seedHelpers{} {
+    // Same order as `GearFile::getBrandIndex`.
+    constexpr size_t brandsCount = neutralBrands.size() + biasedBrands.size();
+    seedHelpers.reserve(brandsCount);
+    for (size_t i = 0; i < brandsCount; i += 1) {
+        seedHelpers.emplace_back(GearFile::getBrand(static_cast<uint8_t>(i)));
+        seedHelpers.back().cacheAllDrinkRollToAbilityMaps();
+    }
+}
+
+void BatchVerifier::verifyRange(const SubmissionBatch& batch, const size_t start, const size_t stop, VerificationResult* const results) const {
+    constexpr auto noDrinkIndex = static_cast<uint8_t>(AbilityHelper::getIndex(Ability::noDrink));
+
+    struct Lane {
+        size_t submission;
+        size_t rollStart;
+        size_t roll;
+        size_t rollStop;
+        uint32_t seed;
+        const SeedHelper* seedHelper;
+    };
+    std::array<Lane, lanesCount> lanes{};
+
+    // Load the next non-empty submission into `lane`. Empty submissions are valid as they are.
+    size_t nextSubmission = start;
+    const auto loadLane = [&](Lane& lane) {
+        while (nextSubmission < stop) {
+            const auto i = nextSubmission;
+            nextSubmission += 1;
+
+            const auto rollStart = batch.rollStarts[i];
+            const auto rollStop = batch.rollStarts[i + 1];
+            if (rollStart == rollStop) {
+                results[i] = VerificationResult{true, 0, batch.initialSeeds[i]};
+                continue;
+            }
+
+            if (batch.brandIndices[i] >= seedHelpers.size()) {
+                throw std::invalid_argument("Invalid brand index: " + std::to_string(batch.brandIndices[i]));
+            }
+            lane = Lane{i, rollStart, rollStart, rollStop, batch.initialSeeds[i], &seedHelpers[batch.brandIndices[i]]};
+            return true;
+        }
+        return false;
+    };
+
+    size_t activeLanesCount = 0;
+    while ((activeLanesCount < lanesCount) && loadLane(lanes[activeLanesCount])) {
+        activeLanesCount += 1;
+    }
+
+    // 1 roll per lane in turn. Finished lanes take the next submission, or swap with the last active lane.
+    while (activeLanesCount > 0) {
+        for (size_t i = 0; i < activeLanesCount;) {
+            auto& lane = lanes[i];
+            const auto roll = batch.rolls[lane.roll];
+
+            Ability ability;
+            if (roll.drink == noDrinkIndex) {
+                std::tie(lane.seed, ability) = lane.seedHelper->generateRoll(lane.seed);
+            } else {
+                std::tie(lane.seed, ability) = lane.seedHelper->generateRollWithDrink(lane.seed, static_cast<Ability>(roll.drink));
+            }
+            const auto isMatch = ((roll.abilitiesMask >> AbilityHelper::getIndex(ability)) & 1) != 0;
+
+            lane.roll += 1;
+            if (isMatch && (lane.roll < lane.rollStop)) {
+                i += 1;
+                continue;
+            }
+
+            results[lane.submission] = VerificationResult{isMatch, static_cast<uint32_t>((isMatch ? lane.rollStop : lane.roll - 1) - lane.rollStart), lane.seed};
+            if (!loadLane(lane)) {
+                activeLanesCount -= 1;
+                lane = lanes[activeLanesCount];
+                // The swapped-in lane runs next.
+            }
+        }
+    }
+}
+
+std::vector<VerificationResult> BatchVerifier::verify(const SubmissionBatch& batch, const size_t workersCount) const {
+    // Chunks: Submissions may have very different lengths.
+    constexpr size_t chunksPerWorker = 16;
+
+    std::vector<VerificationResult> returnValue(batch.size());
+    Parallel::forEachChunk(batch.size(), workersCount, workersCount * chunksPerWorker, [&](const size_t start, const size_t stop) {
+        verifyRange(batch, start, stop, returnValue.data());
+    });
+    return returnValue;
+}
@@ -0,0 +1,76 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_BATCH_VERIFIER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_BATCH_VERIFIER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "seed_helper.h"
+
+
+/// 1 roll of a `SubmissionBatch`.
+struct PackedRoll {
+    AbilitySet::MaskType abilitiesMask;
+    /// `AbilityHelper::getIndex` of the drink, or of `Ability::noDrink`.
+    uint8_t drink;
+};
+
+
+/**
+ * Many (brand, initial seed, roll sequence) submissions, packed into flat arrays.
+ *
+ * Submission `i`'s rolls: `rolls[rollStarts[i]]` to `rolls[rollStarts[i + 1] - 1]`.
+ */
+struct SubmissionBatch {
+    /// `GearFile::getBrandIndex`.
+    std::vector<uint8_t> brandIndices;
+    std::vector<uint32_t> initialSeeds;
+    /// Submissions count + 1 offsets.
+    std::vector<size_t> rollStarts{0};
+    std::vector<PackedRoll> rolls;
+
+    [[nodiscard]] size_t size() const {
+        return initialSeeds.size();
+    }
+
+    /// @throws std::invalid_argument for unknown brands, or rolls with uncertain drinks.
+    void add(std::string_view brand, uint32_t initialSeed, const RollSequence& rollSequence);
+};
+
+
+struct VerificationResult {
+    bool isValid;
+    /// Index of the first roll that doesn't match, or the rolls count if valid.
+    uint32_t firstMismatchIndex;
+    /// Seed after the last replayed roll: The whole sequence if valid, or up to the first mismatch.
+    uint32_t finalSeed;
+};
+
+
+/**
+ * `SeedHelper::replayRollSequence` for many submissions at once.
+ *
+ * - Every brand's drink maps are cached on construction, so `verify` is `const` and thread-safe
+ * - Replays stop at the first mismatch
+ * - Each worker interleaves `lanesCount` submissions, 1 roll each in turn, so that their (independent) seed and modulo latencies overlap
+ */
+class BatchVerifier {
+public:
+    static constexpr size_t lanesCount = 8;
+
+private:
+    /// Indices: `GearFile::getBrandIndex`.
+    std::vector<SeedHelper> seedHelpers;
+
+public:
+    BatchVerifier();
+
+    /// Submissions [start, stop) of `batch`, on the current thread.
+    void verifyRange(const SubmissionBatch& batch, size_t start, size_t stop, VerificationResult* results) const;
+
+    /// @return Indices correspond to `batch`'s submissions.
+    [[nodiscard]] std::vector<VerificationResult> verify(const SubmissionBatch& batch, size_t workersCount = 0) const;
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_BATCH_VERIFIER_H
@@ -0,0 +1,25 @@
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "workloads.h"
+
+
+/**
+ * `benchmark_main`, with the source version and workload seed in the report context.
+ *
+ * JSON reports: `--benchmark_out=<file> --benchmark_out_format=json` (or the `benchmarks_json` target).
+ */
+int main(int argc, char* argv[]) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    benchmark::AddCustomContext("source_version", SOURCE_VERSION);
+    benchmark::AddCustomContext("workload_seed", std::to_string(Workloads::randomizerSeed));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
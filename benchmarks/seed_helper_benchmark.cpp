@@ -0,0 +1,148 @@
+#include <array>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "workloads.h"
+#include "../batch_verifier.h"
+
+
+using Workloads::BrandKind;
+using Workloads::DrinkMix;
+
+
+#pragma mark - Find seed
+/// Seeds searched per iteration, starting from the gear's block, so that 1 seed matches.
+static constexpr uint32_t findSeedWorkerSeedsCount = 1 << 22;
+
+/// Args: Brand kind, sequence length, drink mix.
+static void findSeedWorker(benchmark::State& state) {
+    const auto brandKind = static_cast<BrandKind>(state.range(0));
+    const auto length = static_cast<size_t>(state.range(1));
+    const auto drinkMix = static_cast<DrinkMix>(state.range(2));
+
+    SeedHelper seedHelper{Workloads::getBrand(brandKind)};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    RollRandomizer randomizer{Workloads::randomizerSeed};
+    const auto gear = Workloads::makeGear(seedHelper, randomizer, length, drinkMix);
+
+    const auto seedStart = gear.initialSeed - (gear.initialSeed % findSeedWorkerSeedsCount);
+    const auto seedStop = seedStart + (findSeedWorkerSeedsCount - 1);
+    for (auto _: state) {
+        auto results = seedHelper.findSeedInRange(gear.rollSequence, seedStart, seedStop);
+        benchmark::DoNotOptimize(results);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * findSeedWorkerSeedsCount);
+    state.SetLabel(std::string{Workloads::getBrand(brandKind)} + "/" + std::string{Workloads::getId(drinkMix)});
+}
+BENCHMARK(findSeedWorker)
+    ->ArgNames({"biased", "length", "drinks"})
+    ->ArgsProduct({{0, 1}, {3, 10, 30}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMillisecond);
+
+
+static constexpr uint32_t findSeedSeedsCount = 1 << 24;
+
+/// Args: Workers count.
+static void findSeed(benchmark::State& state) {
+    const auto workersCount = static_cast<size_t>(state.range(0));
+
+    SeedHelper seedHelper{Workloads::getBrand(BrandKind::neutral)};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    RollRandomizer randomizer{Workloads::randomizerSeed};
+    const auto gear = Workloads::makeGear(seedHelper, randomizer, 10, DrinkMix::some);
+
+    for (auto _: state) {
+        auto results = seedHelper.findSeedInRange(gear.rollSequence, 0, findSeedSeedsCount - 1, workersCount);
+        benchmark::DoNotOptimize(results);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * findSeedSeedsCount);
+}
+BENCHMARK(findSeed)
+    ->ArgNames({"workers"})
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime()
+    ->MeasureProcessCPUTime()
+    ->Unit(benchmark::kMillisecond);
+
+
+#pragma mark - Prediction
+/// Args: Brand kind, length.
+static void generateRolls(benchmark::State& state) {
+    const auto brandKind = static_cast<BrandKind>(state.range(0));
+    const auto length = static_cast<size_t>(state.range(1));
+
+    const SeedHelper seedHelper{Workloads::getBrand(brandKind)};
+    RollRandomizer randomizer{Workloads::randomizerSeed};
+    const auto seed = randomizer.getSeed();
+
+    for (auto _: state) {
+        auto rolls = seedHelper.generateRolls(seed, length);
+        benchmark::DoNotOptimize(rolls);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * length));
+}
+BENCHMARK(generateRolls)
+    ->ArgNames({"biased", "length"})
+    ->ArgsProduct({{0, 1}, {15, 1000}});
+
+
+/// Args: Length, drink mix (no uncertain drinks).
+static void advanceSeedToEndOfRollSequence(benchmark::State& state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto drinkMix = static_cast<DrinkMix>(state.range(1));
+
+    SeedHelper seedHelper{Workloads::getBrand(BrandKind::biased)};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    RollRandomizer randomizer{Workloads::randomizerSeed};
+    const auto gear = Workloads::makeGear(seedHelper, randomizer, length, drinkMix);
+
+    for (auto _: state) {
+        auto result = seedHelper.advanceSeedToEndOfRollSequence(gear.initialSeed, gear.rollSequence);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * length));
+    state.SetLabel(std::string{Workloads::getId(drinkMix)});
+}
+BENCHMARK(advanceSeedToEndOfRollSequence)
+    ->ArgNames({"length", "drinks"})
+    ->ArgsProduct({{10, 100, 1000}, {0, 1, 2}});
+
+
+#pragma mark - Verification
+static constexpr size_t verifySubmissionsCount = 1 << 16;
+
+/// Args: Length, workers count. Valid submissions with some drinks, alternating brands.
+static void verifyBatch(benchmark::State& state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto workersCount = static_cast<size_t>(state.range(1));
+
+    std::array<SeedHelper, 2> seedHelpers{SeedHelper{Workloads::getBrand(BrandKind::neutral)}, SeedHelper{Workloads::getBrand(BrandKind::biased)}};
+    for (auto& seedHelper: seedHelpers) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+    }
+    RollRandomizer randomizer{Workloads::randomizerSeed};
+    SubmissionBatch batch{};
+    for (size_t i = 0; i < verifySubmissionsCount; i += 1) {
+        const auto& seedHelper = seedHelpers[i % seedHelpers.size()];
+        const auto gear = Workloads::makeGear(seedHelper, randomizer, length, DrinkMix::some);
+        batch.add(seedHelper.brandName, gear.initialSeed, gear.rollSequence);
+    }
+
+    const BatchVerifier verifier{};
+    for (auto _: state) {
+        auto results = verifier.verify(batch, workersCount);
+        benchmark::DoNotOptimize(results);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * verifySubmissionsCount);
+}
+BENCHMARK(verifyBatch)
+    ->ArgNames({"length", "workers"})
+    ->ArgsProduct({{10, 30}, {0, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
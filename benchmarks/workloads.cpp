@@ -0,0 +1,50 @@
+#include "workloads.h"
+
+#include "../data/brand.h"
+
+
+namespace Workloads {
+    std::string_view getBrand(const BrandKind kind) {
+        return (kind == BrandKind::neutral) ? neutralBrands[0] : std::get<0>(biasedBrands[0]);
+    }
+
+    std::string_view getId(const DrinkMix drinkMix) {
+        switch (drinkMix) {
+            case DrinkMix::none:
+                return "no_drinks";
+            case DrinkMix::some:
+                return "some_drinks";
+            case DrinkMix::all:
+                return "all_drinks";
+            case DrinkMix::uncertain:
+                return "uncertain_drinks";
+        }
+        return {};
+    }
+
+    Gear makeGear(const SeedHelper& seedHelper, RollRandomizer& randomizer, const size_t length, const DrinkMix drinkMix) {
+        const auto drinkRatio = (drinkMix == DrinkMix::none) ? 0.0 : ((drinkMix == DrinkMix::all) ? 1.0 : 0.3);
+        const auto drinks = randomizer.getDrinks(length, drinkRatio);
+
+        Gear returnValue{randomizer.getSeed(), RollSequence{}};
+        auto seed = returnValue.initialSeed;
+        for (const auto drink: drinks) {
+            if (drink == Ability::noDrink) {
+                const auto [nextSeed, ability] = seedHelper.generateRoll(seed);
+                returnValue.rollSequence.addRoll(ability);
+                seed = nextSeed;
+                continue;
+            }
+
+            const auto [nextSeed, ability] = seedHelper.generateRollWithDrink(seed, drink);
+            if (drinkMix == DrinkMix::uncertain) {
+                returnValue.rollSequence.addRoll(ability, AbilitySet::fromMask(AbilitySet{drink}.getMask() | AbilitySet::noDrinkMask));
+            } else {
+                returnValue.rollSequence.addRoll(ability, drink);
+            }
+            seed = nextSeed;
+        }
+
+        return returnValue;
+    }
+}
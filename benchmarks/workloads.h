@@ -0,0 +1,52 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_WORKLOADS_H
+#define SPLATOON_3_GEAR_HELPER_CPP_WORKLOADS_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "../data/roll_sequence.h"
+#include "../seed_helper.h"
+#include "../tests/roll_randomizer.h"
+
+
+/// Deterministic benchmark inputs, generated with `RollRandomizer`.
+namespace Workloads {
+    /// Seed of every workload's `RollRandomizer`. Changing it changes the results.
+    constexpr uint32_t randomizerSeed = 20221106;
+
+    enum class BrandKind: int64_t {
+        neutral,
+        biased,
+    };
+
+    /// First neutral brand, or first biased brand.
+    std::string_view getBrand(BrandKind kind);
+
+    enum class DrinkMix: int64_t {
+        /// No drinks.
+        none,
+        /// A drink in 30% of the rolls.
+        some,
+        /// A drink in every roll.
+        all,
+        /// `some`, but each drink may or may not have been used.
+        uncertain,
+    };
+
+    std::string_view getId(DrinkMix drinkMix);
+
+    struct Gear {
+        uint32_t initialSeed;
+        RollSequence rollSequence;
+    };
+
+    /**
+     * Rolls of a random gear: A random initial seed, rolled `length` times with `seedHelper`.
+     *
+     * `seedHelper` must have cached all drink maps (`SeedHelper::cacheAllDrinkRollToAbilityMaps`).
+     */
+    Gear makeGear(const SeedHelper& seedHelper, RollRandomizer& randomizer, size_t length, DrinkMix drinkMix);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_WORKLOADS_H
@@ -0,0 +1,103 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
+#include "benchmark/benchmark.h"
+
+#include "workloads.h"
+#include "../yaml/yaml_helper.h"
+
+
+/// Deleted on destruction.
+class TemporaryYamlFile {
+public:
+    std::string filename;
+
+    explicit TemporaryYamlFile(const size_t length) {
+        const auto path = std::filesystem::temp_directory_path() / ("splatoon_benchmark_" + std::to_string(::getpid()) + "_" + std::to_string(length) + ".yaml");
+        filename = path.string();
+    }
+
+    ~TemporaryYamlFile() {
+        std::filesystem::remove(filename);
+    }
+};
+
+/// A gear with `length` rolls (some with drinks) in `filename`.
+static void saveGear(const std::string& filename, const size_t length) {
+    SeedHelper seedHelper{Workloads::getBrand(Workloads::BrandKind::biased)};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    RollRandomizer randomizer{Workloads::randomizerSeed};
+    const auto gear = Workloads::makeGear(seedHelper, randomizer, length, Workloads::DrinkMix::some);
+
+    YamlFile yamlFile{filename, "Benchmark Gear", Workloads::getBrand(Workloads::BrandKind::biased), gear.initialSeed};
+    for (const auto [ability, drinks]: gear.rollSequence) {
+        yamlFile.addRoll(ability, drinks);
+    }
+}
+
+
+/// Args: Rolls count.
+static void yamlLoad(benchmark::State& state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const TemporaryYamlFile file{length};
+    saveGear(file.filename, length);
+
+    for (auto _: state) {
+        YamlFile yamlFile{file.filename};
+        benchmark::DoNotOptimize(yamlFile.getRollSequence().size());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * length));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(file.filename)));
+}
+BENCHMARK(yamlLoad)
+    ->ArgNames({"rolls"})
+    ->Arg(10)->Arg(100)->Arg(1000);
+
+
+/// Parsing only, without reading the file. Args: Rolls count.
+static void yamlParse(benchmark::State& state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const TemporaryYamlFile file{length};
+    saveGear(file.filename, length);
+
+    std::ifstream f(file.filename);
+    std::stringstream contentsStream{};
+    contentsStream << f.rdbuf();
+    const auto contents = contentsStream.str();
+
+    for (auto _: state) {
+        auto gear = GearYaml::parse(contents, file.filename);
+        benchmark::DoNotOptimize(gear);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * length));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * contents.size()));
+}
+BENCHMARK(yamlParse)
+    ->ArgNames({"rolls"})
+    ->Arg(10)->Arg(100)->Arg(1000);
+
+
+/// Args: Rolls count.
+static void yamlSave(benchmark::State& state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const TemporaryYamlFile file{length};
+    saveGear(file.filename, length);
+
+    YamlFile yamlFile{file.filename};
+    for (auto _: state) {
+        // Only dirty files are saved.
+        yamlFile.setInitialSeed(yamlFile.getInitialSeed().value_or(0));
+        yamlFile.saveIfDirty();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * length));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * std::filesystem::file_size(file.filename)));
+}
+BENCHMARK(yamlSave)
+    ->ArgNames({"rolls"})
+    ->Arg(10)->Arg(100)->Arg(1000);
@@ -0,0 +1,162 @@
+#include "gear_file.h"
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../data/brand.h"
+#include "../helpers/output_buffer.h"
+#include "../yaml/yaml_helper.h"
+
+
+#pragma mark - Brands
+namespace GearFile {
+    constexpr size_t brandsCount = neutralBrands.size() + biasedBrands.size();
+
+    uint8_t getBrandIndex(const std::string_view brand) {
+        for (size_t i = 0; i < brandsCount; i += 1) {
+            if (getBrand(static_cast<uint8_t>(i)) == brand) {
+                return static_cast<uint8_t>(i);
+            }
+        }
+
+        std::string exceptionMessage{"Unknown brand: "};
+        exceptionMessage += brand;
+        throw std::invalid_argument(exceptionMessage);
+    }
+
+    std::string_view getBrand(const uint8_t index) {
+        if (index < neutralBrands.size()) {
+            return neutralBrands[index];
+        } else if (index < brandsCount) {
+            return std::get<0>(biasedBrands[index - neutralBrands.size()]);
+        }
+
+        throw std::invalid_argument("Invalid brand index: " + std::to_string(index));
+    }
+}
+
+
+#pragma mark - Save and convert
+namespace GearFile {
+    void save(const std::string& filename, const std::string_view name, const std::string_view brand, const std::optional<uint32_t> initialSeed, const RollSequence& rollSequence) {
+        // Validate before creating the file.
+        const auto brandIndex = getBrandIndex(brand);
+
+        const auto fileDescriptor = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fileDescriptor < 0) {
+            throw std::runtime_error("Failed to create gear file: " + filename);
+        }
+
+        try {
+            OutputBuffer output{fileDescriptor, headerSize + rollSize * rollSequence.size() + name.size()};
+            output << magic;
+            output.appendBinary(version);
+            output.appendBinary(brandIndex);
+            output.appendBinary(static_cast<uint8_t>(initialSeed.has_value() ? 1 : 0));
+            output.appendBinary(uint8_t{0});
+            output.appendBinary(initialSeed.value_or(0));
+            output.appendBinary(static_cast<uint32_t>(rollSequence.size()));
+            output.appendBinary(static_cast<uint32_t>(name.size()));
+
+            for (const auto [ability, drinks]: rollSequence) {
+                output.appendBinary(ability.getMask());
+                output.appendBinary(drinks.getMask());
+            }
+            output << name;
+
+            output.flush();
+        } catch (...) {
+            ::close(fileDescriptor);
+            throw;
+        }
+
+        ::close(fileDescriptor);
+    }
+
+    void convertYamlToGear(const std::string& yamlFilename, const std::string& gearFilename) {
+        YamlFile yamlFile{yamlFilename};
+        save(gearFilename, yamlFile.getName(), yamlFile.getBrand(), yamlFile.getInitialSeed(), yamlFile.getRollSequence());
+    }
+
+    void convertGearToYaml(const std::string& gearFilename, const std::string& yamlFilename) {
+        const GearFileView gearFile{gearFilename};
+
+        // Saved on destruction.
+        YamlFile yamlFile{yamlFilename, gearFile.getName(), gearFile.getBrand(), gearFile.getInitialSeed()};
+        for (size_t i = 0; i < gearFile.getRollsCount(); i += 1) {
+            const auto [ability, drinks] = gearFile.getRoll(i);
+            yamlFile.addRoll(ability, drinks);
+        }
+    }
+}
+
+
+#pragma mark - GearFileView
+GearFileView::GearFileView(const std::string& filename): data{nullptr}, size{0} {
+    const auto fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Failed to open gear file: " + filename);
+    }
+
+    struct stat fileStatus{};
+    if ((::fstat(fileDescriptor, &fileStatus) != 0) || (static_cast<size_t>(fileStatus.st_size) < GearFile::headerSize)) {
+        ::close(fileDescriptor);
+        throw std::runtime_error("Invalid gear file: " + filename);
+    }
+
+    size = static_cast<size_t>(fileStatus.st_size);
+    auto* const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    // The mapping stays valid after closing.
+    ::close(fileDescriptor);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map gear file: " + filename);
+    }
+    data = static_cast<const uint8_t*>(mapping);
+
+    // Header and rolls.
+    const auto isValid = [&]() {
+        if ((std::string_view{reinterpret_cast<const char*>(data), GearFile::magic.size()} != GearFile::magic) || (data[4] != GearFile::version)) {
+            return false;
+        }
+        if (size != GearFile::headerSize + GearFile::rollSize * static_cast<uint64_t>(getRollsCount()) + read<uint32_t>(16)) {
+            return false;
+        }
+
+        try {
+            static_cast<void>(getBrand());
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+
+        // Rolls: Masks index per-ability tables later, so bits outside the abilities (e.g. `unknown`'s) must not get through.
+        for (size_t i = 0; i < getRollsCount(); i += 1) {
+            const auto offset = GearFile::headerSize + GearFile::rollSize * i;
+            if (!AbilitySet::isValidAbilitiesMask(read<uint16_t>(offset)) || !AbilitySet::isValidDrinksMask(read<uint16_t>(offset + 2))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!isValid()) {
+        ::munmap(const_cast<uint8_t*>(data), size);
+        throw std::runtime_error("Invalid gear file: " + filename);
+    }
+}
+
+GearFileView::~GearFileView() {
+    ::munmap(const_cast<uint8_t*>(data), size);
+}
+
+RollSequence GearFileView::getRollSequence() const {
+    RollSequence returnValue{};
+    for (size_t i = 0; i < getRollsCount(); i += 1) {
+        const auto [ability, drinks] = getRoll(i);
+        returnValue.addRoll(ability, drinks);
+    }
+
+    return returnValue;
+}
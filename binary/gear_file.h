@@ -0,0 +1,117 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_GEAR_FILE_H
+#define SPLATOON_3_GEAR_HELPER_CPP_GEAR_FILE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../data/roll_sequence.h"
+
+
+/**
+ * Binary gear state files (`.gear`): The contents of a gear YAML file, readable with `mmap` and no parsing.
+ *
+ * Layout (little endian):
+ *
+ * | Offset | Size | Content |
+ * | --- | --- | --- |
+ * | 0 | 4 | Magic `S3GR` |
+ * | 4 | 1 | Version (1) |
+ * | 5 | 1 | Brand index (see `getBrandIndex`) |
+ * | 6 | 1 | Flags: Bit 0: Has initial seed |
+ * | 7 | 1 | Reserved (0) |
+ * | 8 | 4 | Initial seed (0 if absent) |
+ * | 12 | 4 | Rolls count `n` |
+ * | 16 | 4 | Name length `m` in bytes |
+ * | 20 | 4n | Rolls: uint16 ability mask, uint16 drink mask (`AbilitySet::getMask`) |
+ * | 20 + 4n | m | Name (UTF-8, no terminator) |
+ *
+ * Rolls are stored as `AbilitySet` masks, so uncertain abilities/drinks convert losslessly to and from YAML.
+ */
+namespace GearFile {
+    constexpr std::string_view magic = "S3GR";
+    constexpr uint8_t version = 1;
+    constexpr std::string_view extension = ".gear";
+
+    constexpr size_t headerSize = 20;
+    constexpr size_t rollSize = 4;
+
+    /**
+     * Index: `neutralBrands`, then `biasedBrands`.
+     * Stored in files, so existing brands must keep their order.
+     *
+     * @throws std::invalid_argument for unknown brands.
+     */
+    uint8_t getBrandIndex(std::string_view brand);
+
+    /// @throws std::invalid_argument for invalid indices.
+    std::string_view getBrand(uint8_t index);
+
+    /// @throws std::runtime_error if the file can't be written.
+    void save(const std::string& filename, std::string_view name, std::string_view brand, std::optional<uint32_t> initialSeed, const RollSequence& rollSequence);
+
+    void convertYamlToGear(const std::string& yamlFilename, const std::string& gearFilename);
+    void convertGearToYaml(const std::string& gearFilename, const std::string& yamlFilename);
+}
+
+
+/**
+ * Read-only memory mapped `.gear` file.
+ *
+ * The header and roll masks are validated on open, and rolls are read from the mapping on access.
+ */
+class GearFileView {
+private:
+    const uint8_t* data;
+    size_t size;
+
+    /// Read a little endian integer at `offset`.
+    template <typename T>
+    [[nodiscard]] T read(const size_t offset) const {
+        T returnValue = 0;
+        for (size_t i = 0; i < sizeof(T); i += 1) {
+            returnValue |= static_cast<T>(static_cast<T>(data[offset + i]) << (8 * i));
+        }
+        return returnValue;
+    }
+
+public:
+    /// @throws std::runtime_error if the file can't be mapped or isn't a valid `.gear` file.
+    explicit GearFileView(const std::string& filename);
+    ~GearFileView();
+
+    GearFileView(const GearFileView&) = delete;
+    GearFileView& operator=(const GearFileView&) = delete;
+
+public:
+    [[nodiscard]] std::string_view getName() const {
+        return {reinterpret_cast<const char*>(data) + GearFile::headerSize + GearFile::rollSize * getRollsCount(), read<uint32_t>(16)};
+    }
+
+    [[nodiscard]] std::string_view getBrand() const {
+        return GearFile::getBrand(data[5]);
+    }
+
+    [[nodiscard]] std::optional<uint32_t> getInitialSeed() const {
+        if ((data[6] & 1) == 0) {
+            return std::nullopt;
+        }
+        return read<uint32_t>(8);
+    }
+
+    [[nodiscard]] size_t getRollsCount() const {
+        return read<uint32_t>(12);
+    }
+
+    /// (rolled ability, drink)
+    [[nodiscard]] std::pair<AbilitySet, AbilitySet> getRoll(const size_t index) const {
+        const auto offset = GearFile::headerSize + GearFile::rollSize * index;
+        return {AbilitySet::fromMask(read<uint16_t>(offset)), AbilitySet::fromMask(read<uint16_t>(offset + 2))};
+    }
+
+    [[nodiscard]] RollSequence getRollSequence() const;
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_GEAR_FILE_H
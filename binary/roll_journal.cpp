@@ -0,0 +1,300 @@
+#include "roll_journal.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gear_file.h"
+#include "../yaml/yaml_helper.h"
+
+
+#pragma mark - Encoding
+/// Little endian.
+template <typename T>
+static void writeInteger(uint8_t* bytes, const T value) {
+    for (size_t i = 0; i < sizeof(T); i += 1) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+template <typename T>
+static T readInteger(const uint8_t* bytes) {
+    T returnValue = 0;
+    for (size_t i = 0; i < sizeof(T); i += 1) {
+        returnValue |= static_cast<T>(static_cast<T>(bytes[i]) << (8 * i));
+    }
+    return returnValue;
+}
+
+/// FNV-1a.
+static uint32_t getChecksum(const uint8_t* bytes, const size_t size) {
+    uint32_t returnValue = 2166136261;
+    for (size_t i = 0; i < size; i += 1) {
+        returnValue ^= bytes[i];
+        returnValue *= 16777619;
+    }
+    return returnValue;
+}
+
+/// Write all bytes, then `fsync`.
+static void writeAndSync(const int fileDescriptor, const uint8_t* bytes, const size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        const auto result = ::write(fileDescriptor, bytes + written, size - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write journal.");
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    if (::fsync(fileDescriptor) != 0) {
+        throw std::runtime_error("Failed to sync journal.");
+    }
+}
+
+
+#pragma mark - Append
+void RollJournal::encodeRecord(uint8_t* record, const char type, const uint32_t a, const uint32_t b) {
+    std::fill(record, record + recordSize, 0);
+    record[0] = static_cast<uint8_t>(type);
+    writeInteger(record + 4, a);
+    writeInteger(record + 8, b);
+    writeInteger(record + 12, getChecksum(record, 12));
+}
+
+void RollJournal::appendRecords(const uint8_t* records, const size_t count) {
+    if (openMode == OpenMode::readOnly) {
+        throw std::runtime_error("Journal is open read-only: " + filename);
+    }
+
+    // Drop a torn record from a previous crash.
+    const auto fileSize = ::lseek(fileDescriptor, 0, SEEK_END);
+    if ((fileSize < 0) || ((static_cast<size_t>(fileSize) != validSize) && (::ftruncate(fileDescriptor, static_cast<off_t>(validSize)) != 0))) {
+        throw std::runtime_error("Failed to truncate journal: " + filename);
+    }
+    if (::lseek(fileDescriptor, static_cast<off_t>(validSize), SEEK_SET) < 0) {
+        throw std::runtime_error("Failed to seek journal: " + filename);
+    }
+
+    writeAndSync(fileDescriptor, records, recordSize * count);
+    validSize += recordSize * count;
+}
+
+void RollJournal::append(const char type, const uint32_t a, const uint32_t b) {
+    std::array<uint8_t, recordSize> record{};
+    encodeRecord(record.data(), type, a, b);
+    appendRecords(record.data(), 1);
+}
+
+void RollJournal::setInitialSeed(const uint32_t seed) {
+    append('S', 0, seed);
+    initialSeed = seed;
+    lastCheckpoint.reset();
+}
+
+void RollJournal::addRoll(const AbilitySet ability) {
+    addRoll(ability, Ability::noDrink);
+}
+
+void RollJournal::addRoll(const AbilitySet ability, const AbilitySet drinks) {
+    append('R', ability.getMask(), drinks.getMask());
+    rollSequence.addRoll(ability, drinks);
+}
+
+void RollJournal::addRolls(const RollSequence& rolls) {
+    std::vector<uint8_t> records(recordSize * rolls.size(), 0);
+    size_t i = 0;
+    for (const auto [ability, drinks]: rolls) {
+        encodeRecord(records.data() + recordSize * i, 'R', ability.getMask(), drinks.getMask());
+        i += 1;
+    }
+    appendRecords(records.data(), rolls.size());
+
+    for (const auto [ability, drinks]: rolls) {
+        rollSequence.addRoll(ability, drinks);
+    }
+}
+
+void RollJournal::addCheckpoint(const size_t rollsCount, const uint32_t seed) {
+    if (rollsCount > rollSequence.size()) {
+        throw std::invalid_argument("Checkpoint after the last roll.");
+    }
+
+    append('C', static_cast<uint32_t>(rollsCount), seed);
+    lastCheckpoint = Checkpoint{rollsCount, seed};
+}
+
+std::pair<bool, uint32_t> RollJournal::advanceToEnd(SeedHelper& seedHelper, const size_t checkpointInterval) {
+    if (!initialSeed.has_value()) {
+        throw std::runtime_error("No initial seed in journal.");
+    }
+
+    const auto checkpoint = lastCheckpoint.value_or(Checkpoint{0, initialSeed.value()});
+    RollSequence remainingRolls{};
+    for (auto it = rollSequence.begin() + static_cast<ptrdiff_t>(checkpoint.rollsCount); it != rollSequence.end(); it++) {
+        remainingRolls.addRoll(it->first, it->second);
+    }
+
+    const auto returnValue = seedHelper.advanceSeedToEndOfRollSequence(checkpoint.seed, remainingRolls);
+    if (returnValue.first && (openMode == OpenMode::readWrite) && (remainingRolls.size() >= checkpointInterval) && (remainingRolls.size() > 0)) {
+        addCheckpoint(rollSequence.size(), returnValue.second);
+    }
+
+    return returnValue;
+}
+
+
+#pragma mark - Constructors
+RollJournal::RollJournal(const std::string_view filename, const OpenMode openMode): filename{filename}, fileDescriptor{-1}, openMode{openMode}, validSize{0}, name{}, brand{}, initialSeed{}, rollSequence{}, lastCheckpoint{} {
+    fileDescriptor = ::open(this->filename.c_str(), (openMode == OpenMode::readOnly) ? O_RDONLY : O_RDWR);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error(((errno == ENOENT) ? "Journal file doesn't exist: " : "Failed to open journal: ") + this->filename);
+    }
+
+    try {
+        // Journals are small: Read the whole file.
+        struct stat fileStatus{};
+        if (::fstat(fileDescriptor, &fileStatus) != 0) {
+            throw std::runtime_error("Failed to read journal: " + this->filename);
+        }
+        std::vector<uint8_t> contents(static_cast<size_t>(fileStatus.st_size), 0);
+        size_t readSize = 0;
+        while (readSize < contents.size()) {
+            const auto result = ::pread(fileDescriptor, contents.data() + readSize, contents.size() - readSize, static_cast<off_t>(readSize));
+            if ((result < 0) && (errno == EINTR)) {
+                continue;
+            } else if (result <= 0) {
+                throw std::runtime_error("Failed to read journal: " + this->filename);
+            }
+            readSize += static_cast<size_t>(result);
+        }
+
+        // Header.
+        constexpr size_t headerSize = 12;
+        if ((contents.size() < headerSize) || (std::string_view{reinterpret_cast<const char*>(contents.data()), magic.size()} != magic) || (contents[4] != version)) {
+            throw std::runtime_error("Invalid journal header: " + this->filename);
+        }
+        try {
+            brand = GearFile::getBrand(contents[5]);
+        } catch (const std::invalid_argument&) {
+            throw std::runtime_error("Invalid journal brand: " + this->filename);
+        }
+        const auto nameSize = readInteger<uint32_t>(contents.data() + 8);
+        if (contents.size() < headerSize + nameSize) {
+            throw std::runtime_error("Invalid journal header: " + this->filename);
+        }
+        name.assign(reinterpret_cast<const char*>(contents.data()) + headerSize, nameSize);
+        validSize = headerSize + nameSize;
+
+        // Records.
+        while (validSize + recordSize <= contents.size()) {
+            const auto* const record = contents.data() + validSize;
+            if (readInteger<uint32_t>(record + 12) != getChecksum(record, 12)) {
+                if (validSize + recordSize == contents.size()) {
+                    // Torn last record.
+                    break;
+                }
+                throw std::runtime_error("Corrupted journal record: " + this->filename);
+            }
+
+            const auto a = readInteger<uint32_t>(record + 4);
+            const auto b = readInteger<uint32_t>(record + 8);
+            switch (record[0]) {
+                case 'R':
+                    if (!AbilitySet::isValidAbilitiesMask(a) || !AbilitySet::isValidDrinksMask(b)) {
+                        throw std::runtime_error("Corrupted journal record: " + this->filename);
+                    }
+                    rollSequence.addRoll(AbilitySet::fromMask(static_cast<AbilitySet::MaskType>(a)), AbilitySet::fromMask(static_cast<AbilitySet::MaskType>(b)));
+                    break;
+                case 'S':
+                    initialSeed = b;
+                    lastCheckpoint.reset();
+                    break;
+                case 'C':
+                    if (a > rollSequence.size()) {
+                        throw std::runtime_error("Invalid journal checkpoint: " + this->filename);
+                    }
+                    lastCheckpoint = Checkpoint{a, b};
+                    break;
+                default:
+                    throw std::runtime_error("Invalid journal record type: " + this->filename);
+            }
+
+            validSize += recordSize;
+        }
+    } catch (...) {
+        ::close(fileDescriptor);
+        throw;
+    }
+}
+
+RollJournal::~RollJournal() {
+    ::close(fileDescriptor);
+}
+
+void RollJournal::create(const std::string& filename, const std::string_view name, const std::string_view brand, const std::optional<uint32_t> initialSeed) {
+    const auto brandIndex = GearFile::getBrandIndex(brand);
+
+    const auto fileDescriptor = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Failed to create journal: " + filename);
+    }
+
+    std::vector<uint8_t> header(12 + name.size(), 0);
+    std::copy(magic.begin(), magic.end(), header.begin());
+    header[4] = version;
+    header[5] = brandIndex;
+    writeInteger(header.data() + 8, static_cast<uint32_t>(name.size()));
+    std::copy(name.begin(), name.end(), header.begin() + 12);
+
+    try {
+        writeAndSync(fileDescriptor, header.data(), header.size());
+    } catch (...) {
+        ::close(fileDescriptor);
+        throw;
+    }
+    ::close(fileDescriptor);
+
+    // Make the new directory entry durable too.
+    auto directory = std::filesystem::path{filename}.parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    const auto directoryDescriptor = ::open(directory.c_str(), O_RDONLY);
+    if (directoryDescriptor >= 0) {
+        ::fsync(directoryDescriptor);
+        ::close(directoryDescriptor);
+    }
+
+    if (initialSeed.has_value()) {
+        RollJournal journal{filename};
+        journal.setInitialSeed(initialSeed.value());
+    }
+}
+
+void RollJournal::convertYamlToJournal(const std::string& yamlFilename, const std::string& journalFilename) {
+    YamlFile yamlFile{yamlFilename};
+    create(journalFilename, yamlFile.getName(), yamlFile.getBrand(), yamlFile.getInitialSeed());
+
+    RollJournal journal{journalFilename};
+    journal.addRolls(yamlFile.getRollSequence());
+}
+
+void RollJournal::convertJournalToYaml(const std::string& journalFilename, const std::string& yamlFilename) {
+    const RollJournal journal{journalFilename, OpenMode::readOnly};
+
+    // Saved on destruction.
+    YamlFile yamlFile{yamlFilename, journal.getName(), journal.getBrand(), journal.getInitialSeed()};
+    for (const auto [ability, drinks]: journal.getRollSequence()) {
+        yamlFile.addRoll(ability, drinks);
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_ROLL_JOURNAL_H
+#define SPLATOON_3_GEAR_HELPER_CPP_ROLL_JOURNAL_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../data/roll_sequence.h"
+#include "../seed_helper.h"
+
+
+/**
+ * Append-only roll log (`.journal`), an alternative to rewriting a whole YAML file per roll.
+ *
+ * Layout (little endian):
+ *
+ * - Header: Magic `S3GJ`, uint8 version (1), uint8 brand index (`GearFile::getBrandIndex`), uint16 reserved,
+ *   uint32 name length `m`, then the name (`m` bytes)
+ * - 16 byte records: uint8 type, uint8 reserved, uint16 reserved, uint32 `a`, uint32 `b`, uint32 FNV-1a checksum of the first 12 bytes
+ *   - `R` roll: `a`: Ability mask, `b`: Drink mask
+ *   - `S` initial seed: `b`: Seed. Invalidates earlier checkpoints
+ *   - `C` checkpoint: `a`: Rolls count, `b`: Seed after that many rolls
+ *
+ * Every append is a single `write` followed by `fsync`.
+ * A torn record at the end of the file (crash during an append) is ignored on load and truncated on the next append.
+ */
+class RollJournal {
+public:
+    static constexpr std::string_view magic = "S3GJ";
+    static constexpr uint8_t version = 1;
+    static constexpr std::string_view extension = ".journal";
+
+    static constexpr size_t recordSize = 16;
+
+    /// `advanceToEnd` records a checkpoint after replaying at least this many rolls.
+    static constexpr size_t defaultCheckpointInterval = 32;
+
+    struct Checkpoint {
+        size_t rollsCount;
+        /// Seed after `rollsCount` rolls.
+        uint32_t seed;
+    };
+
+    enum class OpenMode {
+        readWrite,
+        /// For callers that only read (e.g. `convert`): Works on read-only files, and appends throw.
+        readOnly,
+    };
+
+#pragma mark File information
+private:
+    std::string filename;
+    int fileDescriptor;
+    OpenMode openMode;
+
+    /// Bytes of valid header and records. Anything after it is a torn record.
+    size_t validSize;
+
+#pragma mark File contents
+private:
+    std::string name;
+    std::string brand;
+    std::optional<uint32_t> initialSeed;
+    RollSequence rollSequence;
+
+    /// Latest checkpoint for the current initial seed.
+    std::optional<Checkpoint> lastCheckpoint;
+
+public:
+    [[nodiscard]] std::string_view getName() const {
+        return name;
+    }
+    [[nodiscard]] std::string_view getBrand() const {
+        return brand;
+    }
+    [[nodiscard]] std::optional<uint32_t> getInitialSeed() const {
+        return initialSeed;
+    }
+    [[nodiscard]] const RollSequence& getRollSequence() const {
+        return rollSequence;
+    }
+    [[nodiscard]] std::optional<Checkpoint> getLastCheckpoint() const {
+        return lastCheckpoint;
+    }
+
+#pragma mark Append
+private:
+    static void encodeRecord(uint8_t* record, char type, uint32_t a, uint32_t b);
+
+    /**
+     * Append `count` encoded records with 1 write and sync.
+     *
+     * @throws std::runtime_error if the journal is read-only, or the write fails.
+     */
+    void appendRecords(const uint8_t* records, size_t count);
+
+    void append(char type, uint32_t a, uint32_t b);
+
+public:
+    void setInitialSeed(uint32_t seed);
+    void addRoll(AbilitySet ability);
+    void addRoll(AbilitySet ability, AbilitySet drinks);
+    /// Multiple rolls with a single sync.
+    void addRolls(const RollSequence& rolls);
+    void addCheckpoint(size_t rollsCount, uint32_t seed);
+
+    /**
+     * `SeedHelper::advanceSeedToEndOfRollSequence`, starting from the last checkpoint.
+     *
+     * Records a new checkpoint if at least `checkpointInterval` rolls were replayed and they're valid (unless the journal is read-only).
+     *
+     * @return (valid, final seed)
+     * @throws std::runtime_error if there's no initial seed.
+     */
+    std::pair<bool, uint32_t> advanceToEnd(SeedHelper& seedHelper, size_t checkpointInterval = defaultCheckpointInterval);
+
+#pragma mark Constructors
+public:
+    RollJournal() = delete;
+    RollJournal(const RollJournal&) = delete;
+    RollJournal& operator=(const RollJournal&) = delete;
+
+    /**
+     * Open an existing journal, for appending unless `openMode` is `OpenMode::readOnly`.
+     *
+     * @throws std::runtime_error if the file doesn't exist, can't be opened in `openMode`, or is corrupted.
+     */
+    explicit RollJournal(std::string_view filename, OpenMode openMode = OpenMode::readWrite);
+
+    ~RollJournal();
+
+    /**
+     * Create a new journal with a header and (optional) initial seed record.
+     *
+     * @throws std::runtime_error if the file already exists.
+     */
+    static void create(const std::string& filename, std::string_view name, std::string_view brand, std::optional<uint32_t> initialSeed);
+
+    /// Lossless conversion to and from YAML files. Checkpoints are dropped.
+    static void convertYamlToJournal(const std::string& yamlFilename, const std::string& journalFilename);
+    static void convertJournalToYaml(const std::string& journalFilename, const std::string& yamlFilename);
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_ROLL_JOURNAL_H
@@ -0,0 +1,467 @@
+#include "seed_index.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../data/brand.h"
+#include "../helpers/parallel.h"
+#include "../seed_helper.h"
+
+
+#pragma mark - Tables
+namespace SeedIndex {
+    uint8_t getTableIndex(const std::string_view brand) {
+        if (std::find(neutralBrands.begin(), neutralBrands.end(), brand) != neutralBrands.end()) {
+            return 0;
+        }
+        for (size_t i = 0; i < biasedBrands.size(); i += 1) {
+            if (std::get<0>(biasedBrands[i]) == brand) {
+                return static_cast<uint8_t>(1 + i);
+            }
+        }
+
+        std::string exceptionMessage{"Unknown brand: "};
+        exceptionMessage += brand;
+        throw std::invalid_argument(exceptionMessage);
+    }
+
+    std::string getFilename(const std::string& directory, const std::string_view brand) {
+        const auto tableIndex = getTableIndex(brand);
+
+        std::string table{"neutral"};
+        if (tableIndex != 0) {
+            table = std::get<0>(biasedBrands[tableIndex - 1]);
+            for (auto& character: table) {
+                character = (character == ' ') ? '_' : static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+            }
+        }
+
+        return (std::filesystem::path{directory} / (table + std::string{extension})).string();
+    }
+
+    uint32_t getFingerprint(const SeedHelper& seedHelper, uint32_t seed, const size_t rollsCount) {
+        uint32_t returnValue = 0;
+        for (size_t i = 0; i < rollsCount; i += 1) {
+            Ability ability;
+            std::tie(seed, ability) = seedHelper.generateRoll(seed);
+            returnValue = (returnValue << 4) | static_cast<uint32_t>(AbilityHelper::getIndex(ability));
+        }
+        return returnValue;
+    }
+}
+
+
+#pragma mark - Build
+namespace SeedIndex {
+    namespace {
+        /// Buckets: The first 2 rolls (8 bits of the fingerprint).
+        constexpr size_t bucketsCount = 256;
+        /// Seeds each worker buffers per bucket before appending to the bucket's file.
+        constexpr size_t bucketBufferCapacity = 1 << 12;
+
+        /// @throws std::runtime_error unless all bytes are written.
+        void writeAll(const int fileDescriptor, const void* const bytes, const size_t count, const off_t offset, const std::string& filename) {
+            size_t written = 0;
+            while (written < count) {
+                const auto result = ::pwrite(fileDescriptor, static_cast<const uint8_t*>(bytes) + written, count - written, offset + static_cast<off_t>(written));
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error("Failed to write seed index file: " + filename);
+                }
+                written += static_cast<size_t>(result);
+            }
+        }
+
+        /// Append with `O_APPEND` (offset ignored).
+        void appendAll(const int fileDescriptor, const void* const bytes, const size_t count, const std::string& filename) {
+            size_t written = 0;
+            while (written < count) {
+                const auto result = ::write(fileDescriptor, static_cast<const uint8_t*>(bytes) + written, count - written);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error("Failed to write seed index bucket: " + filename);
+                }
+                written += static_cast<size_t>(result);
+            }
+        }
+
+        std::vector<uint32_t> readBucket(const std::string& filename) {
+            const auto fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+            if (fileDescriptor < 0) {
+                throw std::runtime_error("Failed to open seed index bucket: " + filename);
+            }
+
+            struct stat fileStatus{};
+            if (::fstat(fileDescriptor, &fileStatus) != 0) {
+                ::close(fileDescriptor);
+                throw std::runtime_error("Failed to read seed index bucket: " + filename);
+            }
+
+            std::vector<uint32_t> returnValue(static_cast<size_t>(fileStatus.st_size) / sizeof(uint32_t));
+            auto* const bytes = reinterpret_cast<uint8_t*>(returnValue.data());
+            const auto count = returnValue.size() * sizeof(uint32_t);
+            size_t readCount = 0;
+            while (readCount < count) {
+                const auto result = ::read(fileDescriptor, bytes + readCount, count - readCount);
+                if ((result < 0) && (errno == EINTR)) {
+                    continue;
+                }
+                if (result <= 0) {
+                    ::close(fileDescriptor);
+                    throw std::runtime_error("Failed to read seed index bucket: " + filename);
+                }
+                readCount += static_cast<size_t>(result);
+            }
+
+            ::close(fileDescriptor);
+            return returnValue;
+        }
+
+        /// Temporary bucket files, removed on destruction.
+        class Buckets {
+        public:
+            std::filesystem::path directory;
+            std::array<int, bucketsCount> fileDescriptors;
+            std::array<std::mutex, bucketsCount> mutexes;
+
+            explicit Buckets(std::filesystem::path directory): directory{std::move(directory)}, fileDescriptors{}, mutexes{} {
+                fileDescriptors.fill(-1);
+                std::filesystem::create_directories(this->directory);
+                for (size_t i = 0; i < bucketsCount; i += 1) {
+                    fileDescriptors[i] = ::open(getFilename(i).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+                    if (fileDescriptors[i] < 0) {
+                        throw std::runtime_error("Failed to create seed index bucket: " + getFilename(i));
+                    }
+                }
+            }
+            Buckets(const Buckets&) = delete;
+            Buckets& operator=(const Buckets&) = delete;
+
+            ~Buckets() {
+                closeAll();
+                std::error_code error{};
+                std::filesystem::remove_all(directory, error);
+            }
+
+            [[nodiscard]] std::string getFilename(const size_t bucket) const {
+                return (directory / ("bucket_" + std::to_string(bucket))).string();
+            }
+
+            void append(const size_t bucket, const std::vector<uint32_t>& seeds) {
+                const std::lock_guard lock{mutexes[bucket]};
+                appendAll(fileDescriptors[bucket], seeds.data(), seeds.size() * sizeof(uint32_t), getFilename(bucket));
+            }
+
+            void closeAll() {
+                for (auto& fileDescriptor: fileDescriptors) {
+                    if (fileDescriptor >= 0) {
+                        ::close(fileDescriptor);
+                        fileDescriptor = -1;
+                    }
+                }
+            }
+        };
+
+        /**
+         * Seeds that step 3 may hold in memory at once (12 bytes each while sorting), regardless of the workers count: 3 GiB.
+         * A larger bucket is still sorted, alone.
+         */
+        constexpr uint64_t maxSortingSeedsCount = uint64_t{1} << 28;
+
+        /// Blocks workers until their bucket fits in `maxSortingSeedsCount` with the buckets being sorted.
+        class SortingBudget {
+        private:
+            std::mutex mutex;
+            std::condition_variable released;
+            uint64_t seedsCount;
+
+        public:
+            /// Holds `count` seeds of the budget until destruction.
+            class Lease {
+            private:
+                SortingBudget& budget;
+                uint64_t count;
+
+            public:
+                Lease(SortingBudget& budget, const uint64_t count): budget{budget}, count{count} {
+                    std::unique_lock lock{budget.mutex};
+                    budget.released.wait(lock, [&] {
+                        return (budget.seedsCount == 0) || (budget.seedsCount + count <= maxSortingSeedsCount);
+                    });
+                    budget.seedsCount += count;
+                }
+                Lease(const Lease&) = delete;
+                Lease& operator=(const Lease&) = delete;
+
+                ~Lease() {
+                    {
+                        const std::lock_guard lock{budget.mutex};
+                        budget.seedsCount -= count;
+                    }
+                    budget.released.notify_all();
+                }
+            };
+
+            SortingBudget(): mutex{}, released{}, seedsCount{0} {}
+        };
+
+        /// Closes on destruction.
+        class OutputFile {
+        public:
+            int fileDescriptor;
+
+            explicit OutputFile(const std::string& filename): fileDescriptor{::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)} {
+                if (fileDescriptor < 0) {
+                    throw std::runtime_error("Failed to create seed index file: " + filename);
+                }
+            }
+            OutputFile(const OutputFile&) = delete;
+            OutputFile& operator=(const OutputFile&) = delete;
+
+            ~OutputFile() {
+                ::close(fileDescriptor);
+            }
+        };
+    }
+
+    void build(const std::string& filename, const std::string_view brand, const size_t rollsCount, const uint64_t seedsCount, const size_t workersCount) {
+        if ((rollsCount < minRollsCount) || (rollsCount > maxRollsCount)) {
+            throw std::invalid_argument("Seed index rolls count must be " + std::to_string(minRollsCount) + " to " + std::to_string(maxRollsCount) + ".");
+        }
+        if ((seedsCount == 0) || (seedsCount > allSeedsCount)) {
+            throw std::invalid_argument("Seed index seeds count must be 1 to 2^32.");
+        }
+
+        const auto tableIndex = getTableIndex(brand);
+        const SeedHelper seedHelper{brand};
+        const auto bucketShift = 4 * (rollsCount - minRollsCount);
+
+        const auto temporaryFilename = filename + ".tmp";
+        {
+            Buckets buckets{filename + ".buckets"};
+
+            // 1. Partition seeds into buckets. Each worker buffers its own seeds per bucket.
+            const auto workerBucketCounts = Parallel::mapRanges(seedsCount, workersCount, [&](const size_t start, const size_t stop) {
+                std::array<uint64_t, bucketsCount> bucketCounts{};
+                std::vector<std::vector<uint32_t>> buffers(bucketsCount);
+                for (auto& buffer: buffers) {
+                    buffer.reserve(bucketBufferCapacity);
+                }
+
+                for (auto seed = start; seed < stop; seed += 1) {
+                    const auto bucket = getFingerprint(seedHelper, static_cast<uint32_t>(seed), rollsCount) >> bucketShift;
+                    auto& buffer = buffers[bucket];
+                    buffer.push_back(static_cast<uint32_t>(seed));
+                    if (buffer.size() == bucketBufferCapacity) {
+                        buckets.append(bucket, buffer);
+                        buffer.clear();
+                    }
+                    bucketCounts[bucket] += 1;
+                }
+                for (size_t i = 0; i < bucketsCount; i += 1) {
+                    if (!buffers[i].empty()) {
+                        buckets.append(i, buffers[i]);
+                    }
+                }
+
+                return bucketCounts;
+            });
+            buckets.closeAll();
+
+            // Each bucket's first entry.
+            std::array<uint64_t, bucketsCount + 1> bucketStarts{};
+            for (size_t i = 0; i < bucketsCount; i += 1) {
+                bucketStarts[i + 1] = bucketStarts[i];
+                for (const auto& bucketCounts: workerBucketCounts) {
+                    bucketStarts[i + 1] += bucketCounts[i];
+                }
+            }
+
+            // 2. Header, and the file's final size.
+            const OutputFile output{temporaryFilename};
+            std::array<uint8_t, headerSize> header{};
+            std::copy(magic.begin(), magic.end(), header.begin());
+            header[4] = version;
+            header[5] = static_cast<uint8_t>(rollsCount);
+            header[6] = tableIndex;
+            for (size_t i = 0; i < 8; i += 1) {
+                header[8 + i] = static_cast<uint8_t>(seedsCount >> (8 * i));
+            }
+            writeAll(output.fileDescriptor, header.data(), header.size(), 0, temporaryFilename);
+            if (::ftruncate(output.fileDescriptor, static_cast<off_t>(headerSize + seedSize * seedsCount)) != 0) {
+                throw std::runtime_error("Failed to allocate seed index file: " + temporaryFilename);
+            }
+
+            // 3. Sort each bucket, and write it to its final position. Buckets are taken in turn, since their sizes vary.
+            SortingBudget sortingBudget{};
+            Parallel::forEachChunk(bucketsCount, workersCount, bucketsCount, [&](const size_t start, const size_t stop) {
+                for (auto bucket = start; bucket < stop; bucket += 1) {
+                    const SortingBudget::Lease lease{sortingBudget, bucketStarts[bucket + 1] - bucketStarts[bucket]};
+
+                    std::vector<uint64_t> keys{};
+                    {
+                        const auto seeds = readBucket(buckets.getFilename(bucket));
+                        std::filesystem::remove(buckets.getFilename(bucket));
+                        keys.reserve(seeds.size());
+                        for (const auto seed: seeds) {
+                            keys.push_back((static_cast<uint64_t>(getFingerprint(seedHelper, seed, rollsCount)) << 32) | seed);
+                        }
+                    }
+                    std::sort(keys.begin(), keys.end());
+
+                    std::vector<uint8_t> bytes(keys.size() * seedSize);
+                    for (size_t i = 0; i < keys.size(); i += 1) {
+                        for (size_t j = 0; j < seedSize; j += 1) {
+                            bytes[seedSize * i + j] = static_cast<uint8_t>(keys[i] >> (8 * j));
+                        }
+                    }
+                    writeAll(output.fileDescriptor, bytes.data(), bytes.size(), static_cast<off_t>(headerSize + seedSize * bucketStarts[bucket]), temporaryFilename);
+                }
+            });
+        }
+
+        std::error_code error{};
+        std::filesystem::rename(temporaryFilename, filename, error);
+        if (error) {
+            std::filesystem::remove(temporaryFilename, error);
+            throw std::runtime_error("Failed to write seed index file: " + filename);
+        }
+    }
+}
+
+
+#pragma mark - SeedIndexView
+SeedIndexView::SeedIndexView(const std::string& filename): data{nullptr}, size{0} {
+    const auto fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Failed to open seed index file: " + filename);
+    }
+
+    struct stat fileStatus{};
+    if ((::fstat(fileDescriptor, &fileStatus) != 0) || (static_cast<size_t>(fileStatus.st_size) < SeedIndex::headerSize)) {
+        ::close(fileDescriptor);
+        throw std::runtime_error("Invalid seed index file: " + filename);
+    }
+
+    size = static_cast<size_t>(fileStatus.st_size);
+    auto* const mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    // The mapping stays valid after closing.
+    ::close(fileDescriptor);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map seed index file: " + filename);
+    }
+    data = static_cast<const uint8_t*>(mapping);
+
+    // Header.
+    const auto isValid = (std::string_view{reinterpret_cast<const char*>(data), SeedIndex::magic.size()} == SeedIndex::magic) && (data[4] == SeedIndex::version)
+                         && (getRollsCount() >= SeedIndex::minRollsCount) && (getRollsCount() <= SeedIndex::maxRollsCount) && (getTableIndex() <= biasedBrands.size())
+                         && (getSeedsCount() <= SeedIndex::allSeedsCount) && (size == SeedIndex::headerSize + SeedIndex::seedSize * getSeedsCount());
+    if (!isValid) {
+        ::munmap(const_cast<uint8_t*>(data), size);
+        throw std::runtime_error("Invalid seed index file: " + filename);
+    }
+
+    // Random access.
+    ::madvise(const_cast<uint8_t*>(data), size, MADV_RANDOM);
+}
+
+SeedIndexView::~SeedIndexView() {
+    ::munmap(const_cast<uint8_t*>(data), size);
+}
+
+bool SeedIndexView::canFindSeed(const RollSequence& rollSequence) const {
+    if (rollSequence.size() < getRollsCount()) {
+        return false;
+    }
+
+    size_t i = 0;
+    for (const auto [abilities, drinks]: rollSequence) {
+        if (drinks != AbilitySet{Ability::noDrink}) {
+            return false;
+        }
+        if ((i < getRollsCount()) && (abilities.size() != 1)) {
+            return false;
+        }
+        i += 1;
+    }
+    return true;
+}
+
+std::vector<uint32_t> SeedIndexView::findSeed(const SeedHelper& seedHelper, const RollSequence& rollSequence, SearchStats* const stats) const {
+    if (!canFindSeed(rollSequence)) {
+        throw std::invalid_argument("The seed index needs " + std::to_string(getRollsCount()) + " known rolls, and no drinks.");
+    }
+    if (SeedIndex::getTableIndex(seedHelper.brandName) != getTableIndex()) {
+        throw std::invalid_argument("The seed index is for another brand: " + seedHelper.brandName);
+    }
+
+    const auto rollsCount = getRollsCount();
+    uint32_t fingerprint = 0;
+    for (auto it = rollSequence.begin(); it != rollSequence.begin() + static_cast<std::ptrdiff_t>(rollsCount); it += 1) {
+        fingerprint = (fingerprint << 4) | static_cast<uint32_t>(AbilityHelper::getIndex(it->first.getSingle()));
+    }
+
+    // Lower bound of the fingerprint.
+    uint64_t low = 0;
+    uint64_t high = getSeedsCount();
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (SeedIndex::getFingerprint(seedHelper, getSeed(middle), rollsCount) < fingerprint) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // Seeds with the same fingerprint are sorted, like `findSeed`'s results.
+    const Stopwatch stopwatch{CLOCK_THREAD_CPUTIME_ID};
+    SearchStats counters{};
+    std::vector<uint32_t> returnValue{};
+    for (auto i = low; i < getSeedsCount(); i += 1) {
+        const auto seed = getSeed(i);
+        if (SeedIndex::getFingerprint(seedHelper, seed, rollsCount) != fingerprint) {
+            break;
+        }
+        counters.seedsEvaluated += 1;
+
+        // Verify all rolls (no drinks), stopping at the 1st that doesn't match.
+        auto currentSeed = seed;
+        size_t rollIndex = 0;
+        for (const auto [abilities, drinks]: rollSequence) {
+            Ability ability;
+            std::tie(currentSeed, ability) = seedHelper.generateRoll(currentSeed);
+            if (!abilities.contains(ability)) {
+                break;
+            }
+            rollIndex += 1;
+        }
+        if (rollIndex == rollSequence.size()) {
+            counters.seedsMatched += 1;
+            returnValue.push_back(seed);
+        } else {
+            counters.countRejection(rollIndex);
+        }
+    }
+
+    if (stats != nullptr) {
+        // 1 worker: The lookup.
+        counters.workerTimings.push_back(stopwatch.getElapsed());
+        *stats += counters;
+    }
+    return returnValue;
+}
@@ -0,0 +1,142 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_SEED_INDEX_H
+#define SPLATOON_3_GEAR_HELPER_CPP_SEED_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../data/roll_sequence.h"
+#include "../helpers/stats.h"
+
+
+class SeedHelper;
+
+
+/**
+ * Seed index files (`.s3gi`): Every initial seed, sorted by the fingerprint of its first `k` no-drink rolls.
+ *
+ * `find --index` answers no-drink roll sequences of at least `k` known rolls with a binary search, then verifies the remaining rolls,
+ * instead of scanning all 2^32 seeds.
+ *
+ * Fingerprint: The first `k` rolls' ability indices, 4 bits each, with the 1st roll in the highest bits (so fingerprints sort like roll sequences).
+ * Fingerprints are recomputed from seeds on lookup, so each entry is only its seed: A complete index is 16 GiB, regardless of `k`.
+ *
+ * Layout (little endian):
+ *
+ * | Offset | Size | Content |
+ * | --- | --- | --- |
+ * | 0 | 4 | Magic `S3GI` |
+ * | 4 | 1 | Version (1) |
+ * | 5 | 1 | Rolls count `k` |
+ * | 6 | 1 | Table index (see `getTableIndex`) |
+ * | 7 | 1 | Reserved (0) |
+ * | 8 | 8 | Seeds count `n` (2^32 if complete) |
+ * | 16 | 4n | Seeds, sorted by (fingerprint, seed) |
+ *
+ * Neutral brands share 1 table. Each biased brand has its own.
+ */
+namespace SeedIndex {
+    constexpr std::string_view magic = "S3GI";
+    constexpr uint8_t version = 1;
+    constexpr std::string_view extension = ".s3gi";
+
+    constexpr size_t headerSize = 16;
+    constexpr size_t seedSize = 4;
+    constexpr uint64_t allSeedsCount = uint64_t{1} << 32;
+
+    /// Fingerprints are 32 bits. At least 2 rolls, which the build partitions by.
+    constexpr size_t minRollsCount = 2;
+    constexpr size_t maxRollsCount = 8;
+
+    /**
+     * 0: Neutral brands. 1 + i: `biasedBrands[i]`.
+     *
+     * @throws std::invalid_argument for unknown brands.
+     */
+    uint8_t getTableIndex(std::string_view brand);
+
+    /// `<directory>/<table>.s3gi`, where the table is `neutral` or the biased brand's name (lowercase, `_` for spaces).
+    std::string getFilename(const std::string& directory, std::string_view brand);
+
+    /// Fingerprint of the first `rollsCount` no-drink rolls from `seed`.
+    uint32_t getFingerprint(const SeedHelper& seedHelper, uint32_t seed, size_t rollsCount);
+
+    /**
+     * Build the index of `brand`'s table for the initial seeds [0, seedsCount).
+     *
+     * Parallel and streamed: Workers partition seeds into temporary bucket files by their first 2 rolls, then each bucket is sorted on its own.
+     * Buckets being sorted hold at most 2^28 seeds (3 GiB) at once, whatever `workersCount` is. Larger buckets (up to ~8% of all seeds, for a biased brand's likely ability rolled twice) are sorted alone.
+     * Written to a temporary file first, then renamed.
+     *
+     * @param seedsCount Less than `allSeedsCount` for partial indices (e.g. tests). `find` only uses complete indices.
+     * @throws std::invalid_argument for an unknown brand or rolls count, or std::runtime_error if files can't be written.
+     */
+    void build(const std::string& filename, std::string_view brand, size_t rollsCount, uint64_t seedsCount = allSeedsCount, size_t workersCount = 0);
+}
+
+
+/**
+ * Read-only memory mapped `.s3gi` file.
+ *
+ * Only the header is validated on open. Lookups touch ~32 pages of the mapping.
+ */
+class SeedIndexView {
+private:
+    const uint8_t* data;
+    size_t size;
+
+    /// Read a little endian integer at `offset`.
+    template <typename T>
+    [[nodiscard]] T read(const size_t offset) const {
+        T returnValue = 0;
+        for (size_t i = 0; i < sizeof(T); i += 1) {
+            returnValue |= static_cast<T>(static_cast<T>(data[offset + i]) << (8 * i));
+        }
+        return returnValue;
+    }
+
+    [[nodiscard]] uint32_t getSeed(const uint64_t index) const {
+        return read<uint32_t>(SeedIndex::headerSize + SeedIndex::seedSize * index);
+    }
+
+public:
+    /// @throws std::runtime_error if the file can't be mapped or isn't a valid `.s3gi` file.
+    explicit SeedIndexView(const std::string& filename);
+    ~SeedIndexView();
+
+    SeedIndexView(const SeedIndexView&) = delete;
+    SeedIndexView& operator=(const SeedIndexView&) = delete;
+
+public:
+    [[nodiscard]] size_t getRollsCount() const {
+        return data[5];
+    }
+
+    [[nodiscard]] uint8_t getTableIndex() const {
+        return data[6];
+    }
+
+    [[nodiscard]] uint64_t getSeedsCount() const {
+        return read<uint64_t>(8);
+    }
+
+    [[nodiscard]] bool isComplete() const {
+        return getSeedsCount() == SeedIndex::allSeedsCount;
+    }
+
+    /// Whether the first `k` rolls are known single abilities, and no roll uses a drink.
+    [[nodiscard]] bool canFindSeed(const RollSequence& rollSequence) const;
+
+    /**
+     * Same results as `SeedHelper::findSeed` (within the indexed seeds).
+     *
+     * @param seedHelper Must use this index's table.
+     * @param stats Counts the seeds with a matching fingerprint as evaluated, like `SeedHelper::findSeed`'s workers.
+     * @throws std::invalid_argument if `canFindSeed` is false, or `seedHelper`'s brand uses another table.
+     */
+    [[nodiscard]] std::vector<uint32_t> findSeed(const SeedHelper& seedHelper, const RollSequence& rollSequence, SearchStats* stats = nullptr) const;
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_SEED_INDEX_H
@@ -0,0 +1,39 @@
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "binary/seed_index.h"
+
+
+int main(int argc, char* argv[]) {
+    // Parse arguments.
+    if (argc < 3) {
+        throw std::invalid_argument("Usage: build-index <brand> <directory> [--rolls <k>] [--seeds <count>]");
+    }
+
+    const std::string brand{argv[1]};
+    const std::string directory{argv[2]};
+    size_t rollsCount = 4;
+    auto seedsCount = SeedIndex::allSeedsCount;
+    for (int i = 3; i < argc; i += 1) {
+        if ((std::strcmp(argv[i], "--rolls") == 0) && (i + 1 < argc)) {
+            rollsCount = std::stoul(argv[i + 1]);
+            i += 1;
+        } else if ((std::strcmp(argv[i], "--seeds") == 0) && (i + 1 < argc)) {
+            seedsCount = std::stoull(argv[i + 1]);
+            i += 1;
+        } else {
+            throw std::invalid_argument(std::string{"Unknown argument: "} + argv[i]);
+        }
+    }
+
+    // Build.
+    std::filesystem::create_directories(directory);
+    const auto filename = SeedIndex::getFilename(directory, brand);
+    SeedIndex::build(filename, brand, rollsCount, seedsCount, std::thread::hardware_concurrency());
+    std::cout << "Built " << filename << " (" << seedsCount << " seeds, " << rollsCount << " rolls)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#include "binary/gear_file.h"
+#include "binary/roll_journal.h"
+
+
+int main(int argc, char* argv[]) {
+    // Parse arguments.
+    if (argc != 3) {
+        throw std::invalid_argument("Usage: convert <input file> <output file> (YAML <-> `.gear`/`.journal`)");
+    }
+
+    const std::string inputFilename{argv[1]};
+    const std::string outputFilename{argv[2]};
+    const auto inputExtension = std::filesystem::path{inputFilename}.extension();
+    const auto outputExtension = std::filesystem::path{outputFilename}.extension();
+    const auto isYaml = [](const std::filesystem::path& extension) {
+        return (extension == ".yaml") || (extension == ".yml");
+    };
+
+    if (isYaml(inputExtension) && (outputExtension == GearFile::extension)) {
+        GearFile::convertYamlToGear(inputFilename, outputFilename);
+    } else if ((inputExtension == GearFile::extension) && isYaml(outputExtension)) {
+        GearFile::convertGearToYaml(inputFilename, outputFilename);
+    } else if (isYaml(inputExtension) && (outputExtension == RollJournal::extension)) {
+        RollJournal::convertYamlToJournal(inputFilename, outputFilename);
+    } else if ((inputExtension == RollJournal::extension) && isYaml(outputExtension)) {
+        RollJournal::convertJournalToYaml(inputFilename, outputFilename);
+    } else {
+        throw std::invalid_argument("Unsupported conversion. Convert between YAML and `.gear`/`.journal` files.");
+    }
+    std::cout << "Converted " << inputFilename << " -> " << outputFilename << std::endl;
+
+    return 0;
+}
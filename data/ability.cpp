@@ -4,24 +4,57 @@
 
 #include "ability.h"
 
+#include <stdexcept>
 #include <string>
 
 
 namespace AbilityHelper {
-    Ability fromId(std::string_view id) {
+    /**
+     * `fromId` lookup table: A perfect hash of the ability IDs and the placeholder ID.
+     *
+     * Empty slots are `Ability::noDrink`.
+     */
+    static constexpr size_t idTableSize = 32;
+
+    /// Only valid for IDs with at least 3 characters. The characters were chosen by searching for a collision-free combination.
+    static constexpr size_t hashId(const std::string_view id) {
+        return (static_cast<size_t>(id[2]) * 2 + static_cast<size_t>(id[id.size() - 3]) + id.size()) % idTableSize;
+    }
+
+    static constexpr std::array<Ability, idTableSize> idTable = []() {
+        std::array<Ability, idTableSize> returnValue{};
+        for (size_t i = 0; i < idTableSize; i += 1) {
+            returnValue[i] = Ability::noDrink;
+        }
+        for (size_t i = 0; i < ids.size(); i += 1) {
+            returnValue[hashId(ids[i])] = Ability(i);
+        }
+        returnValue[hashId(placeholderId)] = Ability::unknown;
+        return returnValue;
+    }();
+
+    /// Every ID has its own slot.
+    static constexpr bool isIdTablePerfect() {
         for (size_t i = 0; i < ids.size(); i += 1) {
-            if (id == ids[i]) {
-                return Ability(i);
+            if (idTable[hashId(ids[i])] != Ability(i)) {
+                return false;
             }
         }
+        return idTable[hashId(placeholderId)] == Ability::unknown;
+    }
+    static_assert(isIdTablePerfect(), "`hashId` has collisions.");
 
-        if (id == placeholderId) {
-            return Ability::unknown;
-        } else {
-            std::string exceptionMessage{"Invalid ability ID: "};
-            exceptionMessage += id;
-            throw std::invalid_argument(exceptionMessage);
+    Ability fromId(std::string_view id) {
+        if (id.size() >= 3) {
+            const auto ability = idTable[hashId(id)];
+            if ((ability != Ability::noDrink) && (getId(ability) == id)) {
+                return ability;
+            }
         }
+
+        std::string exceptionMessage{"Invalid ability ID: "};
+        exceptionMessage += id;
+        throw std::invalid_argument(exceptionMessage);
     }
 
     std::string_view getId(Ability ability) {
@@ -59,9 +59,17 @@ namespace AbilityHelper {
     std::string_view getId(Ability ability);
 
     /// Get ability index.
-    inline size_t getIndex(Ability ability) {
+    constexpr size_t getIndex(Ability ability) {
         return static_cast<size_t>(ability);
     }
+
+    /// No drink, and each drink.
+    constexpr size_t drinkChoicesCount = abilitiesCount + 1;
+
+    /// Index 0: `Ability::noDrink`. Index `i + 1`: Drink `i`.
+    constexpr Ability getDrinkChoice(size_t index) {
+        return (index == 0) ? Ability::noDrink : static_cast<Ability>(index - 1);
+    }
 }
 
 
@@ -0,0 +1,119 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_ABILITY_SET_H
+#define SPLATOON_3_GEAR_HELPER_CPP_ABILITY_SET_H
+
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "ability.h"
+
+
+/**
+ * A set of abilities stored as a bit mask.
+ * Bit `i` corresponds to `Ability(i)`, so membership is a single bit test.
+ *
+ * - `Ability::unknown` is stored as "any of the 14 abilities"
+ * - `Ability::noDrink` has its own bit (used for drink sets, see `anyDrink`)
+ */
+class AbilitySet {
+public:
+    using MaskType = uint16_t;
+
+    /// All 14 abilities.
+    static constexpr MaskType allAbilitiesMask = (1 << AbilityHelper::abilitiesCount) - 1;
+    static constexpr MaskType noDrinkMask = 1 << static_cast<size_t>(Ability::noDrink);
+
+private:
+    MaskType mask;
+
+    static constexpr MaskType toMask(const Ability ability) {
+        if (ability == Ability::unknown) {
+            return allAbilitiesMask;
+        }
+        return static_cast<MaskType>(1 << static_cast<size_t>(ability));
+    }
+
+public:
+    /// Empty set.
+    constexpr AbilitySet(): mask{0} {}
+
+    /// Single ability (or every ability for `Ability::unknown`).
+    constexpr AbilitySet(const Ability ability): mask{toMask(ability)} {}  // NOLINT(google-explicit-constructor): Implicit on purpose.
+
+    static constexpr AbilitySet fromMask(const MaskType mask) {
+        AbilitySet returnValue{};
+        returnValue.mask = mask;
+        return returnValue;
+    }
+
+    /// Any drink, or no drink at all.
+    static constexpr AbilitySet anyDrink() {
+        return fromMask(allAbilitiesMask | noDrinkMask);
+    }
+
+    /// Whether a rolled ability mask read from a file is a non-empty set of the 14 abilities (`unknown` is all of them, not its own bit).
+    static constexpr bool isValidAbilitiesMask(const uint32_t mask) {
+        return (mask != 0) && ((mask & ~uint32_t{allAbilitiesMask}) == 0);
+    }
+
+    /// Same for drink masks, which may also contain `noDrink`.
+    static constexpr bool isValidDrinksMask(const uint32_t mask) {
+        return (mask != 0) && ((mask & ~uint32_t{allAbilitiesMask | noDrinkMask}) == 0);
+    }
+
+public:
+    [[nodiscard]] constexpr MaskType getMask() const {
+        return mask;
+    }
+
+    [[nodiscard]] constexpr bool contains(const Ability ability) const {
+        return (mask >> static_cast<size_t>(ability)) & 1;
+    }
+
+    constexpr void insert(const Ability ability) {
+        mask |= toMask(ability);
+    }
+
+    [[nodiscard]] constexpr bool empty() const {
+        return mask == 0;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return std::bitset<16>(mask).count();
+    }
+
+    /// The only element. Only valid when `size() == 1`.
+    [[nodiscard]] Ability getSingle() const {
+        assert(size() == 1);
+        return static_cast<Ability>(__builtin_ctz(mask));
+    }
+
+    /// Contains every ability (i.e. `Ability::unknown`).
+    [[nodiscard]] constexpr bool isUnknown() const {
+        return (mask & allAbilitiesMask) == allAbilitiesMask;
+    }
+
+    /// All abilities (and `noDrink` if present) in this set, in index order.
+    [[nodiscard]] std::vector<Ability> toVector() const {
+        std::vector<Ability> returnValue{};
+        for (size_t i = 0; i < 16; i += 1) {
+            if ((mask >> i) & 1) {
+                returnValue.push_back(static_cast<Ability>(i));
+            }
+        }
+
+        return returnValue;
+    }
+
+public:
+    friend constexpr bool operator==(const AbilitySet lhs, const AbilitySet rhs) {
+        return lhs.mask == rhs.mask;
+    }
+    friend constexpr bool operator!=(const AbilitySet lhs, const AbilitySet rhs) {
+        return lhs.mask != rhs.mask;
+    }
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_ABILITY_SET_H
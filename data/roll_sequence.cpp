@@ -4,6 +4,8 @@
 
 #include "roll_sequence.h"
 
+#include <algorithm>
+
 
 RollSequence::RollSequence(const std::vector<Ability> &rolls): data{} {
     data.reserve(rolls.size());
@@ -15,11 +17,19 @@ RollSequence::RollSequence(const std::vector<Ability> &rolls): data{} {
 
 std::unordered_set<Ability> RollSequence::getDrinksUsed() const {
      std::unordered_set<Ability> returnValue{};
-     for (const auto [roll, drink]: data) {
-         if (drink != Ability::noDrink) {
-             returnValue.insert(drink);
+     for (const auto [roll, drinks]: data) {
+         for (const auto drink: drinks.toVector()) {
+             if (drink != Ability::noDrink) {
+                 returnValue.insert(drink);
+             }
          }
      }
 
      return returnValue;
 }
+
+bool RollSequence::hasUncertainDrinks() const {
+    return std::any_of(data.begin(), data.end(), [](const auto& rollAndDrinks) {
+        return rollAndDrinks.second.size() != 1;
+    });
+}
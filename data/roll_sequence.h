@@ -11,14 +11,20 @@
 #include <string_view>
 
 #include "ability.h"
+#include "ability_set.h"
 
 
 class RollSequence {
 public:
     /**
      * {(rolled ability, drink)}
+     *
+     * Both are sets:
+     *
+     * - Rolled ability: The roll is known to be one of these abilities. `Ability::unknown` is the full set.
+     * - Drink: One of these drinks was used. May contain `Ability::noDrink`. `AbilitySet::anyDrink()` if the drink is unknown.
      */
-    using DataType = std::vector<std::pair<Ability, Ability>>;
+    using DataType = std::vector<std::pair<AbilitySet, AbilitySet>>;
 private:
     DataType data;
 
@@ -54,20 +60,23 @@ public:
     explicit RollSequence(const std::vector<Ability>& rolls);
 
 public:
-    inline void addRoll(const Ability ability) {
+    inline void addRoll(const AbilitySet ability) {
         data.emplace_back(ability, Ability::noDrink);
     }
-    inline void addRoll(const Ability ability, const Ability drink) {
-        data.emplace_back(ability, drink);
+    inline void addRoll(const AbilitySet ability, const AbilitySet drinks) {
+        data.emplace_back(ability, drinks);
     }
 
 public:
     /**
-     * Get all drinks used.
+     * Get all drinks (possibly) used.
      *
      * Used to calculate/cache the "weights map" for each type of drink.
      */
     [[nodiscard]] std::unordered_set<Ability> getDrinksUsed() const;
+
+    /// Whether any roll has more than 1 possible drink (including `noDrink`).
+    [[nodiscard]] bool hasUncertainDrinks() const;
 };
 
 
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include "data/brand.h"
+#include "prediction/roll_economics.h"
+#include "helpers/output_buffer.h"
+#include "helpers/terminal_format.h"
+
+
+struct Result {
+    std::string_view brand;
+    /// `Ability::noDrink` or the target.
+    Ability drink;
+    RollEconomics::Histogram histogram;
+};
+
+
+std::string_view getDrinkId(const Ability drink) {
+    return (drink == Ability::noDrink) ? "none" : AbilityHelper::getId(drink);
+}
+
+/// Mean with 2 decimals.
+std::string formatMean(const RollEconomics::Histogram& histogram) {
+    char text[32];
+    const auto length = std::snprintf(text, sizeof(text), "%.2f", histogram.getMean());
+    return std::string{text, static_cast<size_t>(length)};
+}
+
+/// Quantile, or `>horizon`.
+std::string formatQuantile(const RollEconomics::Histogram& histogram, const double probability) {
+    const auto quantile = histogram.getQuantile(probability);
+    return quantile.has_value() ? std::to_string(quantile.value()) : (">" + std::to_string(histogram.horizon));
+}
+
+
+/// Summary table, cheapest first.
+void renderText(const std::vector<Result>& results, const Ability target, const size_t streakLength, const bool isExhaustive) {
+    const auto seedsCount = results.empty() ? 0 : results.front().histogram.getTotalCount();
+    std::cout << TerminalFormat::BOLD << "Rolls needed for " << streakLength << " " << AbilityHelper::getId(target) << " in a row (" << (isExhaustive ? "all " : "") << seedsCount
+              << (isExhaustive ? " seeds" : " sampled seeds") << ")" << TerminalFormat::ENDC << "\n";
+    std::cout << "rank\tbrand\tdrink\tmean\tmedian\tp90\tp99\tbeyond_horizon\n";
+    for (size_t i = 0; i < results.size(); i += 1) {
+        const auto& [brand, drink, histogram] = results[i];
+        std::cout << (i + 1) << "\t" << brand << "\t" << getDrinkId(drink) << "\t" << formatMean(histogram) << "\t" << formatQuantile(histogram, 0.5) << "\t"
+                  << formatQuantile(histogram, 0.9) << "\t" << formatQuantile(histogram, 0.99) << "\t" << histogram.overflowCount << "\n";
+    }
+    std::cout << std::flush;
+}
+
+/// Compact histograms: Columns: brand, drink, rolls (or `beyond_horizon`), seeds. Only non-zero counts.
+void renderTsv(OutputBuffer& output, const std::vector<Result>& results) {
+    output << "brand\tdrink\trolls\tseeds\n";
+    for (const auto& [brand, drink, histogram]: results) {
+        for (size_t rollsCount = 0; rollsCount < histogram.counts.size(); rollsCount += 1) {
+            if (histogram.counts[rollsCount] > 0) {
+                output << brand << '\t' << getDrinkId(drink) << '\t' << rollsCount << '\t' << histogram.counts[rollsCount] << '\n';
+            }
+        }
+        if (histogram.overflowCount > 0) {
+            output << brand << '\t' << getDrinkId(drink) << "\tbeyond_horizon\t" << histogram.overflowCount << '\n';
+        }
+    }
+}
+
+/**
+ * ```
+ * [{"brand": ..., "drink": "none" | ability ID, "mean": ..., "beyond_horizon": ..., "histogram": [[rolls, seeds]...]}...]
+ * ```
+ */
+void renderJson(OutputBuffer& output, const std::vector<Result>& results) {
+    output << '[';
+    for (size_t i = 0; i < results.size(); i += 1) {
+        const auto& [brand, drink, histogram] = results[i];
+        output << ((i == 0) ? "{\"brand\":" : ",{\"brand\":");
+        output.appendJsonString(brand) << ",\"drink\":\"" << getDrinkId(drink) << "\",\"mean\":" << formatMean(histogram) << ",\"beyond_horizon\":" << histogram.overflowCount << ",\"histogram\":[";
+
+        bool isFirst = true;
+        for (size_t rollsCount = 0; rollsCount < histogram.counts.size(); rollsCount += 1) {
+            if (histogram.counts[rollsCount] > 0) {
+                output << (isFirst ? "[" : ",[") << rollsCount << ',' << histogram.counts[rollsCount] << ']';
+                isFirst = false;
+            }
+        }
+        output << "]}";
+    }
+    output << "]\n";
+}
+
+
+int main(int argc, char* argv[]) {
+    // Parse arguments.
+    if (argc < 2) {
+        throw std::invalid_argument("Usage: economics <ability ID> [--brand <brand>]... [--exhaustive | --samples N] [--random-seed N] [--streak N] [--horizon N] [--format text|json|tsv]");
+    }
+
+    const auto target = AbilityHelper::fromId(argv[1]);
+    if (target == Ability::unknown) {
+        throw std::invalid_argument("Target ability can't be `unknown`.");
+    }
+    std::vector<std::string_view> brands{};
+    bool isExhaustive = false;
+    uint64_t samplesCount = 100'000;
+    uint64_t randomSeed = 0;
+    size_t streakLength = 3;
+    size_t horizon = RollEconomics::defaultHorizon;
+    auto format = OutputFormat::text;
+
+    for (int i = 2; i < argc; i += 1) {
+        const std::string_view argument{argv[i]};
+        if ((argument == "--brand") && (i + 1 < argc)) {
+            i += 1;
+            brands.emplace_back(argv[i]);
+        } else if (argument == "--exhaustive") {
+            isExhaustive = true;
+        } else if ((argument == "--samples") && (i + 1 < argc)) {
+            i += 1;
+            samplesCount = std::stoull(argv[i]);
+        } else if ((argument == "--random-seed") && (i + 1 < argc)) {
+            i += 1;
+            randomSeed = std::stoull(argv[i]);
+        } else if ((argument == "--streak") && (i + 1 < argc)) {
+            i += 1;
+            streakLength = std::stoul(argv[i]);
+        } else if ((argument == "--horizon") && (i + 1 < argc)) {
+            i += 1;
+            horizon = std::stoul(argv[i]);
+        } else if ((argument == "--format") && (i + 1 < argc)) {
+            i += 1;
+            format = OutputFormatHelper::fromId(argv[i]);
+        } else {
+            std::string exceptionMessage{"Unrecognized argument: "};
+            exceptionMessage += argument;
+            throw std::invalid_argument(exceptionMessage);
+        }
+    }
+    if (format == OutputFormat::binary) {
+        throw std::invalid_argument("`--format binary` isn't supported by `economics`.");
+    }
+    if (brands.empty()) {
+        brands.insert(brands.end(), neutralBrands.begin(), neutralBrands.end());
+        for (const auto& biasedBrand: biasedBrands) {
+            brands.push_back(std::get<0>(biasedBrand));
+        }
+    }
+
+    // No drink, and the target's drink, for each brand.
+    const auto workersCount = std::thread::hardware_concurrency();
+    std::vector<Result> results{};
+    std::optional<std::pair<RollEconomics::Histogram, RollEconomics::Histogram>> neutralHistograms{};
+    for (const auto brand: brands) {
+        const auto isNeutral = std::find(neutralBrands.begin(), neutralBrands.end(), brand) != neutralBrands.end();
+        if (isNeutral && neutralHistograms.has_value()) {
+            // Neutral brands share 1 table.
+            results.push_back(Result{brand, Ability::noDrink, neutralHistograms->first});
+            results.push_back(Result{brand, target, neutralHistograms->second});
+            continue;
+        }
+
+        SeedHelper seedHelper{brand};
+        seedHelper.cacheDrinkRollToAbilityMap(target);
+        const auto getHistogram = [&](const Ability drink) {
+            if (isExhaustive) {
+                return RollEconomics::sweep(seedHelper, target, drink, streakLength, horizon, workersCount);
+            }
+            return RollEconomics::sample(seedHelper, target, drink, samplesCount, randomSeed, streakLength, horizon, workersCount);
+        };
+
+        results.push_back(Result{brand, Ability::noDrink, getHistogram(Ability::noDrink)});
+        results.push_back(Result{brand, target, getHistogram(target)});
+        if (isNeutral) {
+            neutralHistograms = std::make_pair(results[results.size() - 2].histogram, results.back().histogram);
+        }
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const Result& lhs, const Result& rhs) {
+        return lhs.histogram.getMean() < rhs.histogram.getMean();
+    });
+
+    // Print.
+    OutputBuffer output{};
+    switch (format) {
+        case OutputFormat::text:
+            renderText(results, target, streakLength, isExhaustive);
+            break;
+        case OutputFormat::json:
+            renderJson(output, results);
+            break;
+        case OutputFormat::tsv:
+            renderTsv(output, results);
+            break;
+        case OutputFormat::binary:
+            break;
+    }
+
+    return 0;
+}
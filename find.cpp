@@ -1,46 +1,144 @@
+#include <filesystem>
 #include <iostream>
 #include <stdexcept>
 #include <thread>
 
 #include "yaml/yaml_helper.h"
 #include "seed_helper.h"
+#include "search_profile.h"
+#include "binary/seed_index.h"
+#include "prediction/drink_advisor.h"
+#include "helpers/output_buffer.h"
+#include "helpers/stats.h"
+#include "helpers/trace.h"
 
 
-int main(int argc, char* argv[]) {
-    // Parse arguments.
-    if (argc == 1) {
-        throw std::invalid_argument("No filename given.");
+/// Print which drink narrows down `results` the most on the next roll.
+void printNextDrinkAdvice(SeedHelper& seedHelper, const std::vector<uint32_t>& results, const RollSequence& rollSequence) {
+    // With uncertain drinks, results may have multiple current seeds each.
+    const auto advice = DrinkAdvisor::adviseNextDrinkAfterRolls(seedHelper, results, rollSequence, std::thread::hardware_concurrency());
+
+    std::cout << std::dec << "Next roll advice (expected remaining candidates):\n";
+    for (const auto& [drink, nextAbilityCounts, expectedRemainingCandidates]: advice) {
+        std::cout << ((drink == Ability::noDrink) ? "no_drink" : AbilityHelper::getId(drink)) << ": " << expectedRemainingCandidates << "\n";
     }
+    std::cout << std::flush;
+}
 
-    const auto filename = argv[1];
-    bool overwriteFile = false;
 
-    for (int i = 2; i < argc; i += 1) {
-        const std::string_view argument{argv[i]};
-        if ((argument == "--overwrite") || (argument == "-o")) {
-            overwriteFile = true;
-        } else {
-            std::string exceptionMessage{"Unrecognized argument: "};
-            exceptionMessage += argument;
-            throw std::invalid_argument(exceptionMessage);
-        }
+/**
+ * Stream all results in a machine-readable format.
+ *
+ * - JSON: `{"seeds": [...]}`
+ * - TSV: `seed` column
+ * - Binary (little endian): Magic `S3GS`, uint64 results count, then uint32 seeds
+ */
+void printResults(const std::vector<uint32_t>& results, const OutputFormat format) {
+    // Written in chunks, so that millions of results don't need one huge buffer.
+    constexpr size_t chunkSize = 1 << 16;
+    OutputBuffer output{STDOUT_FILENO, chunkSize + 64, chunkSize};
+
+    switch (format) {
+        case OutputFormat::text:
+            // Printed with other messages in `findAndPrintSeed`.
+            break;
+        case OutputFormat::json:
+            output << "{\"seeds\":[";
+            for (size_t i = 0; i < results.size(); i += 1) {
+                if (i > 0) {
+                    output << ',';
+                }
+                output << results[i];
+            }
+            output << "]}\n";
+            break;
+        case OutputFormat::tsv:
+            output << "seed\n";
+            for (const auto result: results) {
+                output << result << '\n';
+            }
+            break;
+        case OutputFormat::binary:
+            output << "S3GS";
+            output.appendBinary(static_cast<uint64_t>(results.size()));
+            for (const auto result: results) {
+                output.appendBinary(result);
+            }
+            break;
+    }
+}
+
+
+/**
+ * Look up `rollSequence` in the brand's seed index under `indexDirectory`.
+ *
+ * @param stats Counted like a full search (`nullptr` if disabled).
+ * @return `std::nullopt` (after printing why to stderr) if there's no usable index, so the caller falls back to a full search.
+ */
+std::optional<std::vector<uint32_t>> findSeedWithIndex(const SeedHelper& seedHelper, const RollSequence& rollSequence, const std::string& indexDirectory, SearchStats* const stats) {
+    const auto indexFilename = SeedIndex::getFilename(indexDirectory, seedHelper.brandName);
+    if (!std::filesystem::exists(indexFilename)) {
+        std::cerr << "No seed index: " << indexFilename << ". Searching all seeds." << std::endl;
+        return std::nullopt;
+    }
+
+    const SeedIndexView index{indexFilename};
+    if (!index.isComplete()) {
+        std::cerr << "Incomplete seed index: " << indexFilename << ". Searching all seeds." << std::endl;
+        return std::nullopt;
+    }
+    if (!index.canFindSeed(rollSequence)) {
+        std::cerr << "The seed index needs " << index.getRollsCount() << " known rolls, and no drinks. Searching all seeds." << std::endl;
+        return std::nullopt;
     }
 
+    return index.findSeed(seedHelper, rollSequence, stats);
+}
+
+
+/**
+ * Find the initial seed of `filename`, and print the results.
+ *
+ * @return Exit code: 0 if exactly 1 seed is found.
+ */
+int findAndPrintSeed(const std::string& filename, const bool overwriteFile, const OutputFormat format, const std::optional<SearchProfile::Profile>& profile, const std::string& indexDirectory, RunStats& stats) {
     // Load YAML file and predict.
+    auto loadPhase = stats.startPhase("load");
     YamlFile yamlFile{filename};
+    loadPhase.stop();
     if (yamlFile.getRollSequence().empty()) {
         std::string exceptionMessage{"No roll sequence in file: "};
         exceptionMessage += filename;
         throw std::runtime_error(exceptionMessage);
     }
 
+    auto tablesPhase = stats.startPhase("tables");
     SeedHelper seedHelper{yamlFile.getBrand()};
-    const auto results = seedHelper.findSeed(yamlFile.getRollSequence(), std::thread::hardware_concurrency());
+    tablesPhase.stop();
+
+    auto searchPhase = stats.startPhase("search");
+    std::optional<std::vector<uint32_t>> indexResults{};
+    if (!indexDirectory.empty()) {
+        indexResults = findSeedWithIndex(seedHelper, yamlFile.getRollSequence(), indexDirectory, stats.getSearchStats());
+    }
+    const auto configuration = SearchProfile::getConfiguration(profile, yamlFile.getRollSequence());
+    const auto results = indexResults.has_value() ? std::move(indexResults.value()) : seedHelper.findSeed(yamlFile.getRollSequence(), configuration, stats.getSearchStats());
+    searchPhase.stop();
+
+    const auto outputPhase = stats.startPhase("output");
+    // Machine-readable results go to stdout, and status messages to stderr.
+    std::ostream& messages = (format == OutputFormat::text) ? std::cout : std::cerr;
+    if (format != OutputFormat::text) {
+        printResults(results, format);
+    }
+
     if (results.empty()) {
-        std::cout << "No result found." << std::endl;
+        messages << "No result found." << std::endl;
         return 1;
     } else if (results.size() > 1) {
-        if (results.size() > 100) {
+        if (format != OutputFormat::text) {
+            return 2;
+        } else if (results.size() > 100) {
             std::cout << "Too many (" << results.size() << ") results found. Please add more rolls." << std::endl;
         } else {
             std::cout << results.size() << " results found:\n";
@@ -49,27 +147,118 @@ int main(int argc, char* argv[]) {
             }
             std::cout << std::flush;
         }
+        printNextDrinkAdvice(seedHelper, results, yamlFile.getRollSequence());
         return 2;
     }
 
     // Only 1 possible seed.
     const auto seed = results[0];
-    std::cout << "Found seed: 0x" << std::hex << seed << std::endl;
+    messages << "Found seed: 0x" << std::hex << seed << std::endl;
     if (yamlFile.getInitialSeed().has_value()) {
         // Verify existing initial seed.
         if (seed != yamlFile.getInitialSeed()) {
-            std::cout << "Doesn't match existing seed in YAML file: 0x" << std::hex << yamlFile.getInitialSeed().value() << std::endl;
+            messages << "Doesn't match existing seed in YAML file: 0x" << std::hex << yamlFile.getInitialSeed().value() << std::endl;
             return 3;
         } else {
-            std::cout << "Matches seed in YAML file." << std::endl;
+            messages << "Matches seed in YAML file." << std::endl;
         }
     } else {
         // Save the initial seed.
         if (overwriteFile) {
             yamlFile.setInitialSeed(seed);
-            std::cout << "Initial seed saved to YAML file: " << filename << std::endl;
+            messages << "Initial seed saved to YAML file: " << filename << std::endl;
         }
     }
 
     return 0;
 }
+
+
+int main(int argc, char* argv[]) {
+    // Parse arguments.
+    if (argc == 1) {
+        throw std::invalid_argument("No filename given.");
+    }
+
+    // `find --autotune`: No gear file.
+    const auto filename = argv[1];
+    const auto isAutotune = (std::string_view{filename} == "--autotune");
+    bool overwriteFile = false;
+    auto format = OutputFormat::text;
+    bool printStats = false;
+    bool countHardwareEvents = false;
+    std::string prometheusFilename{};
+    std::string traceFilename{};
+    auto profileFilename = SearchProfile::getDefaultFilename();
+    std::string indexDirectory{};
+
+    for (int i = 2; i < argc; i += 1) {
+        const std::string_view argument{argv[i]};
+        if ((argument == "--overwrite") || (argument == "-o")) {
+            overwriteFile = true;
+        } else if ((argument == "--format") && (i + 1 < argc)) {
+            i += 1;
+            format = OutputFormatHelper::fromId(argv[i]);
+        } else if (argument == "--stats") {
+            printStats = true;
+        } else if (argument == "--hw-counters") {
+            // Reported with the other stats.
+            printStats = true;
+            countHardwareEvents = true;
+        } else if ((argument == "--stats-prometheus") && (i + 1 < argc)) {
+            i += 1;
+            prometheusFilename = argv[i];
+        } else if ((argument == "--trace") && (i + 1 < argc)) {
+            i += 1;
+            traceFilename = argv[i];
+        } else if ((argument == "--profile") && (i + 1 < argc)) {
+            i += 1;
+            profileFilename = argv[i];
+        } else if ((argument == "--index") && (i + 1 < argc)) {
+            i += 1;
+            indexDirectory = argv[i];
+        } else {
+            std::string exceptionMessage{"Unrecognized argument: "};
+            exceptionMessage += argument;
+            throw std::invalid_argument(exceptionMessage);
+        }
+    }
+
+    if (isAutotune) {
+        if (profileFilename.empty()) {
+            throw std::invalid_argument("No search profile filename: Use `--profile`, or set $HOME.");
+        }
+
+        const auto profile = SearchProfile::autotune(std::cout);
+        SearchProfile::save(profile, profileFilename);
+        std::cout << "Search profile saved to: " << profileFilename << std::endl;
+        return 0;
+    }
+
+    // Without a profile, searches use all hardware threads.
+    std::optional<SearchProfile::Profile> profile{};
+    if (!profileFilename.empty()) {
+        profile = SearchProfile::load(profileFilename);
+    }
+
+    if (!traceFilename.empty()) {
+        Trace::enable();
+    }
+    RunStats stats{printStats || !prometheusFilename.empty()};
+    if (countHardwareEvents) {
+        stats.enableHardwareCounters();
+    }
+    const auto exitCode = findAndPrintSeed(filename, overwriteFile, format, profile, indexDirectory, stats);
+
+    if (printStats) {
+        stats.print(std::cerr);
+    }
+    if (!prometheusFilename.empty()) {
+        stats.writePrometheus(prometheusFilename, "find");
+    }
+    if (!traceFilename.empty()) {
+        Trace::write(traceFilename);
+    }
+
+    return exitCode;
+}
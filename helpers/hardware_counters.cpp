@@ -0,0 +1,118 @@
+#include "hardware_counters.h"
+
+#include <cerrno>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef __linux__
+namespace {
+    /// (type, config). Indices: `HardwareCounts::Event`.
+    constexpr std::array<std::pair<uint32_t, uint64_t>, HardwareCounts::eventsCount> eventConfigs{
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+        std::make_pair(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)),
+        std::make_pair(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)),
+    };
+
+    /// Layout for `PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING`.
+    struct ReadFormat {
+        uint64_t value;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+    };
+}
+#endif
+
+
+HardwareCounters::HardwareCounters(): fileDescriptors{}, error{0} {
+    fileDescriptors.fill(-1);
+
+#ifdef __linux__
+    for (size_t i = 0; i < HardwareCounts::eventsCount; i += 1) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = eventConfigs[i].first;
+        attributes.config = eventConfigs[i].second;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        // Opened separately (not as a group), so 1 unsupported event doesn't disable the others.
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // This thread, any CPU.
+        const auto fileDescriptor = static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        if (fileDescriptor < 0) {
+            if (error == 0) {
+                error = errno;
+            }
+            continue;
+        }
+        fileDescriptors[i] = fileDescriptor;
+    }
+#else
+    error = ENOSYS;
+#endif
+}
+
+HardwareCounters::~HardwareCounters() {
+#ifdef __linux__
+    for (const auto fileDescriptor: fileDescriptors) {
+        if (fileDescriptor >= 0) {
+            ::close(fileDescriptor);
+        }
+    }
+#endif
+}
+
+void HardwareCounters::start() {
+#ifdef __linux__
+    for (const auto fileDescriptor: fileDescriptors) {
+        if (fileDescriptor >= 0) {
+            ::ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+HardwareCounts HardwareCounters::stop() {
+    HardwareCounts returnValue{};
+    returnValue.error = error;
+
+#ifdef __linux__
+    for (const auto fileDescriptor: fileDescriptors) {
+        if (fileDescriptor >= 0) {
+            ::ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t i = 0; i < HardwareCounts::eventsCount; i += 1) {
+        if (fileDescriptors[i] < 0) {
+            continue;
+        }
+
+        ReadFormat result{};
+        if (::read(fileDescriptors[i], &result, sizeof(result)) != sizeof(result) || (result.timeRunning == 0)) {
+            // Never scheduled (e.g. too many counters for the PMU).
+            continue;
+        }
+
+        auto value = result.value;
+        if (result.timeRunning < result.timeEnabled) {
+            value = static_cast<uint64_t>(static_cast<double>(value) * static_cast<double>(result.timeEnabled) / static_cast<double>(result.timeRunning));
+        }
+        returnValue.values[i] = value;
+        returnValue.availableMask |= 1u << i;
+    }
+#endif
+
+    return returnValue;
+}
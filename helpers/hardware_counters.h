@@ -0,0 +1,62 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_HARDWARE_COUNTERS_H
+#define SPLATOON_3_GEAR_HELPER_CPP_HARDWARE_COUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+
+/// Counted CPU events of 1 thread (`--hw-counters`).
+struct HardwareCounts {
+    enum Event: size_t {
+        cycles,
+        instructions,
+        branchMisses,
+        l1dMisses,
+        llcMisses,
+    };
+    static constexpr size_t eventsCount = 5;
+    /// Indices: `Event`. Same names as `perf list`.
+    static constexpr std::array<std::string_view, eventsCount> eventNames{"cycles", "instructions", "branch-misses", "L1-dcache-load-misses", "LLC-misses"};
+
+    /// Indices: `Event`. Scaled up if the kernel multiplexed the counter.
+    std::array<uint64_t, eventsCount> values{};
+    /// Bit `i`: Event `i` was counted.
+    uint32_t availableMask = 0;
+    /// `errno` of the first counter that couldn't be opened, or 0.
+    int error = 0;
+
+    [[nodiscard]] bool isAvailable(const Event event) const {
+        return (availableMask & (1u << event)) != 0;
+    }
+};
+
+
+/**
+ * `perf_event_open` counters for the calling thread (user space only).
+ *
+ * Counters that can't be opened (e.g. `perf_event_paranoid`, a container's seccomp profile, virtual machines without a PMU, or non-Linux systems)
+ * are left out of `availableMask` instead of failing.
+ */
+class HardwareCounters {
+private:
+    /// -1 if unavailable.
+    std::array<int, HardwareCounts::eventsCount> fileDescriptors;
+    int error;
+
+public:
+    /// Opens the counters, disabled.
+    HardwareCounters();
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+    ~HardwareCounters();
+
+    /// Reset and enable all counters.
+    void start();
+
+    /// Disable and read all counters.
+    HardwareCounts stop();
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_HARDWARE_COUNTERS_H
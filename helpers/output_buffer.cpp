@@ -0,0 +1,100 @@
+#include "output_buffer.h"
+
+#include <cerrno>
+#include <charconv>
+#include <stdexcept>
+
+
+#pragma mark - Output format
+namespace OutputFormatHelper {
+    OutputFormat fromId(const std::string_view id) {
+        if (id == "text") {
+            return OutputFormat::text;
+        } else if (id == "json") {
+            return OutputFormat::json;
+        } else if (id == "tsv") {
+            return OutputFormat::tsv;
+        } else if (id == "binary") {
+            return OutputFormat::binary;
+        }
+
+        std::string exceptionMessage{"Invalid output format: "};
+        exceptionMessage += id;
+        throw std::invalid_argument(exceptionMessage);
+    }
+}
+
+
+#pragma mark - Constructor
+OutputBuffer::OutputBuffer(const int fileDescriptor, const size_t capacity, const size_t flushThreshold): buffer{}, fileDescriptor{fileDescriptor}, flushThreshold{flushThreshold} {
+    buffer.reserve(capacity);
+}
+
+OutputBuffer::~OutputBuffer() {
+    try {
+        flush();
+    } catch (const std::runtime_error&) {
+        // Nowhere to report to.
+    }
+}
+
+void OutputBuffer::flush() {
+    size_t written = 0;
+    while (written < buffer.size()) {
+        const auto result = ::write(fileDescriptor, buffer.data() + written, buffer.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            buffer.clear();
+            throw std::runtime_error("Failed to write output.");
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    buffer.clear();
+}
+
+
+#pragma mark - Text
+OutputBuffer& OutputBuffer::appendHex(const uint64_t value) {
+    char digits[18] = {'0', 'x'};
+    const auto [end, error] = std::to_chars(digits + 2, digits + sizeof(digits), value, 16);
+    return (*this << std::string_view{digits, static_cast<size_t>(end - digits)});
+}
+
+OutputBuffer& OutputBuffer::appendJsonString(const std::string_view str) {
+    constexpr char hexDigits[] = "0123456789abcdef";
+
+    buffer += '"';
+    for (const auto c: str) {
+        switch (c) {
+            case '"':
+                buffer += "\\\"";
+                break;
+            case '\\':
+                buffer += "\\\\";
+                break;
+            case '\n':
+                buffer += "\\n";
+                break;
+            case '\t':
+                buffer += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    buffer += "\\u00";
+                    buffer += hexDigits[c >> 4];
+                    buffer += hexDigits[c & 0xf];
+                } else {
+                    // UTF-8 bytes are copied as is.
+                    buffer += c;
+                }
+        }
+    }
+    buffer += '"';
+
+    flushIfNeeded();
+    return *this;
+}
@@ -0,0 +1,126 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_OUTPUT_BUFFER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_OUTPUT_BUFFER_H
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <unistd.h>
+
+#include "terminal_format.h"
+
+
+/// `--format` option of the executables.
+enum class OutputFormat {
+    /// Human readable, styled when stdout is a terminal.
+    text,
+    json,
+    /// Tab separated values with a header row.
+    tsv,
+    /// Little endian fixed-width records. See each executable for the layout.
+    binary,
+};
+
+namespace OutputFormatHelper {
+    /// @throws std::invalid_argument for unknown formats.
+    OutputFormat fromId(std::string_view id);
+}
+
+
+/**
+ * Output rendered into one buffer, and written with a single `write` call.
+ *
+ * Streaming mode: Set `flushThreshold` to write out whenever the buffer grows past it,
+ * so that large outputs don't have to fit in memory.
+ *
+ * Remaining contents are written on destruction.
+ */
+class OutputBuffer {
+public:
+    static constexpr size_t defaultCapacity = 1 << 16;
+
+    /// No streaming: Only write on `flush` and destruction.
+    static constexpr size_t noFlushThreshold = SIZE_MAX;
+
+private:
+    std::string buffer;
+    int fileDescriptor;
+    size_t flushThreshold;
+
+public:
+    explicit OutputBuffer(int fileDescriptor = STDOUT_FILENO, size_t capacity = defaultCapacity, size_t flushThreshold = noFlushThreshold);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    [[nodiscard]] std::string_view getData() const {
+        return buffer;
+    }
+
+    /**
+     * Write everything buffered so far.
+     * @throws std::runtime_error if writing fails.
+     */
+    void flush();
+
+#pragma mark Text
+public:
+    OutputBuffer& operator<<(const std::string_view str) {
+        buffer += str;
+        flushIfNeeded();
+        return *this;
+    }
+
+    OutputBuffer& operator<<(const char c) {
+        buffer += c;
+        flushIfNeeded();
+        return *this;
+    }
+
+    OutputBuffer& operator<<(const TerminalFormat::Code code) {
+        return (*this << code.get());
+    }
+
+    /// Decimal integers.
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>, int> = 0>
+    OutputBuffer& operator<<(const T value) {
+        char digits[24];
+        const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+        return (*this << std::string_view{digits, static_cast<size_t>(end - digits)});
+    }
+
+    /// `0x` prefixed lowercase hex, like `std::hex` output.
+    OutputBuffer& appendHex(uint64_t value);
+
+    /// Quoted and escaped JSON string.
+    OutputBuffer& appendJsonString(std::string_view str);
+
+#pragma mark Binary
+public:
+    /// Raw little endian bytes of an integer.
+    template <typename T>
+    OutputBuffer& appendBinary(const T value) {
+        static_assert(std::is_integral_v<T>);
+
+        char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i += 1) {
+            bytes[i] = static_cast<char>(static_cast<std::make_unsigned_t<T>>(value) >> (8 * i));
+        }
+        buffer.append(bytes, sizeof(T));
+        flushIfNeeded();
+        return *this;
+    }
+
+private:
+    void flushIfNeeded() {
+        if (buffer.size() >= flushThreshold) {
+            flush();
+        }
+    }
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_OUTPUT_BUFFER_H
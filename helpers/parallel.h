@@ -0,0 +1,103 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_PARALLEL_H
+#define SPLATOON_3_GEAR_HELPER_CPP_PARALLEL_H
+
+#include <atomic>
+#include <future>
+#include <optional>
+#include <vector>
+
+
+namespace Parallel {
+    /**
+     * Split [0, count) into `workersCount` contiguous ranges and call `worker(start, stop)` on each range [start, stop).
+     *
+     * - 0 workers: Run on the current thread
+     * - Workers run with `std::async`, like `SeedHelper::findSeed`
+     *
+     * @return Each worker's result, in range order.
+     */
+    template <typename Worker>
+    auto mapRanges(const size_t count, const size_t workersCount, Worker worker) {
+        using ResultType = decltype(worker(size_t{}, size_t{}));
+
+        std::vector<ResultType> returnValue{};
+        if (workersCount == 0) {
+            returnValue.push_back(worker(0, count));
+            return returnValue;
+        }
+
+        std::vector<std::future<ResultType>> futures{};
+        futures.reserve(workersCount);
+        for (size_t i = 0; i < workersCount; i += 1) {
+            // Balanced even when `count` < `workersCount`.
+            const auto start = count * i / workersCount;
+            const auto stop = count * (i + 1) / workersCount;
+            futures.push_back(std::async(std::launch::async, [&worker, start, stop]() {
+                return worker(start, stop);
+            }));
+        }
+
+        returnValue.reserve(workersCount);
+        for (auto& future: futures) {
+            returnValue.push_back(future.get());
+        }
+
+        return returnValue;
+    }
+
+    /**
+     * `mapRanges` with dynamic scheduling: Split [0, count) into `chunksCount` contiguous chunks, and let `workersCount` workers take the next chunk whenever they're done.
+     *
+     * Balances uneven chunks (e.g. workers slowed down by other processes) at the cost of more `worker` calls.
+     * With at most 1 chunk per worker, this is the same as `mapRanges`.
+     *
+     * @return Each chunk's result, in chunk order.
+     */
+    template <typename Worker>
+    auto mapChunks(const size_t count, const size_t workersCount, const size_t chunksCount, Worker worker) {
+        using ResultType = decltype(worker(size_t{}, size_t{}));
+
+        if ((workersCount == 0) || (chunksCount <= workersCount)) {
+            // 1 chunk per worker.
+            return mapRanges(count, workersCount, worker);
+        }
+
+        // Not `std::vector<ResultType>`: `std::vector<bool>` packs neighbouring chunks' results into 1 word, which workers would write concurrently.
+        std::vector<std::optional<ResultType>> chunkResults(chunksCount);
+        std::atomic<size_t> nextChunk{0};
+        mapRanges(workersCount, workersCount, [&](const size_t, const size_t) {
+            for (auto chunk = nextChunk.fetch_add(1); chunk < chunksCount; chunk = nextChunk.fetch_add(1)) {
+                chunkResults[chunk].emplace(worker(count * chunk / chunksCount, count * (chunk + 1) / chunksCount));
+            }
+            return true;
+        });
+
+        std::vector<ResultType> returnValue{};
+        returnValue.reserve(chunksCount);
+        for (auto& chunkResult: chunkResults) {
+            returnValue.push_back(std::move(chunkResult.value()));
+        }
+        return returnValue;
+    }
+
+    /// `mapRanges` for workers without results.
+    template <typename Worker>
+    void forEachRange(const size_t count, const size_t workersCount, Worker worker) {
+        mapRanges(count, workersCount, [&worker](const size_t start, const size_t stop) {
+            worker(start, stop);
+            return true;
+        });
+    }
+
+    /// `mapChunks` for workers without results.
+    template <typename Worker>
+    void forEachChunk(const size_t count, const size_t workersCount, const size_t chunksCount, Worker worker) {
+        mapChunks(count, workersCount, chunksCount, [&worker](const size_t start, const size_t stop) {
+            worker(start, stop);
+            return true;
+        });
+    }
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_PARALLEL_H
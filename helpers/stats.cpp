@@ -0,0 +1,238 @@
+#include "stats.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+
+namespace {
+    /// Max worker wall time over the mean. 1 is perfectly balanced.
+    double getLoadImbalance(const std::vector<Timing>& workerTimings) {
+        if (workerTimings.empty()) {
+            return 1;
+        }
+
+        double maxWallSeconds = 0;
+        double totalWallSeconds = 0;
+        for (const auto& timing: workerTimings) {
+            maxWallSeconds = std::max(maxWallSeconds, timing.wallSeconds);
+            totalWallSeconds += timing.wallSeconds;
+        }
+        const auto meanWallSeconds = totalWallSeconds / static_cast<double>(workerTimings.size());
+        return meanWallSeconds > 0 ? maxWallSeconds / meanWallSeconds : 1;
+    }
+
+    std::string getRollLabel(const size_t index) {
+        auto returnValue = std::to_string(index);
+        if (index == SearchStats::rejectionHistogramSize - 1) {
+            returnValue += '+';
+        }
+        return returnValue;
+    }
+
+    /// Sums of the events counted on every worker.
+    HardwareCounts getTotalHardwareCounts(const std::vector<HardwareCounts>& workerHardwareCounts) {
+        HardwareCounts returnValue{};
+        if (workerHardwareCounts.empty()) {
+            return returnValue;
+        }
+
+        returnValue.availableMask = workerHardwareCounts.front().availableMask;
+        for (const auto& counts: workerHardwareCounts) {
+            returnValue.availableMask &= counts.availableMask;
+            if (returnValue.error == 0) {
+                returnValue.error = counts.error;
+            }
+            for (size_t i = 0; i < HardwareCounts::eventsCount; i += 1) {
+                returnValue.values[i] += counts.values[i];
+            }
+        }
+        return returnValue;
+    }
+
+    double getInstructionsPerCycle(const HardwareCounts& counts) {
+        const auto cycles = counts.values[HardwareCounts::cycles];
+        return (cycles > 0) ? static_cast<double>(counts.values[HardwareCounts::instructions]) / static_cast<double>(cycles) : 0;
+    }
+
+    void printHardwareCounts(std::ostream& stream, const std::vector<HardwareCounts>& workerHardwareCounts, const uint64_t seedsEvaluated) {
+        const auto total = getTotalHardwareCounts(workerHardwareCounts);
+        if (total.availableMask == 0) {
+            stream << "  Hardware counters: Unavailable";
+            if (total.error != 0) {
+                stream << " (" << std::strerror(total.error) << ')';
+            }
+            stream << ". perf_event_open may be restricted by /proc/sys/kernel/perf_event_paranoid or a container's seccomp profile.\n";
+            return;
+        }
+
+        stream << "  Hardware counters (per seed evaluated):\n";
+        for (size_t i = 0; i < HardwareCounts::eventsCount; i += 1) {
+            const auto event = static_cast<HardwareCounts::Event>(i);
+            if (!total.isAvailable(event)) {
+                stream << "    " << HardwareCounts::eventNames[i] << ": Unavailable\n";
+                continue;
+            }
+            stream << "    " << HardwareCounts::eventNames[i] << ": " << static_cast<double>(total.values[i]) / static_cast<double>(std::max<uint64_t>(seedsEvaluated, 1)) << '\n';
+        }
+
+        if (total.isAvailable(HardwareCounts::cycles) && total.isAvailable(HardwareCounts::instructions)) {
+            stream << "    IPC: " << getInstructionsPerCycle(total) << " (workers:";
+            for (const auto& counts: workerHardwareCounts) {
+                stream << ' ' << getInstructionsPerCycle(counts);
+            }
+            stream << ")\n";
+        }
+    }
+
+    void writeMetricHeader(std::ostream& stream, const std::string& name, const std::string_view type, const std::string_view help) {
+        stream << "# HELP " << name << ' ' << help << '\n';
+        stream << "# TYPE " << name << ' ' << type << '\n';
+    }
+}
+
+
+void RunStats::addPhase(const std::string_view name, const Timing& timing) {
+    for (auto& phase: phases) {
+        if (phase.first == name) {
+            phase.second += timing;
+            return;
+        }
+    }
+    phases.emplace_back(name, timing);
+}
+
+
+#pragma mark - Print
+void RunStats::print(std::ostream& stream) const {
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream << std::fixed << std::setprecision(3);
+
+    stream << "Stats:\n";
+    stream << "  Phases (wall / CPU seconds):\n";
+    for (const auto& [name, timing]: phases) {
+        stream << "    " << std::left << std::setw(12) << name << std::right << timing.wallSeconds << " / " << timing.cpuSeconds << '\n';
+    }
+
+    if (search.seedsEvaluated > 0) {
+        stream << "  Search:\n";
+        stream << "    Seeds evaluated: " << search.seedsEvaluated << '\n';
+        stream << "    Seeds matched: " << search.seedsMatched << '\n';
+
+        stream << "    Rejected at roll:\n";
+        const auto evaluated = static_cast<double>(search.seedsEvaluated);
+        for (size_t i = 0; i < SearchStats::rejectionHistogramSize; i += 1) {
+            const auto count = search.rejectionHistogram[i];
+            if (count == 0) {
+                continue;
+            }
+            stream << "      " << std::setw(3) << getRollLabel(i) << ": " << count << " (" << std::setprecision(2) << static_cast<double>(count) / evaluated * 100 << "%)\n" << std::setprecision(3);
+        }
+
+        const auto drinkRolls = search.drinkHits + search.drinkMisses;
+        if (drinkRolls > 0) {
+            stream << "    Drink rolls: " << search.drinkHits << " hits, " << search.drinkMisses << " misses ("
+                   << std::setprecision(2) << static_cast<double>(search.drinkHits) / static_cast<double>(drinkRolls) * 100 << "% hits)\n" << std::setprecision(3);
+        }
+    }
+
+    if (!search.workerTimings.empty()) {
+        stream << "  Workers (wall / CPU seconds):\n";
+        for (size_t i = 0; i < search.workerTimings.size(); i += 1) {
+            const auto& timing = search.workerTimings[i];
+            stream << "    " << std::setw(3) << i << ": " << timing.wallSeconds << " / " << timing.cpuSeconds << '\n';
+        }
+        stream << "  Load imbalance (max / mean worker wall time): " << getLoadImbalance(search.workerTimings) << '\n';
+    }
+
+    if (search.countHardwareEvents) {
+        printHardwareCounts(stream, search.workerHardwareCounts, search.seedsEvaluated);
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+
+#pragma mark - Prometheus
+void RunStats::writePrometheus(const std::string& filename, const std::string_view program) const {
+    const auto temporaryFilename = filename + ".tmp";
+    {
+        std::ofstream stream{temporaryFilename, std::ios::trunc};
+        if (!stream) {
+            throw std::runtime_error("Failed to create stats file: " + temporaryFilename);
+        }
+        stream << std::setprecision(9);
+
+        const auto prefix = "splatoon_" + std::string{program} + '_';
+
+        auto name = prefix + "phase_wall_seconds";
+        writeMetricHeader(stream, name, "gauge", "Wall time of each phase.");
+        for (const auto& [phase, timing]: phases) {
+            stream << name << "{phase=\"" << phase << "\"} " << timing.wallSeconds << '\n';
+        }
+        name = prefix + "phase_cpu_seconds";
+        writeMetricHeader(stream, name, "gauge", "CPU time of each phase, including all threads.");
+        for (const auto& [phase, timing]: phases) {
+            stream << name << "{phase=\"" << phase << "\"} " << timing.cpuSeconds << '\n';
+        }
+
+        name = prefix + "seeds_evaluated_total";
+        writeMetricHeader(stream, name, "counter", "Initial seeds evaluated by the seed search.");
+        stream << name << ' ' << search.seedsEvaluated << '\n';
+        name = prefix + "seeds_matched_total";
+        writeMetricHeader(stream, name, "counter", "Initial seeds matching all rolls.");
+        stream << name << ' ' << search.seedsMatched << '\n';
+        name = prefix + "seeds_rejected_total";
+        writeMetricHeader(stream, name, "counter", "Initial seeds rejected, by the index of the first mismatching roll.");
+        for (size_t i = 0; i < SearchStats::rejectionHistogramSize; i += 1) {
+            stream << name << "{roll=\"" << getRollLabel(i) << "\"} " << search.rejectionHistogram[i] << '\n';
+        }
+        name = prefix + "drink_rolls_total";
+        writeMetricHeader(stream, name, "counter", "Rolls with a drink evaluated by the seed search, by whether the drink's ability was rolled directly.");
+        stream << name << "{result=\"hit\"} " << search.drinkHits << '\n';
+        stream << name << "{result=\"miss\"} " << search.drinkMisses << '\n';
+
+        name = prefix + "worker_wall_seconds";
+        writeMetricHeader(stream, name, "gauge", "Wall time of each seed search worker.");
+        for (size_t i = 0; i < search.workerTimings.size(); i += 1) {
+            stream << name << "{worker=\"" << i << "\"} " << search.workerTimings[i].wallSeconds << '\n';
+        }
+        name = prefix + "worker_cpu_seconds";
+        writeMetricHeader(stream, name, "gauge", "CPU time of each seed search worker.");
+        for (size_t i = 0; i < search.workerTimings.size(); i += 1) {
+            stream << name << "{worker=\"" << i << "\"} " << search.workerTimings[i].cpuSeconds << '\n';
+        }
+        if (!search.workerHardwareCounts.empty()) {
+            name = prefix + "worker_hardware_events_total";
+            writeMetricHeader(stream, name, "counter", "CPU events of each seed search worker (perf_event_open). Events that couldn't be counted are left out.");
+            for (size_t i = 0; i < search.workerHardwareCounts.size(); i += 1) {
+                const auto& counts = search.workerHardwareCounts[i];
+                for (size_t j = 0; j < HardwareCounts::eventsCount; j += 1) {
+                    if (counts.isAvailable(static_cast<HardwareCounts::Event>(j))) {
+                        stream << name << "{worker=\"" << i << "\",event=\"" << HardwareCounts::eventNames[j] << "\"} " << counts.values[j] << '\n';
+                    }
+                }
+            }
+        }
+
+        name = prefix + "load_imbalance";
+        writeMetricHeader(stream, name, "gauge", "Max over mean worker wall time. 1 is perfectly balanced.");
+        stream << name << ' ' << getLoadImbalance(search.workerTimings) << '\n';
+
+        stream.flush();
+        if (!stream) {
+            throw std::runtime_error("Failed to write stats file: " + temporaryFilename);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryFilename, filename, error);
+    if (error) {
+        throw std::runtime_error("Failed to write stats file: " + filename);
+    }
+}
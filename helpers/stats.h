@@ -0,0 +1,197 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_STATS_H
+#define SPLATOON_3_GEAR_HELPER_CPP_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <time.h>
+
+#include "hardware_counters.h"
+#include "trace.h"
+
+
+#pragma mark - Timing
+/// Wall and CPU time in seconds.
+struct Timing {
+    double wallSeconds = 0;
+    double cpuSeconds = 0;
+
+    Timing& operator+=(const Timing& other) {
+        wallSeconds += other.wallSeconds;
+        cpuSeconds += other.cpuSeconds;
+        return *this;
+    }
+};
+
+/// Measures wall time, and CPU time of the process (default) or the current thread (`CLOCK_THREAD_CPUTIME_ID`).
+class Stopwatch {
+private:
+    std::chrono::steady_clock::time_point wallStart;
+    clockid_t cpuClock;
+    double cpuStart;
+
+    static double getCpuSeconds(const clockid_t clock) {
+        timespec time{};
+        ::clock_gettime(clock, &time);
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+    }
+
+public:
+    explicit Stopwatch(const clockid_t cpuClock = CLOCK_PROCESS_CPUTIME_ID): wallStart{std::chrono::steady_clock::now()}, cpuClock{cpuClock}, cpuStart{getCpuSeconds(cpuClock)} {}
+
+    [[nodiscard]] Timing getElapsed() const {
+        const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - wallStart;
+        return Timing{wallTime.count(), getCpuSeconds(cpuClock) - cpuStart};
+    }
+};
+
+
+#pragma mark - Search counters
+/**
+ * Hot path counters of `SeedHelper::findSeed`.
+ *
+ * Each worker counts into its own instance (no sharing between threads), and the results are merged at the end.
+ */
+struct SearchStats {
+    /// Workers only count if this is true (see `NoSearchStats`).
+    static constexpr bool isEnabled = true;
+
+    /// Rejections at this roll index or later share the last bucket.
+    static constexpr size_t rejectionHistogramSize = 16;
+
+    uint64_t seedsEvaluated = 0;
+    uint64_t seedsMatched = 0;
+    /// Index `i`: Seeds rejected at roll `i` (the 1st roll that doesn't match).
+    std::array<uint64_t, rejectionHistogramSize> rejectionHistogram{};
+
+    /// Rolls with a (single, known) drink where the drink's ability was rolled directly (30% chance).
+    uint64_t drinkHits = 0;
+    /// Rolls with a drink where the drink's weights were used instead.
+    uint64_t drinkMisses = 0;
+
+    /// Each worker's time (each chunk's with `SearchConfiguration::chunksPerWorker` > 1), in range order.
+    std::vector<Timing> workerTimings{};
+
+    /// Set before searching to also count CPU events in each worker (`--hw-counters`).
+    bool countHardwareEvents = false;
+    /// Each worker's (or chunk's) CPU events, in range order. Empty unless `countHardwareEvents`.
+    std::vector<HardwareCounts> workerHardwareCounts{};
+
+    void countRejection(const size_t rollIndex) {
+        rejectionHistogram[std::min(rollIndex, rejectionHistogramSize - 1)] += 1;
+    }
+
+    SearchStats& operator+=(const SearchStats& other) {
+        seedsEvaluated += other.seedsEvaluated;
+        seedsMatched += other.seedsMatched;
+        for (size_t i = 0; i < rejectionHistogramSize; i += 1) {
+            rejectionHistogram[i] += other.rejectionHistogram[i];
+        }
+        drinkHits += other.drinkHits;
+        drinkMisses += other.drinkMisses;
+        workerTimings.insert(workerTimings.end(), other.workerTimings.begin(), other.workerTimings.end());
+        workerHardwareCounts.insert(workerHardwareCounts.end(), other.workerHardwareCounts.begin(), other.workerHardwareCounts.end());
+        return *this;
+    }
+};
+
+/// Counters for searches without `--stats`: Counting code is compiled out.
+struct NoSearchStats {
+    static constexpr bool isEnabled = false;
+};
+
+
+#pragma mark - Run stats
+/**
+ * Phase timing and search counters of a `find` or `predict` run, collected with `--stats` or `--stats-prometheus`.
+ *
+ * When disabled, nothing is measured.
+ */
+class RunStats {
+public:
+    /// Records its time on `stop` or destruction. Also a trace event with `--trace`.
+    class Phase {
+    private:
+        RunStats* stats;
+        std::string_view name;
+        Stopwatch stopwatch;
+        bool traced;
+
+    public:
+        Phase(RunStats* stats, const std::string_view name): stats{stats}, name{name}, stopwatch{}, traced{Trace::isEnabled()} {
+            if (traced) {
+                Trace::begin(name);
+            }
+        }
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+        void stop() {
+            if (stats != nullptr) {
+                stats->addPhase(name, stopwatch.getElapsed());
+                stats = nullptr;
+            }
+            if (traced) {
+                Trace::end(name);
+                traced = false;
+            }
+        }
+
+        ~Phase() {
+            stop();
+        }
+    };
+
+private:
+    bool enabled;
+    /// In order of first occurrence. Phases with the same name are added up.
+    std::vector<std::pair<std::string, Timing>> phases;
+    SearchStats search;
+
+    void addPhase(std::string_view name, const Timing& timing);
+
+public:
+    explicit RunStats(const bool enabled): enabled{enabled}, phases{}, search{} {}
+
+    [[nodiscard]] bool isEnabled() const {
+        return enabled;
+    }
+
+    /// Time a phase until `Phase::stop` or the end of the scope. `name` must be a string literal (see `Trace`).
+    [[nodiscard]] Phase startPhase(const std::string_view name) {
+        return Phase{enabled ? this : nullptr, name};
+    }
+
+    /// Count CPU events in search workers. Only if enabled.
+    void enableHardwareCounters() {
+        search.countHardwareEvents = enabled;
+    }
+
+    /// For `SeedHelper::findSeed`. `nullptr` if disabled.
+    [[nodiscard]] SearchStats* getSearchStats() {
+        return enabled ? &search : nullptr;
+    }
+
+    /// Human readable summary.
+    void print(std::ostream& stream) const;
+
+    /**
+     * Write a Prometheus text file (e.g. for the node exporter's textfile collector).
+     *
+     * Written to a temporary file first, then renamed, so the collector never reads partial files.
+     *
+     * @param program Metric name prefix: `splatoon_<program>_`.
+     * @throws std::runtime_error if the file can't be written.
+     */
+    void writePrometheus(const std::string& filename, std::string_view program) const;
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_STATS_H
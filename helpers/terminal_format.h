@@ -6,19 +6,54 @@
 #define TERMINAL_FORMAT_H
 
 #include <iostream>
+#include <string_view>
+
+#include <unistd.h>
 
 namespace TerminalFormat {
     using namespace std::literals;
 
-    constexpr auto HEADER = "\033[95m"sv;
-    constexpr auto OK_BLUE = "\033[94m"sv;
-    constexpr auto OK_CYAN = "\033[96m"sv;
-    constexpr auto OK_GREEN = "\033[92m"sv;
-    constexpr auto WARNING = "\033[93m"sv;
-    constexpr auto FAIL = "\033[91m"sv;
-    constexpr auto ENDC = "\033[0m"sv;
-    constexpr auto BOLD = "\033[1m"sv;
-    constexpr auto UNDERLINE = "\033[4m"sv;
+    /// Styles are only written when stdout is a terminal, so that piped output has no escape codes.
+    inline bool isEnabled() {
+        static const bool enabled = isatty(STDOUT_FILENO);
+        return enabled;
+    }
+
+    /// Same for stderr (e.g. warnings), which may be a terminal while stdout is piped, or the other way around.
+    inline bool isErrorEnabled() {
+        static const bool enabled = isatty(STDERR_FILENO);
+        return enabled;
+    }
+
+    struct Code {
+        std::string_view value;
+
+        /// `value` if styles are enabled, or an empty string.
+        [[nodiscard]] std::string_view get() const {
+            return isEnabled() ? value : std::string_view{};
+        }
+
+        /// `value` if styles are enabled on stderr, or an empty string.
+        [[nodiscard]] std::string_view getError() const {
+            return isErrorEnabled() ? value : std::string_view{};
+        }
+    };
+
+    /// `std::cerr` and `std::clog` check stderr. Other streams (e.g. string streams) end up on stdout.
+    inline std::ostream& operator<<(std::ostream& stream, const Code code) {
+        const auto isError = (&stream == &std::cerr) || (&stream == &std::clog);
+        return stream << (isError ? code.getError() : code.get());
+    }
+
+    constexpr Code HEADER{"\033[95m"sv};
+    constexpr Code OK_BLUE{"\033[94m"sv};
+    constexpr Code OK_CYAN{"\033[96m"sv};
+    constexpr Code OK_GREEN{"\033[92m"sv};
+    constexpr Code WARNING{"\033[93m"sv};
+    constexpr Code FAIL{"\033[91m"sv};
+    constexpr Code ENDC{"\033[0m"sv};
+    constexpr Code BOLD{"\033[1m"sv};
+    constexpr Code UNDERLINE{"\033[4m"sv};
 }
 
 #endif //TERMINAL_FORMAT_H
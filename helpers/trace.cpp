@@ -0,0 +1,108 @@
+#include "trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+namespace Trace {
+    namespace {
+        struct Event {
+            std::string_view name;
+            /// Nanoseconds since `enable`.
+            int64_t timestamp;
+            int64_t argument;
+            /// `B` or `E`.
+            char phase;
+        };
+
+        /// Written by its thread only.
+        struct ThreadBuffer {
+            size_t threadIndex;
+            std::unique_ptr<Event[]> events;
+            /// Events ever recorded. The latest `threadCapacity` are kept.
+            std::atomic<uint64_t> count;
+
+            explicit ThreadBuffer(const size_t threadIndex): threadIndex{threadIndex}, events{new Event[threadCapacity]}, count{0} {}
+        };
+
+        std::mutex buffersMutex{};
+        /// Outlive their threads (e.g. `std::async` workers), until the process exits.
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers{};
+        std::chrono::steady_clock::time_point startTime{};
+
+        ThreadBuffer* registerThread() {
+            const std::lock_guard lock{buffersMutex};
+            buffers.push_back(std::make_unique<ThreadBuffer>(buffers.size()));
+            return buffers.back().get();
+        }
+    }
+
+    void Internal::record(const std::string_view name, const char phase, const int64_t argument) {
+        thread_local ThreadBuffer* const buffer = registerThread();
+
+        const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        const auto count = buffer->count.load(std::memory_order_relaxed);
+        buffer->events[count % threadCapacity] = Event{name, timestamp, argument, phase};
+        buffer->count.store(count + 1, std::memory_order_release);
+    }
+
+    void enable() {
+        startTime = std::chrono::steady_clock::now();
+        Internal::enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        Internal::enabled.store(false, std::memory_order_relaxed);
+
+        // Buffers stay registered to their threads.
+        const std::lock_guard lock{buffersMutex};
+        for (const auto& buffer: buffers) {
+            buffer->count.store(0, std::memory_order_release);
+        }
+    }
+
+    void write(const std::string& filename) {
+        std::ofstream stream{filename, std::ios::trunc};
+        if (!stream) {
+            throw std::runtime_error("Failed to create trace file: " + filename);
+        }
+        stream << std::fixed << std::setprecision(3);
+
+        const std::lock_guard lock{buffersMutex};
+        stream << "{\"traceEvents\":[\n";
+        auto first = true;
+        for (const auto& buffer: buffers) {
+            const auto count = buffer->count.load(std::memory_order_acquire);
+            if (count == 0) {
+                continue;
+            }
+
+            // The 1st thread to record is the main thread.
+            const auto threadName = (buffer->threadIndex == 0) ? std::string{"main"} : "worker " + std::to_string(buffer->threadIndex);
+            stream << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->threadIndex << R"(,"args":{"name":")" << threadName << "\"}}";
+            first = false;
+
+            const auto oldest = (count > threadCapacity) ? count - threadCapacity : 0;
+            for (auto i = oldest; i < count; i += 1) {
+                const auto& event = buffer->events[i % threadCapacity];
+                stream << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << static_cast<double>(event.timestamp) / 1000
+                       << ",\"pid\":1,\"tid\":" << buffer->threadIndex;
+                if (event.argument >= 0) {
+                    stream << ",\"args\":{\"value\":" << event.argument << '}';
+                }
+                stream << '}';
+            }
+        }
+        stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        stream.flush();
+        if (!stream) {
+            throw std::runtime_error("Failed to write trace file: " + filename);
+        }
+    }
+}
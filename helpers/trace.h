@@ -0,0 +1,88 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_TRACE_H
+#define SPLATOON_3_GEAR_HELPER_CPP_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/**
+ * Opt-in timeline of phases and worker chunks (`--trace`), written as Chrome trace event JSON (chrome://tracing, Perfetto).
+ *
+ * - Disabled (default): Each event is a single relaxed atomic load, so tracing stays compiled in
+ * - Enabled: Each thread writes to its own fixed size ring buffer (no locks after the thread's first event). The oldest events are overwritten when full
+ *
+ * Event names must be string literals (they're stored as views).
+ */
+namespace Trace {
+    /// Events kept per thread.
+    constexpr size_t threadCapacity = 1 << 14;
+
+    namespace Internal {
+        inline std::atomic<bool> enabled{false};
+
+        void record(std::string_view name, char phase, int64_t argument);
+    }
+
+    [[nodiscard]] inline bool isEnabled() {
+        return Internal::enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Start recording. Timestamps are relative to this call.
+    void enable();
+
+    /**
+     * Stop recording and drop all recorded events (e.g. between tests in 1 process).
+     *
+     * Call after all traced workers have finished.
+     */
+    void reset();
+
+    /**
+     * Write all recorded events as Chrome trace JSON. Threads without events are skipped.
+     *
+     * Call after all traced workers have finished.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
+    void write(const std::string& filename);
+
+    /// Begin event. `argument` is shown in the event's args if not negative.
+    inline void begin(const std::string_view name, const int64_t argument = -1) {
+        if (isEnabled()) {
+            Internal::record(name, 'B', argument);
+        }
+    }
+
+    inline void end(const std::string_view name) {
+        if (isEnabled()) {
+            Internal::record(name, 'E', -1);
+        }
+    }
+
+    /// Begin and end events for a scope.
+    class Scope {
+    private:
+        std::string_view name;
+        bool traced;
+
+    public:
+        explicit Scope(const std::string_view name, const int64_t argument = -1): name{name}, traced{isEnabled()} {
+            if (traced) {
+                Internal::record(name, 'B', argument);
+            }
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            if (traced) {
+                Internal::record(name, 'E', -1);
+            }
+        }
+    };
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_TRACE_H
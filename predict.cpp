@@ -1,21 +1,46 @@
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <optional>
 #include <string_view>
 #include <set>
+#include <thread>
 
 #include "yaml/yaml_helper.h"
 #include "seed_helper.h"
+#include "search_profile.h"
+#include "binary/roll_journal.h"
+#include "helpers/output_buffer.h"
+#include "helpers/stats.h"
+#include "helpers/trace.h"
 #include "helpers/terminal_format.h"
+#include "prediction/drink_advisor.h"
+#include "prediction/candidate_prediction.h"
+#include "prediction/drink_planner.h"
+#include "prediction/build_planner.h"
+#include "prediction/seed_resync.h"
+#include "prediction/streak_scanner.h"
+#include "prediction/pattern_matcher.h"
 
 
-/// (has streak, in streak, streak abilities)
+/// (streak abilities, in streak)
 std::pair<std::set<Ability>, std::vector<bool>> findThreeStreaks(const std::vector<Ability>& rolls) {
+    // Pattern index: Ability index.
+    static const PatternMatcher threeStreakMatcher = []() {
+        std::vector<PatternMatcher::Pattern> patterns{};
+        for (size_t i = 0; i < AbilityHelper::abilitiesCount; i += 1) {
+            patterns.push_back(PatternMatcher::makeStreakPattern(static_cast<Ability>(i), 3));
+        }
+        return PatternMatcher{patterns};
+    }();
+
     std::set<Ability> threeStreakAbilities{};
     std::vector<bool> inThreeStreak(rolls.size(), false);
-    for (size_t i = 2; i < rolls.size(); i += 1) {
-        if ((rolls[i - 2] == rolls[i]) && (rolls[i - 1] == rolls[i])) {
-            threeStreakAbilities.insert(rolls[i]);
-            inThreeStreak[i - 2] = true;
-            inThreeStreak[i - 1] = true;
+    for (const auto [patternIndex, start]: threeStreakMatcher.findMatches(rolls)) {
+        threeStreakAbilities.insert(static_cast<Ability>(patternIndex));
+        for (size_t i = start; i < start + 3; i += 1) {
             inThreeStreak[i] = true;
         }
     }
@@ -24,64 +49,546 @@ std::pair<std::set<Ability>, std::vector<bool>> findThreeStreaks(const std::vect
 }
 
 
+/// A gear with a known initial seed, replayed to the end of its logged rolls.
+struct Gear {
+    std::string name;
+    std::string brand;
+    uint32_t initialSeed;
+    uint32_t finalSeed;
+    /// Built (and timed) once by `loadGear`, for the replay and the predictions.
+    SeedHelper seedHelper;
+};
+
+
+/**
+ * Load a YAML file, or a roll journal (replayed from its last checkpoint).
+ * Verifies the initial seed against the logged rolls.
+ */
+Gear loadGear(std::string_view filename, RunStats& stats) {
+    const auto noInitialSeedMessage = "No initial seed in file. Use `--candidates` to predict with all matching seeds.";
+    const auto invalidSeedMessage = "The initial seed doesn't match the roll sequence. Use `--resync N` to search for up to N unlogged rolls or drinks.";
+
+    auto loadPhase = stats.startPhase("load");
+    if (std::filesystem::path{filename}.extension() == RollJournal::extension) {
+        RollJournal journal{filename};
+        loadPhase.stop();
+        if (!journal.getInitialSeed().has_value()) {
+            throw std::runtime_error(noInitialSeedMessage);
+        }
+
+        auto tablesPhase = stats.startPhase("tables");
+        SeedHelper seedHelper{journal.getBrand()};
+        tablesPhase.stop();
+
+        auto replayPhase = stats.startPhase("replay");
+        const auto [valid, finalSeed] = journal.advanceToEnd(seedHelper);
+        replayPhase.stop();
+        if (!valid) {
+            throw std::runtime_error(invalidSeedMessage);
+        }
+        return Gear{std::string{journal.getName()}, std::string{journal.getBrand()}, journal.getInitialSeed().value(), finalSeed, std::move(seedHelper)};
+    }
+
+    YamlFile yamlFile(filename);
+    loadPhase.stop();
+    if (!yamlFile.getInitialSeed().has_value()) {
+        throw std::runtime_error(noInitialSeedMessage);
+    }
+
+    auto tablesPhase = stats.startPhase("tables");
+    SeedHelper seedHelper{yamlFile.getBrand()};
+    tablesPhase.stop();
+
+    auto replayPhase = stats.startPhase("replay");
+    const auto [valid, finalSeed] = seedHelper.advanceSeedToEndOfRollSequence(yamlFile.getInitialSeed().value(), yamlFile.getRollSequence());
+    replayPhase.stop();
+    if (!valid) {
+        throw std::runtime_error(invalidSeedMessage);
+    }
+    return Gear{std::string{yamlFile.getName()}, std::string{yamlFile.getBrand()}, yamlFile.getInitialSeed().value(), finalSeed, std::move(seedHelper)};
+}
+
+
+void printGearInformation(const Gear& gear) {
+    std::cout << gear.name << "\n";
+    std::cout << "Brand: " << gear.brand << "\n";
+    std::cout << std::hex << "Initial seed: 0x" << gear.initialSeed << " -> Final seed: 0x" << gear.finalSeed << std::dec << std::endl;
+}
+
+
+#pragma mark - Future rolls
+/// Rolls for no drink and each drink. Indices: `AbilityHelper::getDrinkChoice`.
+using FutureRolls = std::array<std::vector<Ability>, AbilityHelper::drinkChoicesCount>;
+
+/// Drink ID for machine-readable formats.
+std::string_view getDrinkId(const Ability drink) {
+    return (drink == Ability::noDrink) ? "none" : AbilityHelper::getId(drink);
+}
+
+
 /// Print and highlight 3-streaks.
-void printRollsWithEmphasis(const std::string_view title, const std::vector<Ability>& rolls) {
+void renderRollsWithEmphasis(OutputBuffer& output, const std::string_view title, const std::vector<Ability>& rolls) {
     const auto [streakAbilities, inStreak] = findThreeStreaks(rolls);
 
     // Title.
-    std::cout << TerminalFormat::BOLD << title << TerminalFormat::ENDC << "\n";
+    output << TerminalFormat::BOLD << title << TerminalFormat::ENDC << '\n';
     if (!streakAbilities.empty()) {
-        std::cout << "Streak abilities: ";
+        output << "Streak abilities: ";
         for (const auto streakAbility: streakAbilities) {
-            std::cout << TerminalFormat::BOLD << TerminalFormat::OK_GREEN << AbilityHelper::getId(streakAbility) << TerminalFormat::ENDC << " ";
+            output << TerminalFormat::BOLD << TerminalFormat::OK_GREEN << AbilityHelper::getId(streakAbility) << TerminalFormat::ENDC << ' ';
         }
-        std::cout << "\n";
+        output << '\n';
     }
 
     // Rolls.
     for (size_t i = 0; i < rolls.size(); i += 1) {
-        std::cout << i << ". ";
+        output << i << ". ";
 
         const auto abilityId = AbilityHelper::getId(rolls[i]);
         if (inStreak[i]) {
-            std::cout << TerminalFormat::BOLD << abilityId << TerminalFormat::ENDC << "\n";
+            output << TerminalFormat::BOLD << abilityId << TerminalFormat::ENDC << '\n';
+        } else {
+            output << abilityId << '\n';
+        }
+    }
+    output << '\n';
+}
+
+
+void renderFutureRollsText(OutputBuffer& output, const Gear& gear, const FutureRolls& futureRolls) {
+    output << gear.name << '\n';
+    output << "Brand: " << gear.brand << '\n';
+    output << "Initial seed: ";
+    output.appendHex(gear.initialSeed) << " -> Final seed: ";
+    output.appendHex(gear.finalSeed) << '\n';
+
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        std::string title{"No drink:"};
+        if (drink != Ability::noDrink) {
+            title = "Drink: ";
+            title += AbilityHelper::getId(drink);
+        }
+
+        renderRollsWithEmphasis(output, title, futureRolls[i]);
+    }
+}
+
+
+/**
+ * ```
+ * {"name": ..., "brand": ..., "initial_seed": ..., "final_seed": ...,
+ *  "predictions": [{"drink": "none" | ability ID, "rolls": [ability ID...], "streak_abilities": [ability ID...]}...]}
+ * ```
+ */
+void renderFutureRollsJson(OutputBuffer& output, const Gear& gear, const FutureRolls& futureRolls) {
+    output << "{\"name\":";
+    output.appendJsonString(gear.name) << ",\"brand\":";
+    output.appendJsonString(gear.brand) << ",\"initial_seed\":" << gear.initialSeed << ",\"final_seed\":" << gear.finalSeed << ",\"predictions\":[";
+
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto& rolls = futureRolls[i];
+        const auto streakAbilities = findThreeStreaks(rolls).first;
+
+        output << ((i == 0) ? "{\"drink\":\"" : ",{\"drink\":\"") << getDrinkId(AbilityHelper::getDrinkChoice(i)) << "\",\"rolls\":[";
+        for (size_t j = 0; j < rolls.size(); j += 1) {
+            output << ((j == 0) ? "\"" : ",\"") << AbilityHelper::getId(rolls[j]) << '"';
+        }
+        output << "],\"streak_abilities\":[";
+        for (auto it = streakAbilities.begin(); it != streakAbilities.end(); it++) {
+            output << ((it == streakAbilities.begin()) ? "\"" : ",\"") << AbilityHelper::getId(*it) << '"';
+        }
+        output << "]}";
+    }
+    output << "]}\n";
+}
+
+
+/// Columns: drink, roll index, ability, in 3-streak (0/1).
+void renderFutureRollsTsv(OutputBuffer& output, const FutureRolls& futureRolls) {
+    output << "drink\troll\tability\tin_streak\n";
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drinkId = getDrinkId(AbilityHelper::getDrinkChoice(i));
+        const auto& rolls = futureRolls[i];
+        const auto inStreak = findThreeStreaks(rolls).second;
+
+        for (size_t j = 0; j < rolls.size(); j += 1) {
+            output << drinkId << '\t' << j << '\t' << AbilityHelper::getId(rolls[j]) << '\t' << (inStreak[j] ? '1' : '0') << '\n';
+        }
+    }
+}
+
+
+/**
+ * Little endian:
+ *
+ * - Magic: `S3GP`
+ * - uint32: Initial seed
+ * - uint32: Final seed
+ * - uint8: Drink choices count (15)
+ * - uint16: Rolls per drink choice
+ * - Each drink choice: uint8 drink (`Ability` value, 15 for no drink), then 1 uint8 `Ability` value per roll
+ */
+void renderFutureRollsBinary(OutputBuffer& output, const Gear& gear, const FutureRolls& futureRolls) {
+    output << "S3GP";
+    output.appendBinary(gear.initialSeed);
+    output.appendBinary(gear.finalSeed);
+    output.appendBinary(static_cast<uint8_t>(AbilityHelper::drinkChoicesCount));
+    output.appendBinary(static_cast<uint16_t>(futureRolls[0].size()));
+
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        output.appendBinary(static_cast<uint8_t>(AbilityHelper::getDrinkChoice(i)));
+        for (const auto ability: futureRolls[i]) {
+            output.appendBinary(static_cast<uint8_t>(ability));
+        }
+    }
+}
+
+
+void printFutureRolls(std::string_view filename, const OutputFormat format, RunStats& stats) {
+    constexpr size_t length = 15;
+
+    auto gear = loadGear(filename, stats);
+    auto& seedHelper = gear.seedHelper;
+    const auto finalSeed = gear.finalSeed;
+
+    auto predictPhase = stats.startPhase("predict");
+    FutureRolls futureRolls{};
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        futureRolls[i] = (drink == Ability::noDrink) ? seedHelper.generateRolls(finalSeed, length) : seedHelper.generateRollsWithDrink(finalSeed, drink, length);
+    }
+    predictPhase.stop();
+
+    const auto outputPhase = stats.startPhase("output");
+    // Written at once when `output` is destroyed.
+    OutputBuffer output{};
+    switch (format) {
+        case OutputFormat::text:
+            renderFutureRollsText(output, gear, futureRolls);
+            break;
+        case OutputFormat::json:
+            renderFutureRollsJson(output, gear, futureRolls);
+            break;
+        case OutputFormat::tsv:
+            renderFutureRollsTsv(output, futureRolls);
+            break;
+        case OutputFormat::binary:
+            renderFutureRollsBinary(output, gear, futureRolls);
+            break;
+    }
+}
+
+
+#pragma mark - Other predictions
+/// Print the cheapest drink plan that reaches a `streakLength`-streak of `target`.
+void printDrinkPlan(std::string_view filename, const Ability target, const size_t streakLength, const size_t horizon, const DrinkPlanner::Objective objective, RunStats& stats) {
+    auto gear = loadGear(filename, stats);
+    auto& seedHelper = gear.seedHelper;
+    const auto finalSeed = gear.finalSeed;
+    printGearInformation(gear);
+
+    auto predictPhase = stats.startPhase("predict");
+    const auto plan = DrinkPlanner::findPlan(seedHelper, finalSeed, target, streakLength, horizon, objective);
+    predictPhase.stop();
+    if (!plan.has_value()) {
+        std::cout << "No " << streakLength << "-streak of " << AbilityHelper::getId(target) << " within " << horizon << " rolls." << std::endl;
+        return;
+    }
+
+    std::cout << TerminalFormat::BOLD << "Plan: " << plan->steps.size() << " rolls, " << plan->drinksCount << " drinks" << TerminalFormat::ENDC << "\n";
+    for (size_t i = 0; i < plan->steps.size(); i += 1) {
+        const auto& [drink, ability, seed] = plan->steps[i];
+        std::cout << i << ". " << ((drink == Ability::noDrink) ? "no drink" : AbilityHelper::getId(drink)) << " -> ";
+        if (ability == target) {
+            std::cout << TerminalFormat::BOLD << AbilityHelper::getId(ability) << TerminalFormat::ENDC << "\n";
         } else {
-            std::cout << abilityId << "\n";
+            std::cout << AbilityHelper::getId(ability) << "\n";
+        }
+    }
+    std::cout << std::flush;
+}
+
+
+/**
+ * Print the build plans that reach a streak on every piece, for which no other build plan needs both fewer rolls and fewer drinks.
+ *
+ * @param pieces (filename, target) per piece.
+ */
+void printBuildPlans(const std::vector<std::pair<std::string_view, Ability>>& pieces, const size_t horizon, const size_t streakLength, RunStats& stats) {
+    std::vector<Gear> gears{};
+    std::vector<BuildPlanner::Piece> buildPieces{};
+    for (const auto& [filename, target]: pieces) {
+        gears.push_back(loadGear(filename, stats));
+        buildPieces.push_back(BuildPlanner::Piece{gears.back().brand, gears.back().finalSeed, target, streakLength});
+        printGearInformation(gears.back());
+    }
+
+    // Fronts of earlier runs.
+    BuildPlanner::Planner planner{horizon};
+    const auto cacheFilename = BuildPlanner::Planner::getDefaultFilename();
+    if (!cacheFilename.empty()) {
+        try {
+            planner.load(cacheFilename);
+        } catch (const std::runtime_error& error) {
+            std::cerr << TerminalFormat::WARNING << error.what() << " Ignoring it." << TerminalFormat::ENDC << std::endl;
         }
     }
-    std::cout << std::endl;
+
+    auto predictPhase = stats.startPhase("predict");
+    const auto buildPlans = planner.findPlans(buildPieces, std::thread::hardware_concurrency());
+    predictPhase.stop();
+    std::cout << "Pieces searched: " << planner.getSearchedFrontsCount() << " (others from " << (cacheFilename.empty() ? "memory" : cacheFilename) << ")" << std::endl;
+
+    if ((planner.getSearchedFrontsCount() > 0) && !cacheFilename.empty()) {
+        try {
+            planner.save(cacheFilename);
+        } catch (const std::runtime_error& error) {
+            std::cerr << TerminalFormat::WARNING << error.what() << TerminalFormat::ENDC << std::endl;
+        }
+    }
+    if (buildPlans.empty()) {
+        std::cout << "No build plan within " << horizon << " rolls per piece." << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < buildPlans.size(); i += 1) {
+        const auto& [rollsCount, drinksCount, plans] = buildPlans[i];
+        std::cout << TerminalFormat::BOLD << "\nBuild plan " << (i + 1) << ": " << rollsCount << " rolls, " << drinksCount << " drinks" << TerminalFormat::ENDC << "\n";
+        for (size_t j = 0; j < plans.size(); j += 1) {
+            const auto target = buildPieces[j].target;
+            std::cout << gears[j].name << " (" << streakLength << " " << AbilityHelper::getId(target) << "): " << plans[j].steps.size() << " rolls, " << plans[j].drinksCount << " drinks\n";
+            for (size_t k = 0; k < plans[j].steps.size(); k += 1) {
+                const auto& [drink, ability, seed] = plans[j].steps[k];
+                std::cout << "  " << k << ". " << ((drink == Ability::noDrink) ? "no drink" : AbilityHelper::getId(drink)) << " -> ";
+                if (ability == target) {
+                    std::cout << TerminalFormat::BOLD << AbilityHelper::getId(ability) << TerminalFormat::ENDC << "\n";
+                } else {
+                    std::cout << AbilityHelper::getId(ability) << "\n";
+                }
+            }
+        }
+    }
+    std::cout << std::flush;
+}
+
+
+/**
+ * Print the ways the known seed can still explain the logged rolls, with a few unlogged rolls or drinks.
+ * Searches from the last verified seed: A journal's last checkpoint, or the initial seed.
+ */
+void printResyncAlignments(std::string_view filename, const size_t maxEditsCount, RunStats& stats) {
+    // Printed alignments. The rest are only counted.
+    constexpr size_t maxPrintedCount = 10;
+
+    auto loadPhase = stats.startPhase("load");
+    std::string brand{};
+    std::optional<uint32_t> initialSeed{};
+    RollSequence rollSequence{};
+    size_t startIndex = 0;
+    if (std::filesystem::path{filename}.extension() == RollJournal::extension) {
+        const RollJournal journal{filename, RollJournal::OpenMode::readOnly};
+        brand = journal.getBrand();
+        initialSeed = journal.getInitialSeed();
+        rollSequence = journal.getRollSequence();
+        if (journal.getLastCheckpoint().has_value()) {
+            startIndex = journal.getLastCheckpoint()->rollsCount;
+            initialSeed = journal.getLastCheckpoint()->seed;
+        }
+    } else {
+        YamlFile yamlFile(filename);
+        brand = yamlFile.getBrand();
+        initialSeed = yamlFile.getInitialSeed();
+        rollSequence = yamlFile.getRollSequence();
+    }
+    loadPhase.stop();
+    if (!initialSeed.has_value()) {
+        throw std::runtime_error("No initial seed in file. Use `find` to search all seeds.");
+    }
+
+    auto tablesPhase = stats.startPhase("tables");
+    SeedHelper seedHelper{brand};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    tablesPhase.stop();
+
+    auto predictPhase = stats.startPhase("predict");
+    RollSequence remainingRolls{};
+    for (auto it = rollSequence.begin() + static_cast<std::ptrdiff_t>(startIndex); it != rollSequence.end(); it++) {
+        remainingRolls.addRoll(it->first, it->second);
+    }
+    const auto verifiedRollsCount = startIndex + SeedResync::getVerifiedRollsCount(seedHelper, initialSeed.value(), remainingRolls);
+    const auto alignments = (verifiedRollsCount == rollSequence.size()) ? std::vector<SeedResync::Alignment>{} : SeedResync::findAlignments(seedHelper, initialSeed.value(), rollSequence, startIndex, maxEditsCount);
+    predictPhase.stop();
+
+    std::cout << std::hex << "Seed 0x" << initialSeed.value() << std::dec << " (before roll " << startIndex << ") matches " << verifiedRollsCount << " of " << rollSequence.size() << " rolls." << std::endl;
+    if (verifiedRollsCount == rollSequence.size()) {
+        return;
+    }
+    if (alignments.empty()) {
+        std::cout << "No alignment within " << maxEditsCount << " unlogged rolls or drinks. Use `find` to search all seeds." << std::endl;
+        return;
+    }
+
+    std::cout << TerminalFormat::BOLD << "Alignments within " << maxEditsCount << " unlogged rolls or drinks: " << alignments.size() << TerminalFormat::ENDC << "\n";
+    for (size_t i = 0; (i < alignments.size()) && (i < maxPrintedCount); i += 1) {
+        const auto& [finalSeed, edits] = alignments[i];
+        std::cout << i << ". " << std::hex << "Final seed: 0x" << finalSeed << std::dec << "\n";
+        for (const auto& [kind, rollIndex]: edits) {
+            std::cout << "  " << ((kind == SeedResync::EditKind::unloggedRoll) ? "Unlogged roll before roll " : "Other drink at roll ") << rollIndex << "\n";
+        }
+    }
+    if (alignments.size() > maxPrintedCount) {
+        std::cout << "(" << (alignments.size() - maxPrintedCount) << " more)\n";
+    }
+    std::cout << std::flush;
+}
+
+
+/// Print how many rolls until the first streak of each ability, for no drink and each drink.
+void printFirstStreaks(std::string_view filename, const size_t length, const size_t streakLength, RunStats& stats) {
+    auto gear = loadGear(filename, stats);
+    auto& seedHelper = gear.seedHelper;
+    const auto finalSeed = gear.finalSeed;
+    printGearInformation(gear);
+
+    auto predictPhase = stats.startPhase("predict");
+    const auto firstStreaks = StreakScanner::findFirstStreaksForAllDrinks(seedHelper, finalSeed, length, streakLength, std::thread::hardware_concurrency());
+    predictPhase.stop();
+
+    std::cout << "First " << streakLength << "-streak start within " << length << " rolls:\n";
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        std::cout << TerminalFormat::BOLD << ((drink == Ability::noDrink) ? "No drink" : AbilityHelper::getId(drink)) << TerminalFormat::ENDC << ": ";
+
+        // Soonest first.
+        std::vector<std::pair<size_t, Ability>> sortedStreaks{};
+        for (size_t j = 0; j < AbilityHelper::abilitiesCount; j += 1) {
+            sortedStreaks.emplace_back(firstStreaks[i][j], static_cast<Ability>(j));
+        }
+        std::sort(sortedStreaks.begin(), sortedStreaks.end());
+
+        for (const auto [position, ability]: sortedStreaks) {
+            std::cout << AbilityHelper::getId(ability) << " ";
+            if (position == StreakScanner::notFound) {
+                std::cout << "- ";
+            } else {
+                std::cout << position << " ";
+            }
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::flush;
+}
+
+
+/// Print every match of each pattern within `length` rolls, for no drink and each drink.
+void printPatternMatches(std::string_view filename, const std::vector<std::string_view>& patternStrings, const size_t length, RunStats& stats) {
+    std::vector<PatternMatcher::Pattern> patterns{};
+    for (const auto patternString: patternStrings) {
+        patterns.push_back(PatternMatcher::parsePattern(patternString));
+    }
+    const PatternMatcher matcher{patterns};
+
+    auto gear = loadGear(filename, stats);
+    auto& seedHelper = gear.seedHelper;
+    const auto finalSeed = gear.finalSeed;
+    printGearInformation(gear);
+    // Matches are printed while scanning.
+    const auto predictPhase = stats.startPhase("predict");
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        std::cout << TerminalFormat::BOLD << ((drink == Ability::noDrink) ? "No drink" : AbilityHelper::getId(drink)) << TerminalFormat::ENDC << ":\n";
+
+        matcher.scanRolls(seedHelper, finalSeed, drink, length, [&patternStrings](const PatternMatcher::Match& match) {
+            std::cout << match.start << ". " << patternStrings[match.patternIndex] << "\n";
+        });
+    }
+    std::cout << std::flush;
 }
 
 
-void printFutureRolls(std::string_view filename) {
+/// Print `(ability probability)` pairs with non-zero probability, most likely first.
+void printProbabilities(const CandidatePrediction::Prediction& prediction, const CandidatePrediction::AbilityCounts& counts, const size_t maxCount) {
+    std::vector<std::pair<uint32_t, Ability>> sortedCounts{};
+    for (size_t i = 0; i < AbilityHelper::abilitiesCount; i += 1) {
+        if (counts[i] > 0) {
+            sortedCounts.emplace_back(counts[i], static_cast<Ability>(i));
+        }
+    }
+    std::stable_sort(sortedCounts.begin(), sortedCounts.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+    });
+    if (sortedCounts.size() > maxCount) {
+        sortedCounts.resize(maxCount);
+    }
+
+    for (const auto [count, ability]: sortedCounts) {
+        std::cout << AbilityHelper::getId(ability) << " " << std::fixed << std::setprecision(1) << (prediction.getProbability(count) * 100) << "% ";
+    }
+}
+
+
+/// Predict with all seeds that match the roll sequence, when the initial seed is unknown.
+void printCandidateFutureRolls(std::string_view filename, RunStats& stats) {
+    auto loadPhase = stats.startPhase("load");
     YamlFile yamlFile(filename);
-    if (!yamlFile.getInitialSeed().has_value()) {
-        throw std::runtime_error("No initial seed in file.");
+    loadPhase.stop();
+    if (yamlFile.getRollSequence().empty()) {
+        throw std::runtime_error("No roll sequence in file.");
     }
 
+    auto tablesPhase = stats.startPhase("tables");
     SeedHelper seedHelper{yamlFile.getBrand()};
-    const auto [valid, finalSeed] = seedHelper.advanceSeedToEndOfRollSequence(yamlFile.getInitialSeed().value(), yamlFile.getRollSequence());
-    if (!valid) {
-        throw std::runtime_error("The initial seed doesn't match the roll sequence.");
+    tablesPhase.stop();
+
+    // Tuned with `find --autotune`.
+    const auto profileFilename = SearchProfile::getDefaultFilename();
+    const auto profile = profileFilename.empty() ? std::nullopt : SearchProfile::load(profileFilename);
+    const auto configuration = SearchProfile::getConfiguration(profile, yamlFile.getRollSequence());
+
+    auto searchPhase = stats.startPhase("search");
+    const auto workersCount = std::thread::hardware_concurrency();
+    const auto candidates = seedHelper.findSeed(yamlFile.getRollSequence(), configuration, stats.getSearchStats());
+    searchPhase.stop();
+    if (candidates.empty()) {
+        throw std::runtime_error("No seed matches the roll sequence.");
     }
 
+    auto predictPhase = stats.startPhase("predict");
+    const auto currentSeeds = DrinkAdvisor::getCurrentSeeds(seedHelper, candidates, yamlFile.getRollSequence(), workersCount);
+    const auto prediction = CandidatePrediction::predict(seedHelper, currentSeeds, 15, workersCount);
+    predictPhase.stop();
+
     // Print gear information.
     std::cout << yamlFile.getName() << "\n";
     std::cout << "Brand: " << yamlFile.getBrand() << "\n";
-    std::cout << std::hex << "Initial seed: 0x" << yamlFile.getInitialSeed().value() << " -> Final seed: 0x" << finalSeed << std::dec << std::endl;
+    std::cout << "Candidate seeds: " << candidates.size() << std::endl;
+    if (yamlFile.getRollSequence().hasUncertainDrinks()) {
+        // Each drink resolution may end at another seed.
+        std::cout << "Current seeds: " << currentSeeds.size() << std::endl;
+    }
 
-    // No drink.
-    const auto noDrinkResults = seedHelper.generateRolls(finalSeed);
-    printRollsWithEmphasis("No drink:", noDrinkResults);
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        std::string title{"No drink:"};
+        if (drink != Ability::noDrink) {
+            title = "Drink: ";
+            title += AbilityHelper::getId(drink);
+        }
 
-    // With drink.
-    for (size_t i = 0; i < AbilityHelper::abilitiesCount; i += 1) {
-        const auto drink = static_cast<Ability>(i);
-        std::string drinkTitle{"Drink: "};
-        drinkTitle += AbilityHelper::getId(drink);
+        std::cout << TerminalFormat::BOLD << title << TerminalFormat::ENDC << "\n";
+        std::cout << "3-streak chances: ";
+        printProbabilities(prediction, prediction.threeStreakCounts[i], AbilityHelper::abilitiesCount);
+        std::cout << "\n";
 
-        const auto withDrinkResults = seedHelper.generateRollsWithDrink(finalSeed, drink);
-        printRollsWithEmphasis(drinkTitle, withDrinkResults);
+        for (size_t j = 0; j < prediction.length; j += 1) {
+            std::cout << j << ". ";
+            printProbabilities(prediction, prediction.getAbilityCounts(i, j), 3);
+            std::cout << "\n";
+        }
+        std::cout << std::endl;
     }
 }
 
@@ -93,8 +600,127 @@ int main(int argc, char* argv[]) {
     }
 
     const auto filename = argv[1];
+    bool useCandidates = false;
+    std::optional<Ability> planTarget{};
+    size_t planHorizon = 100;
+    auto planObjective = DrinkPlanner::Objective::fewestRolls;
+    /// Other pieces of the build: (filename, target).
+    std::vector<std::pair<std::string_view, Ability>> buildPieces{};
+    std::optional<size_t> streaksLength{};
+    /// Max unlogged rolls and drinks.
+    std::optional<size_t> resyncEditsCount{};
+    auto format = OutputFormat::text;
+    std::vector<std::string_view> matchPatterns{};
+    size_t streakLength = 3;
+    bool printStats = false;
+    bool countHardwareEvents = false;
+    std::string prometheusFilename{};
+    std::string traceFilename{};
+
+    for (int i = 2; i < argc; i += 1) {
+        const std::string_view argument{argv[i]};
+        if ((argument == "--candidates") || (argument == "-c")) {
+            useCandidates = true;
+        } else if ((argument == "--plan") && (i + 1 < argc)) {
+            i += 1;
+            planTarget = AbilityHelper::fromId(argv[i]);
+        } else if ((argument == "--horizon") && (i + 1 < argc)) {
+            i += 1;
+            planHorizon = std::stoul(argv[i]);
+        } else if ((argument == "--with") && (i + 2 < argc)) {
+            buildPieces.emplace_back(argv[i + 1], AbilityHelper::fromId(argv[i + 2]));
+            i += 2;
+        } else if (argument == "--fewest-drinks") {
+            planObjective = DrinkPlanner::Objective::fewestDrinks;
+        } else if ((argument == "--format") && (i + 1 < argc)) {
+            i += 1;
+            format = OutputFormatHelper::fromId(argv[i]);
+        } else if ((argument == "--match") && (i + 1 < argc)) {
+            i += 1;
+            matchPatterns.emplace_back(argv[i]);
+        } else if ((argument == "--streaks") && (i + 1 < argc)) {
+            i += 1;
+            streaksLength = std::stoul(argv[i]);
+        } else if ((argument == "--streak-length") && (i + 1 < argc)) {
+            i += 1;
+            streakLength = std::stoul(argv[i]);
+        } else if ((argument == "--resync") && (i + 1 < argc)) {
+            i += 1;
+            resyncEditsCount = std::stoul(argv[i]);
+        } else if (argument == "--stats") {
+            printStats = true;
+        } else if (argument == "--hw-counters") {
+            // Reported with the other stats.
+            printStats = true;
+            countHardwareEvents = true;
+        } else if ((argument == "--stats-prometheus") && (i + 1 < argc)) {
+            i += 1;
+            prometheusFilename = argv[i];
+        } else if ((argument == "--trace") && (i + 1 < argc)) {
+            i += 1;
+            traceFilename = argv[i];
+        } else {
+            std::string exceptionMessage{"Unrecognized argument: "};
+            exceptionMessage += argument;
+            throw std::invalid_argument(exceptionMessage);
+        }
+    }
+
+    const auto modesCount = static_cast<size_t>(!matchPatterns.empty()) + static_cast<size_t>(streaksLength.has_value()) + static_cast<size_t>(planTarget.has_value())
+                            + static_cast<size_t>(useCandidates) + static_cast<size_t>(resyncEditsCount.has_value());
+    if (modesCount > 1) {
+        throw std::invalid_argument("`--resync`, `--match`, `--streaks`, `--plan` and `--candidates` can't be combined.");
+    }
+    const bool isDefaultMode = (modesCount == 0);
+    if (planTarget.has_value() && (planHorizon > DrinkPlanner::maxHorizon)) {
+        throw std::invalid_argument("`--horizon` can't be over " + std::to_string(DrinkPlanner::maxHorizon) + " with `--plan`.");
+    }
+    if (!buildPieces.empty() && !planTarget.has_value()) {
+        throw std::invalid_argument("`--with` needs `--plan`.");
+    }
+    if (!buildPieces.empty() && (planObjective == DrinkPlanner::Objective::fewestDrinks)) {
+        throw std::invalid_argument("`--fewest-drinks` isn't supported with `--with`: Build plans range from fewest rolls to fewest drinks.");
+    }
+    if (buildPieces.size() > 2) {
+        throw std::invalid_argument("A build has at most 3 pieces: Headgear, clothing and shoes.");
+    }
+    if (!isDefaultMode && (format != OutputFormat::text)) {
+        throw std::invalid_argument("`--format` is only supported when predicting future rolls of a single seed.");
+    }
+
+    if (!traceFilename.empty()) {
+        Trace::enable();
+    }
+    RunStats stats{printStats || !prometheusFilename.empty()};
+    if (countHardwareEvents) {
+        stats.enableHardwareCounters();
+    }
+    if (resyncEditsCount.has_value()) {
+        printResyncAlignments(filename, resyncEditsCount.value(), stats);
+    } else if (!matchPatterns.empty()) {
+        printPatternMatches(filename, matchPatterns, planHorizon, stats);
+    } else if (streaksLength.has_value()) {
+        printFirstStreaks(filename, streaksLength.value(), streakLength, stats);
+    } else if (planTarget.has_value() && !buildPieces.empty()) {
+        buildPieces.insert(buildPieces.begin(), std::make_pair(std::string_view{filename}, planTarget.value()));
+        printBuildPlans(buildPieces, planHorizon, streakLength, stats);
+    } else if (planTarget.has_value()) {
+        printDrinkPlan(filename, planTarget.value(), streakLength, planHorizon, planObjective, stats);
+    } else if (useCandidates) {
+        printCandidateFutureRolls(filename, stats);
+    } else {
+        printFutureRolls(filename, format, stats);
+    }
 
-    printFutureRolls(filename);
+    if (printStats) {
+        stats.print(std::cerr);
+    }
+    if (!prometheusFilename.empty()) {
+        stats.writePrometheus(prometheusFilename, "predict");
+    }
+    if (!traceFilename.empty()) {
+        Trace::write(traceFilename);
+    }
 
     return 0;
 }
@@ -0,0 +1,296 @@
+#include "build_planner.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "../helpers/parallel.h"
+
+
+namespace BuildPlanner {
+    /// Partial build plan: Plan index in each front so far.
+    struct Combination {
+        size_t rollsCount;
+        size_t drinksCount;
+        std::vector<size_t> planIndices;
+    };
+
+    /// Keep the combinations that no other combination beats on both rolls and drinks, sorted by rolls.
+    static std::vector<Combination> filterParetoFront(std::vector<Combination> combinations) {
+        std::sort(combinations.begin(), combinations.end(), [](const Combination& lhs, const Combination& rhs) {
+            return (lhs.rollsCount != rhs.rollsCount) ? (lhs.rollsCount < rhs.rollsCount) : (lhs.drinksCount < rhs.drinksCount);
+        });
+
+        std::vector<Combination> returnValue{};
+        for (auto& combination: combinations) {
+            if (returnValue.empty() || (combination.drinksCount < returnValue.back().drinksCount)) {
+                returnValue.push_back(std::move(combination));
+            }
+        }
+        return returnValue;
+    }
+
+
+    [[noreturn]] static void throwInvalidFile(const std::string& filename, const size_t lineNumber, const std::string& message) {
+        throw std::runtime_error("Invalid build plans file " + filename + " (line " + std::to_string(lineNumber) + "): " + message);
+    }
+
+    /// Tab separated fields.
+    static std::vector<std::string> splitLine(const std::string& line, const char separator) {
+        std::vector<std::string> returnValue{};
+        std::istringstream lineStream{line};
+        std::string field{};
+        while (std::getline(lineStream, field, separator)) {
+            returnValue.push_back(field);
+        }
+        return returnValue;
+    }
+
+
+    Planner::Planner(const size_t horizon): horizon(horizon), seedHelpers{}, fronts{}, savedFronts{}, searchedFrontsCount{0} {}
+
+    std::string Planner::getDefaultFilename() {
+        std::filesystem::path directory{};
+        if (const auto* const cacheHome = std::getenv("XDG_CACHE_HOME"); (cacheHome != nullptr) && (*cacheHome != '\0')) {
+            directory = cacheHome;
+        } else if (const auto* const home = std::getenv("HOME"); (home != nullptr) && (*home != '\0')) {
+            directory = std::filesystem::path{home} / ".cache";
+        } else {
+            return {};
+        }
+
+        return (directory / "splatoon-3-gear-helper" / "build_plans.txt").string();
+    }
+
+    void Planner::load(const std::string& filename) {
+        std::ifstream file{filename};
+        if (!file) {
+            return;
+        }
+
+        std::string line{};
+        size_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber += 1;
+            if (line.empty() || (line.front() == '#')) {
+                continue;
+            }
+
+            const auto fields = splitLine(line, '\t');
+            if (fields.size() < 5) {
+                throwInvalidFile(filename, lineNumber, "Expected brand, seed, target, streak length and horizon.");
+            }
+            Key key{};
+            std::vector<std::vector<Ability>> plans{};
+            try {
+                const auto target = AbilityHelper::fromId(fields[2]);
+                if (target == Ability::unknown) {
+                    throwInvalidFile(filename, lineNumber, "Invalid target: " + fields[2]);
+                }
+                key = Key{fields[0], static_cast<uint32_t>(std::stoul(fields[1])), target, std::stoul(fields[3]), std::stoul(fields[4])};
+
+                for (size_t i = 5; i < fields.size(); i += 1) {
+                    std::vector<Ability> drinks{};
+                    for (const auto& drinkId: splitLine(fields[i], ',')) {
+                        const auto drink = (drinkId == "none") ? Ability::noDrink : AbilityHelper::fromId(drinkId);
+                        if (drink == Ability::unknown) {
+                            throwInvalidFile(filename, lineNumber, "Invalid drink: " + drinkId);
+                        }
+                        drinks.push_back(drink);
+                    }
+                    plans.push_back(std::move(drinks));
+                }
+            } catch (const std::logic_error& error) {
+                // Invalid numbers and IDs.
+                throwInvalidFile(filename, lineNumber, error.what());
+            }
+            if (fronts.find(key) == fronts.end()) {
+                savedFronts[std::move(key)] = std::move(plans);
+            }
+        }
+    }
+
+    void Planner::save(const std::string& filename) const {
+        const std::filesystem::path path{filename};
+        if (path.has_parent_path()) {
+            std::error_code error{};
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        std::ofstream file{filename, std::ios::trunc};
+        if (!file) {
+            throw std::runtime_error("Failed to create build plans file: " + filename);
+        }
+
+        file << "# Written by `predict --with`. <brand> <seed> <target> <streak length> <horizon> <plan drinks>...\n";
+        size_t savedCount = 0;
+        const auto writeFront = [&](const Key& key, const auto& plans, const auto& getDrinks) {
+            if (savedCount == maxSavedFrontsCount) {
+                return;
+            }
+            const auto& [brand, seed, target, streakLength, keyHorizon] = key;
+            file << brand << '\t' << seed << '\t' << AbilityHelper::getId(target) << '\t' << streakLength << '\t' << keyHorizon;
+            for (const auto& plan: plans) {
+                const auto& drinks = getDrinks(plan);
+                for (size_t i = 0; i < drinks.size(); i += 1) {
+                    const auto drink = drinks[i];
+                    file << ((i == 0) ? '\t' : ',') << ((drink == Ability::noDrink) ? std::string_view{"none"} : AbilityHelper::getId(drink));
+                }
+            }
+            file << '\n';
+            savedCount += 1;
+        };
+
+        for (const auto& [key, plans]: fronts) {
+            writeFront(key, plans, [](const DrinkPlanner::Plan& plan) {
+                std::vector<Ability> drinks{};
+                for (const auto& step: plan.steps) {
+                    drinks.push_back(step.drink);
+                }
+                return drinks;
+            });
+        }
+        for (const auto& [key, plans]: savedFronts) {
+            writeFront(key, plans, [](const std::vector<Ability>& drinks) {
+                return drinks;
+            });
+        }
+
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write build plans file: " + filename);
+        }
+    }
+
+    SeedHelper& Planner::getSeedHelper(const std::string_view brand) {
+        auto it = seedHelpers.find(brand);
+        if (it == seedHelpers.end()) {
+            it = seedHelpers.emplace(std::string{brand}, SeedHelper{brand}).first;
+            it->second.cacheAllDrinkRollToAbilityMaps();
+        }
+        return it->second;
+    }
+
+    std::optional<std::vector<DrinkPlanner::Plan>> Planner::replayFront(const Key& key, const std::vector<std::vector<Ability>>& drinks) {
+        const auto& [brand, initialSeed, target, streakLength, keyHorizon] = key;
+        const auto& seedHelper = getSeedHelper(brand);
+
+        std::vector<DrinkPlanner::Plan> returnValue{};
+        for (const auto& planDrinks: drinks) {
+            DrinkPlanner::Plan plan{{}, 0};
+            auto seed = initialSeed;
+            size_t streak = 0;
+            for (const auto drink: planDrinks) {
+                Ability ability;
+                std::tie(seed, ability) = (drink == Ability::noDrink) ? seedHelper.generateRoll(seed) : seedHelper.generateRollWithDrink(seed, drink);
+                plan.steps.push_back(DrinkPlanner::Step{drink, ability, seed});
+                plan.drinksCount += (drink == Ability::noDrink) ? 0 : 1;
+                streak = (ability == target) ? (streak + 1) : 0;
+                if ((streak == streakLength) && (plan.steps.size() < planDrinks.size())) {
+                    // The streak must end the plan.
+                    return std::nullopt;
+                }
+            }
+            if ((streak != streakLength) || (plan.steps.size() > keyHorizon)) {
+                return std::nullopt;
+            }
+            returnValue.push_back(std::move(plan));
+        }
+        return returnValue;
+    }
+
+    std::vector<const std::vector<DrinkPlanner::Plan>*> Planner::getFronts(const std::vector<Piece>& pieces, const size_t workersCount) {
+        // New pieces, once each. Seed helpers are created here, so that the workers only read them.
+        std::vector<Key> newKeys{};
+        std::vector<SeedHelper*> newSeedHelpers{};
+        for (const auto& [brand, seed, target, streakLength]: pieces) {
+            Key key{brand, seed, target, streakLength, horizon};
+            if ((fronts.find(key) != fronts.end()) || (std::find(newKeys.begin(), newKeys.end(), key) != newKeys.end())) {
+                continue;
+            }
+
+            // Loaded.
+            if (const auto it = savedFronts.find(key); it != savedFronts.end()) {
+                auto front = replayFront(key, it->second);
+                savedFronts.erase(it);
+                if (front.has_value()) {
+                    fronts.emplace(std::move(key), std::move(front.value()));
+                    continue;
+                }
+            }
+
+            newSeedHelpers.push_back(&getSeedHelper(brand));
+            newKeys.push_back(std::move(key));
+        }
+        searchedFrontsCount += newKeys.size();
+
+        const auto workerFronts = Parallel::mapRanges(newKeys.size(), workersCount, [&](const size_t start, const size_t stop) {
+            std::vector<std::vector<DrinkPlanner::Plan>> returnValue{};
+            for (size_t i = start; i < stop; i += 1) {
+                const auto& [brand, seed, target, streakLength, keyHorizon] = newKeys[i];
+                returnValue.push_back(DrinkPlanner::findParetoPlans(*newSeedHelpers[i], seed, target, streakLength, keyHorizon));
+            }
+            return returnValue;
+        });
+
+        size_t i = 0;
+        for (const auto& workerFront: workerFronts) {
+            for (const auto& front: workerFront) {
+                fronts.emplace(std::move(newKeys[i]), front);
+                i += 1;
+            }
+        }
+
+        std::vector<const std::vector<DrinkPlanner::Plan>*> returnValue{};
+        returnValue.reserve(pieces.size());
+        for (const auto& [brand, seed, target, streakLength]: pieces) {
+            returnValue.push_back(&fronts.at(Key{brand, seed, target, streakLength, horizon}));
+        }
+        return returnValue;
+    }
+
+    std::vector<BuildPlan> Planner::findPlans(const std::vector<Piece>& pieces, const size_t workersCount) {
+        if (pieces.empty()) {
+            return {};
+        }
+        const auto pieceFronts = getFronts(pieces, workersCount);
+
+        // Add 1 piece at a time. Dominated partial plans can't be part of a Pareto-optimal build plan.
+        std::vector<Combination> combinations{Combination{0, 0, {}}};
+        for (const auto front: pieceFronts) {
+            std::vector<Combination> nextCombinations{};
+            nextCombinations.reserve(combinations.size() * front->size());
+            for (const auto& combination: combinations) {
+                for (size_t i = 0; i < front->size(); i += 1) {
+                    const auto& plan = (*front)[i];
+                    Combination nextCombination{combination.rollsCount + plan.steps.size(), combination.drinksCount + plan.drinksCount, combination.planIndices};
+                    nextCombination.planIndices.push_back(i);
+                    nextCombinations.push_back(std::move(nextCombination));
+                }
+            }
+            combinations = filterParetoFront(std::move(nextCombinations));
+        }
+
+        std::vector<BuildPlan> returnValue{};
+        returnValue.reserve(combinations.size());
+        for (const auto& [rollsCount, drinksCount, planIndices]: combinations) {
+            BuildPlan buildPlan{rollsCount, drinksCount, {}};
+            for (size_t i = 0; i < pieces.size(); i += 1) {
+                buildPlan.plans.push_back((*pieceFronts[i])[planIndices[i]]);
+            }
+            returnValue.push_back(std::move(buildPlan));
+        }
+        return returnValue;
+    }
+
+    size_t Planner::getCachedFrontsCount() const {
+        return fronts.size();
+    }
+
+    size_t Planner::getSearchedFrontsCount() const {
+        return searchedFrontsCount;
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_BUILD_PLANNER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_BUILD_PLANNER_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "../seed_helper.h"
+#include "drink_planner.h"
+
+
+/**
+ * Plans a whole build: A streak of a target ability on each piece (e.g. headgear, clothing and shoes).
+ *
+ * Pieces roll independently, so a build plan is 1 `DrinkPlanner` plan per piece, and its cost is the sum of theirs.
+ * The build plans that no other build plan beats on both total rolls and total drinks are the sums of the pieces' Pareto fronts, filtered again.
+ */
+namespace BuildPlanner {
+    struct Piece {
+        std::string brand;
+        /// Seed after the last logged roll.
+        uint32_t seed;
+        Ability target;
+        size_t streakLength = 3;
+    };
+
+    struct BuildPlan {
+        size_t rollsCount;
+        size_t drinksCount;
+        /// Indices correspond to the pieces.
+        std::vector<DrinkPlanner::Plan> plans;
+    };
+
+    /**
+     * Keeps each piece's Pareto front, so that changing 1 piece of a build (or asking again) only searches that piece.
+     * Fronts can be saved and loaded, so that later runs (e.g. `predict --with`) reuse them.
+     *
+     * Fronts file (text, 1 front per line, `#` comments), tab separated:
+     *
+     * ```
+     * <brand>  <seed>  <target ID>  <streak length>  <horizon>  <plan>...
+     * ```
+     *
+     * Each plan is its comma separated drink IDs (`none` for no drink), fewest rolls first. A front without plans can't reach the streak.
+     *
+     * Not thread-safe itself: `findPlans` parallelizes the pieces' searches.
+     */
+    class Planner {
+    public:
+        /// Saved fronts beyond this are dropped, the ones used by this planner first.
+        static constexpr size_t maxSavedFrontsCount = 1 << 12;
+
+    private:
+        /// (brand, seed, target, streak length, horizon)
+        using Key = std::tuple<std::string, uint32_t, Ability, size_t, size_t>;
+
+        size_t horizon;
+        /// Keys: Brands. Every drink is cached.
+        std::map<std::string, SeedHelper, std::less<>> seedHelpers;
+        /// `DrinkPlanner::findParetoPlans`.
+        std::map<Key, std::vector<DrinkPlanner::Plan>> fronts;
+        /// Loaded fronts that aren't used yet: Each plan's drinks. Replayed (and verified) on first use.
+        std::map<Key, std::vector<std::vector<Ability>>> savedFronts;
+        /// Fronts searched by `getFronts`, i.e. neither cached nor loaded.
+        size_t searchedFrontsCount;
+
+        SeedHelper& getSeedHelper(std::string_view brand);
+
+        /// Replay a loaded front. `std::nullopt` if a plan doesn't end with the streak.
+        std::optional<std::vector<DrinkPlanner::Plan>> replayFront(const Key& key, const std::vector<std::vector<Ability>>& drinks);
+
+    public:
+        /// @param horizon Max rolls per piece.
+        explicit Planner(size_t horizon = 100);
+
+        /// `$XDG_CACHE_HOME/splatoon-3-gear-helper/build_plans.txt`, or under `~/.cache`. Empty if neither is set.
+        [[nodiscard]] static std::string getDefaultFilename();
+
+        /**
+         * Add the fronts of a file. Does nothing if the file doesn't exist.
+         *
+         * @throws std::runtime_error for invalid files.
+         */
+        void load(const std::string& filename);
+
+        /**
+         * Save all fronts (up to `maxSavedFrontsCount`). Creates missing directories.
+         *
+         * @throws std::runtime_error if the file can't be written.
+         */
+        void save(const std::string& filename) const;
+
+        /**
+         * Each piece's Pareto front, searching the new pieces in parallel.
+         *
+         * @return Indices correspond to `pieces`. Valid until the next call.
+         */
+        std::vector<const std::vector<DrinkPlanner::Plan>*> getFronts(const std::vector<Piece>& pieces, size_t workersCount = 0);
+
+        /**
+         * @return Sorted by total rolls (ascending), so total drinks are descending.
+         * Empty if a piece's streak can't be reached within the horizon.
+         */
+        std::vector<BuildPlan> findPlans(const std::vector<Piece>& pieces, size_t workersCount = 0);
+
+        /// Fronts kept in memory (searched or replayed).
+        [[nodiscard]] size_t getCachedFrontsCount() const;
+
+        [[nodiscard]] size_t getSearchedFrontsCount() const;
+    };
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_BUILD_PLANNER_H
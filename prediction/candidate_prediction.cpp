@@ -0,0 +1,78 @@
+#include "candidate_prediction.h"
+
+#include "../helpers/parallel.h"
+#include "../roll_range.h"
+
+
+namespace CandidatePrediction {
+    using AbilityHelper::abilitiesCount;
+    using AbilityHelper::drinkChoicesCount;
+
+    /// A `Prediction` with all counts set to 0.
+    static Prediction makeEmptyPrediction(const size_t candidatesCount, const size_t length) {
+        Prediction returnValue{};
+        returnValue.candidatesCount = candidatesCount;
+        returnValue.length = length;
+        returnValue.abilityCounts = std::vector<AbilityCounts>(drinkChoicesCount * length, AbilityCounts{});
+        return returnValue;
+    }
+
+    Prediction predict(SeedHelper& seedHelper, const std::vector<uint32_t>& currentSeeds, const size_t length, const size_t workersCount) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        // Each worker fills its own counts.
+        const auto workerPredictions = Parallel::mapRanges(currentSeeds.size(), workersCount, [&](const size_t start, const size_t stop) {
+            auto prediction = makeEmptyPrediction(stop - start, length);
+
+            for (size_t drinkChoiceIndex = 0; drinkChoiceIndex < drinkChoicesCount; drinkChoiceIndex += 1) {
+                const auto drink = AbilityHelper::getDrinkChoice(drinkChoiceIndex);
+                auto* const abilityCounts = prediction.abilityCounts.data() + drinkChoiceIndex * length;
+                auto& threeStreakCounts = prediction.threeStreakCounts[drinkChoiceIndex];
+
+                for (size_t i = start; i < stop; i += 1) {
+                    auto previousAbility1 = Ability::unknown;
+                    auto previousAbility2 = Ability::unknown;
+                    /// Bit `i`: Has 3-streak of `Ability(i)`.
+                    uint16_t threeStreakMask = 0;
+
+                    size_t rollIndex = 0;
+                    for (const auto& roll: RollRange{seedHelper, currentSeeds[i], drink, length}) {
+                        const auto ability = roll.ability;
+                        const auto abilityIndex = AbilityHelper::getIndex(ability);
+                        abilityCounts[rollIndex][abilityIndex] += 1;
+                        if ((ability == previousAbility1) && (ability == previousAbility2)) {
+                            threeStreakMask |= (1 << abilityIndex);
+                        }
+
+                        previousAbility2 = previousAbility1;
+                        previousAbility1 = ability;
+                        rollIndex += 1;
+                    }
+
+                    for (size_t j = 0; j < abilitiesCount; j += 1) {
+                        threeStreakCounts[j] += (threeStreakMask >> j) & 1;
+                    }
+                }
+            }
+
+            return prediction;
+        });
+
+        // Merge.
+        auto returnValue = makeEmptyPrediction(currentSeeds.size(), length);
+        for (const auto& workerPrediction: workerPredictions) {
+            for (size_t i = 0; i < returnValue.abilityCounts.size(); i += 1) {
+                for (size_t j = 0; j < abilitiesCount; j += 1) {
+                    returnValue.abilityCounts[i][j] += workerPrediction.abilityCounts[i][j];
+                }
+            }
+            for (size_t i = 0; i < drinkChoicesCount; i += 1) {
+                for (size_t j = 0; j < abilitiesCount; j += 1) {
+                    returnValue.threeStreakCounts[i][j] += workerPrediction.threeStreakCounts[i][j];
+                }
+            }
+        }
+
+        return returnValue;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_CANDIDATE_PREDICTION_H
+#define SPLATOON_3_GEAR_HELPER_CPP_CANDIDATE_PREDICTION_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../seed_helper.h"
+
+
+/**
+ * Future roll probabilities over a set of candidate seeds, when the seed isn't known exactly yet.
+ *
+ * Like `printFutureRolls`, each drink choice is held for all rolls.
+ */
+namespace CandidatePrediction {
+    using AbilityCounts = std::array<uint32_t, AbilityHelper::abilitiesCount>;
+
+    struct Prediction {
+        size_t candidatesCount;
+        size_t length;
+
+        /**
+         * Number of candidates that roll each ability.
+         * Indices: `AbilityHelper::getDrinkChoice` * `length` + roll index.
+         */
+        std::vector<AbilityCounts> abilityCounts;
+
+        /**
+         * Number of candidates with a 3-streak of each ability within `length` rolls.
+         * Indices: `AbilityHelper::getDrinkChoice`.
+         */
+        std::array<AbilityCounts, AbilityHelper::drinkChoicesCount> threeStreakCounts;
+
+        [[nodiscard]] inline const AbilityCounts& getAbilityCounts(size_t drinkChoiceIndex, size_t rollIndex) const {
+            return abilityCounts[drinkChoiceIndex * length + rollIndex];
+        }
+
+        [[nodiscard]] inline double getProbability(uint32_t count) const {
+            return (candidatesCount == 0) ? 0 : (static_cast<double>(count) / static_cast<double>(candidatesCount));
+        }
+    };
+
+    /**
+     * Predict the next `length` rolls of all candidates.
+     *
+     * @param currentSeeds Seeds after the last logged roll (see `DrinkAdvisor::getCurrentSeeds`).
+     */
+    Prediction predict(SeedHelper& seedHelper, const std::vector<uint32_t>& currentSeeds, size_t length = 15, size_t workersCount = 0);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_CANDIDATE_PREDICTION_H
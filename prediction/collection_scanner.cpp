@@ -0,0 +1,145 @@
+#include "collection_scanner.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+
+#include "../helpers/parallel.h"
+#include "../roll_range.h"
+#include "../seed_helper.h"
+#include "../yaml/bulk_loader.h"
+
+
+namespace CollectionScanner {
+    /// Keys: Brands.
+    using SeedHelpers = std::map<std::string, SeedHelper, std::less<>>;
+
+    /**
+     * One `SeedHelper` per brand, with all drinks cached. Read-only afterwards.
+     *
+     * @param getBrand Brand of gear `i`.
+     */
+    template <typename GetBrand>
+    static SeedHelpers makeSeedHelpers(const size_t gearsCount, GetBrand getBrand) {
+        SeedHelpers returnValue{};
+        for (size_t i = 0; i < gearsCount; i += 1) {
+            const std::string_view brand = getBrand(i);
+            if (returnValue.find(brand) == returnValue.end()) {
+                returnValue.emplace(std::string{brand}, SeedHelper{brand}).first->second.cacheAllDrinkRollToAbilityMaps();
+            }
+        }
+
+        return returnValue;
+    }
+
+    Collection loadCollection(const std::string& directory, const size_t workersCount) {
+        const auto loadedCollection = BulkLoader::loadDirectory(directory, workersCount);
+        const auto seedHelpers = makeSeedHelpers(loadedCollection.gears.size(), [&](const size_t i) {
+            return loadedCollection.getBrand(i);
+        });
+
+        // Each worker replays a range of gears.
+        const auto workerCollections = Parallel::mapRanges(loadedCollection.gears.size(), workersCount, [&](const size_t start, const size_t stop) {
+            Collection collection{};
+            for (size_t i = start; i < stop; i += 1) {
+                const auto& gear = loadedCollection.gears[i];
+                try {
+                    if (!gear.initialSeed.has_value()) {
+                        throw std::runtime_error("No initial seed in file.");
+                    }
+
+                    const auto& seedHelper = seedHelpers.find(loadedCollection.getBrand(i))->second;
+                    const auto [valid, finalSeed] = seedHelper.replayRollSequence(gear.initialSeed.value(), loadedCollection.getRollSequence(i));
+                    if (!valid) {
+                        throw std::runtime_error("The initial seed doesn't match the roll sequence.");
+                    }
+
+                    collection.gears.push_back(GearState{gear.filename, gear.name, std::string{loadedCollection.getBrand(i)}, finalSeed});
+                } catch (const std::exception& e) {
+                    collection.errors.push_back(LoadError{gear.filename, e.what()});
+                }
+            }
+            return collection;
+        });
+
+        Collection returnValue{};
+        returnValue.errors = loadedCollection.errors;
+        for (const auto& collection: workerCollections) {
+            returnValue.gears.insert(returnValue.gears.end(), collection.gears.begin(), collection.gears.end());
+            returnValue.errors.insert(returnValue.errors.end(), collection.errors.begin(), collection.errors.end());
+        }
+
+        return returnValue;
+    }
+
+    std::vector<Opportunity> findOpportunities(const std::vector<GearState>& gears, const std::vector<Ability>& targets, const size_t streakLength, const size_t horizon, const size_t workersCount) {
+        const auto seedHelpers = makeSeedHelpers(gears.size(), [&](const size_t i) {
+            return std::string_view{gears[i].brand};
+        });
+
+        AbilitySet targetsSet{};
+        for (const auto target: targets) {
+            targetsSet.insert(target);
+        }
+
+        const auto workerOpportunities = Parallel::mapRanges(gears.size(), workersCount, [&](const size_t start, const size_t stop) {
+            std::vector<Opportunity> opportunities{};
+            for (size_t i = start; i < stop; i += 1) {
+                const auto& seedHelper = seedHelpers.find(gears[i].brand)->second;
+
+                /// Best opportunity for each target.
+                std::array<Opportunity, AbilityHelper::abilitiesCount> bestOpportunities{};
+                for (size_t j = 0; j < AbilityHelper::abilitiesCount; j += 1) {
+                    bestOpportunities[j] = Opportunity{i, static_cast<Ability>(j), Ability::noDrink, SIZE_MAX};
+                }
+
+                // No drink first, so that it wins ties.
+                for (size_t j = 0; j < AbilityHelper::drinkChoicesCount; j += 1) {
+                    const auto drink = AbilityHelper::getDrinkChoice(j);
+                    auto remainingTargets = targetsSet;
+
+                    auto previousAbility = Ability::unknown;
+                    size_t streak = 0;
+                    size_t k = 0;
+                    for (const auto& roll: RollRange{seedHelper, gears[i].finalSeed, drink, horizon}) {
+                        const auto ability = roll.ability;
+                        streak = (ability == previousAbility) ? (streak + 1) : 1;
+                        previousAbility = ability;
+
+                        if ((streak == streakLength) && remainingTargets.contains(ability)) {
+                            remainingTargets = AbilitySet::fromMask(remainingTargets.getMask() & ~AbilitySet{ability}.getMask());
+
+                            auto& bestOpportunity = bestOpportunities[AbilityHelper::getIndex(ability)];
+                            if ((k + 1) < bestOpportunity.rollsCount) {
+                                bestOpportunity.drink = drink;
+                                bestOpportunity.rollsCount = k + 1;
+                            }
+                        }
+
+                        k += 1;
+                        if (remainingTargets.empty()) {
+                            break;
+                        }
+                    }
+                }
+
+                for (const auto& opportunity: bestOpportunities) {
+                    if (opportunity.rollsCount != SIZE_MAX) {
+                        opportunities.push_back(opportunity);
+                    }
+                }
+            }
+            return opportunities;
+        });
+
+        std::vector<Opportunity> returnValue{};
+        for (const auto& opportunities: workerOpportunities) {
+            returnValue.insert(returnValue.end(), opportunities.begin(), opportunities.end());
+        }
+        std::stable_sort(returnValue.begin(), returnValue.end(), [](const Opportunity& lhs, const Opportunity& rhs) {
+            return std::make_pair(lhs.rollsCount, lhs.drink != Ability::noDrink) < std::make_pair(rhs.rollsCount, rhs.drink != Ability::noDrink);
+        });
+
+        return returnValue;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_COLLECTION_SCANNER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_COLLECTION_SCANNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../data/ability.h"
+#include "../yaml/bulk_loader.h"
+
+
+/**
+ * Finds which gear in a collection of YAML files reaches an ability streak soonest.
+ */
+namespace CollectionScanner {
+    struct GearState {
+        std::string filename;
+        std::string name;
+        std::string brand;
+        /// Seed after the last logged roll.
+        uint32_t finalSeed;
+    };
+
+    using LoadError = BulkLoader::LoadError;
+
+    struct Collection {
+        /// Sorted by filename.
+        std::vector<GearState> gears;
+        std::vector<LoadError> errors;
+    };
+
+    /**
+     * Load every `.yaml`/`.yml`/`.gear` file in `directory` (not recursive) and replay it to its final seed.
+     *
+     * Files without an initial seed, or whose seed doesn't match the rolls, are reported in `errors`.
+     */
+    Collection loadCollection(const std::string& directory, size_t workersCount = 0);
+
+    struct Opportunity {
+        /// Index in `Collection::gears`.
+        size_t gearIndex;
+        Ability target;
+        /// `Ability::noDrink` or a drink held for all rolls.
+        Ability drink;
+        /// Rolls until the streak is complete.
+        size_t rollsCount;
+    };
+
+    /**
+     * For each (gear, target), the drink choice that completes a `target` streak in the fewest rolls.
+     *
+     * @return Soonest first. No drink is preferred on ties.
+     */
+    std::vector<Opportunity> findOpportunities(const std::vector<GearState>& gears, const std::vector<Ability>& targets, size_t streakLength = 3, size_t horizon = 100, size_t workersCount = 0);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_COLLECTION_SCANNER_H
@@ -0,0 +1,119 @@
+#include "drink_advisor.h"
+
+#include <algorithm>
+
+#include "../helpers/parallel.h"
+
+
+namespace DrinkAdvisor {
+    using AbilityHelper::drinkChoicesCount;
+    /// Indices: `AbilityHelper::getDrinkChoice`, ability.
+    using Histogram = std::array<std::array<size_t, AbilityHelper::abilitiesCount>, drinkChoicesCount>;
+
+    /// Every seed `initialSeed` can end at, through each resolution of the uncertain drinks that matches the rolls.
+    static void appendCurrentSeedsWithUncertainDrinks(const SeedHelper& seedHelper, const uint32_t initialSeed, const RollSequence& rollSequence, std::vector<uint32_t>& results) {
+        std::vector<uint32_t> currentSeeds{initialSeed};
+        std::vector<uint32_t> nextSeeds{};
+        std::array<uint32_t, 2> rollNextSeeds{};
+        for (const auto [expectedResults, drinks]: rollSequence) {
+            nextSeeds.clear();
+            for (const auto seed: currentSeeds) {
+                const auto rollNextSeedsCount = seedHelper.generateRollWithDrinks(seed, drinks, expectedResults, rollNextSeeds);
+                for (size_t i = 0; i < rollNextSeedsCount; i += 1) {
+                    if (std::find(nextSeeds.begin(), nextSeeds.end(), rollNextSeeds[i]) == nextSeeds.end()) {
+                        nextSeeds.push_back(rollNextSeeds[i]);
+                    }
+                }
+            }
+            std::swap(currentSeeds, nextSeeds);
+        }
+        results.insert(results.end(), currentSeeds.begin(), currentSeeds.end());
+    }
+
+    std::vector<uint32_t> getCurrentSeeds(SeedHelper& seedHelper, const std::vector<uint32_t>& initialSeeds, const RollSequence& rollSequence, const size_t workersCount) {
+        for (const auto drink: rollSequence.getDrinksUsed()) {
+            seedHelper.cacheDrinkRollToAbilityMap(drink);
+        }
+
+        if (rollSequence.hasUncertainDrinks()) {
+            // `replayRollSequence` needs certain drinks.
+            const auto workerSeeds = Parallel::mapRanges(initialSeeds.size(), workersCount, [&](const size_t start, const size_t stop) {
+                std::vector<uint32_t> seeds{};
+                for (size_t i = start; i < stop; i += 1) {
+                    appendCurrentSeedsWithUncertainDrinks(seedHelper, initialSeeds[i], rollSequence, seeds);
+                }
+                return seeds;
+            });
+
+            std::vector<uint32_t> returnValue{};
+            for (const auto& seeds: workerSeeds) {
+                returnValue.insert(returnValue.end(), seeds.begin(), seeds.end());
+            }
+            std::sort(returnValue.begin(), returnValue.end());
+            returnValue.erase(std::unique(returnValue.begin(), returnValue.end()), returnValue.end());
+            return returnValue;
+        }
+
+        std::vector<uint32_t> returnValue(initialSeeds.size(), 0);
+        Parallel::forEachRange(initialSeeds.size(), workersCount, [&](const size_t start, const size_t stop) {
+            for (size_t i = start; i < stop; i += 1) {
+                returnValue[i] = seedHelper.replayRollSequence(initialSeeds[i], rollSequence).second;
+            }
+        });
+
+        return returnValue;
+    }
+
+    std::vector<DrinkAdvice> adviseNextDrink(SeedHelper& seedHelper, const std::vector<uint32_t>& currentSeeds, const size_t workersCount) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        // Each worker fills its own histogram.
+        const auto histograms = Parallel::mapRanges(currentSeeds.size(), workersCount, [&](const size_t start, const size_t stop) {
+            Histogram histogram{};
+            for (size_t i = start; i < stop; i += 1) {
+                const auto seed = currentSeeds[i];
+                histogram[0][AbilityHelper::getIndex(seedHelper.generateRoll(seed).second)] += 1;
+                for (size_t j = 0; j < AbilityHelper::abilitiesCount; j += 1) {
+                    const auto ability = seedHelper.generateRollWithDrink(seed, static_cast<Ability>(j)).second;
+                    histogram[j + 1][AbilityHelper::getIndex(ability)] += 1;
+                }
+            }
+            return histogram;
+        });
+
+        // Merge.
+        Histogram mergedHistogram{};
+        for (const auto& histogram: histograms) {
+            for (size_t i = 0; i < drinkChoicesCount; i += 1) {
+                for (size_t j = 0; j < AbilityHelper::abilitiesCount; j += 1) {
+                    mergedHistogram[i][j] += histogram[i][j];
+                }
+            }
+        }
+
+        std::vector<DrinkAdvice> returnValue{};
+        returnValue.reserve(drinkChoicesCount);
+        for (size_t i = 0; i < drinkChoicesCount; i += 1) {
+            DrinkAdvice advice{};
+            advice.drink = AbilityHelper::getDrinkChoice(i);
+            advice.nextAbilityCounts = mergedHistogram[i];
+
+            double sumOfSquares = 0;
+            for (const auto count: advice.nextAbilityCounts) {
+                sumOfSquares += static_cast<double>(count) * static_cast<double>(count);
+            }
+            advice.expectedRemainingCandidates = currentSeeds.empty() ? 0 : (sumOfSquares / static_cast<double>(currentSeeds.size()));
+
+            returnValue.push_back(advice);
+        }
+
+        std::stable_sort(returnValue.begin(), returnValue.end(), [](const DrinkAdvice& lhs, const DrinkAdvice& rhs) {
+            return lhs.expectedRemainingCandidates < rhs.expectedRemainingCandidates;
+        });
+
+        return returnValue;
+    }
+    std::vector<DrinkAdvice> adviseNextDrinkAfterRolls(SeedHelper& seedHelper, const std::vector<uint32_t>& initialSeeds, const RollSequence& rollSequence, const size_t workersCount) {
+        return adviseNextDrink(seedHelper, getCurrentSeeds(seedHelper, initialSeeds, rollSequence, workersCount), workersCount);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_DRINK_ADVISOR_H
+#define SPLATOON_3_GEAR_HELPER_CPP_DRINK_ADVISOR_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../seed_helper.h"
+
+
+/**
+ * Picks the next drink that best narrows down an ambiguous set of candidate seeds.
+ */
+namespace DrinkAdvisor {
+    struct DrinkAdvice {
+        /// `Ability::noDrink` or a drink.
+        Ability drink;
+
+        /// Number of candidates that roll each ability next.
+        std::array<size_t, AbilityHelper::abilitiesCount> nextAbilityCounts;
+
+        /**
+         * Expected number of candidates left after observing the next roll:
+         * sum(count^2) / candidates.
+         */
+        double expectedRemainingCandidates;
+    };
+
+    /**
+     * Advance each candidate initial seed to the end of `rollSequence`.
+     *
+     * @return With certain drinks: Indices correspond to `initialSeeds`.
+     * With uncertain drinks: Every seed reachable through a drink resolution that matches the rolls, sorted and deduplicated.
+     */
+    std::vector<uint32_t> getCurrentSeeds(SeedHelper& seedHelper, const std::vector<uint32_t>& initialSeeds, const RollSequence& rollSequence, size_t workersCount = 0);
+
+    /**
+     * Next roll distribution for no drink and each drink.
+     *
+     * @param currentSeeds Seeds after the last logged roll (see `getCurrentSeeds`).
+     * @return Sorted by `expectedRemainingCandidates`: Best advice first.
+     */
+    std::vector<DrinkAdvice> adviseNextDrink(SeedHelper& seedHelper, const std::vector<uint32_t>& currentSeeds, size_t workersCount = 0);
+
+    /**
+     * `adviseNextDrink` for the initial seeds that `find` returns: `getCurrentSeeds`, then `adviseNextDrink`. Works with uncertain drinks.
+     */
+    std::vector<DrinkAdvice> adviseNextDrinkAfterRolls(SeedHelper& seedHelper, const std::vector<uint32_t>& initialSeeds, const RollSequence& rollSequence, size_t workersCount = 0);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_DRINK_ADVISOR_H
@@ -0,0 +1,197 @@
+#include "drink_planner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "../helpers/parallel.h"
+
+
+namespace DrinkPlanner {
+    using AbilityHelper::drinkChoicesCount;
+
+    /// Result of rolling at a cycle offset with a drink choice.
+    struct Outcome {
+        /// Seed advances used by the roll: 1 or 2.
+        uint8_t advance;
+        Ability ability;
+    };
+
+    /// How a DP cell was reached.
+    struct Parent {
+        uint8_t drinkChoiceIndex;
+        uint8_t advance;
+        uint8_t previousStreak;
+    };
+
+    constexpr uint32_t unreachable = UINT32_MAX;
+
+    /// A DP transition that completes the streak.
+    struct Goal {
+        size_t rollsCount;
+        uint32_t drinksCount;
+        /// Cell index in layer `rollsCount - 1`.
+        size_t previousIndex;
+        Parent parent;
+    };
+
+    /**
+     * `findParetoPlans` after all drinks are cached. Safe to call from multiple threads.
+     *
+     * @param stopAtFirstGoal Only the plan with the fewest rolls.
+     */
+    static std::vector<Plan> findParetoPlansWithCachedDrinks(const SeedHelper& seedHelper, const uint32_t seed, const Ability target, const size_t streakLength, const size_t horizon, const bool stopAtFirstGoal) {
+        if ((streakLength == 0) || (streakLength > UINT8_MAX)) {
+            throw std::invalid_argument("Invalid streak length.");
+        }
+        if (horizon > maxHorizon) {
+            throw std::invalid_argument("Horizon too large: " + std::to_string(horizon) + " (max " + std::to_string(maxHorizon) + ").");
+        }
+        if (horizon == 0) {
+            return {};
+        }
+
+        // Seeds and roll outcomes along the cycle.
+        const auto maxOffset = 2 * horizon;
+        std::vector<uint32_t> cycleSeeds(maxOffset + 1, seed);
+        for (size_t i = 1; i <= maxOffset; i += 1) {
+            cycleSeeds[i] = SeedHelper::advanceSeed(cycleSeeds[i - 1]);
+        }
+
+        /// Indices: offset * `drinkChoicesCount` + drink choice.
+        std::vector<Outcome> outcomes(maxOffset * drinkChoicesCount, Outcome{});
+        for (size_t offset = 0; offset + 2 <= maxOffset; offset += 1) {
+            for (size_t i = 0; i < drinkChoicesCount; i += 1) {
+                const auto drink = AbilityHelper::getDrinkChoice(i);
+                const auto [nextSeed, ability] = (drink == Ability::noDrink) ? seedHelper.generateRoll(cycleSeeds[offset]) : seedHelper.generateRollWithDrink(cycleSeeds[offset], drink);
+                outcomes[offset * drinkChoicesCount + i] = Outcome{static_cast<uint8_t>((nextSeed == cycleSeeds[offset + 1]) ? 1 : 2), ability};
+            }
+        }
+
+        // DP: Layer `t` (after `t` rolls) has cells (offset - t, streak) for offsets [t, 2t].
+        // Cells with the same offset and streak have the same future, so each cell only keeps its fewest drinks.
+        std::vector<std::vector<Parent>> parents(horizon);
+        std::vector<uint32_t> currentCosts(streakLength, unreachable);
+        currentCosts[0] = 0;
+
+        // Each goal has more rolls and fewer drinks than the previous one.
+        std::vector<Goal> goals{};
+        uint32_t goalCost = unreachable;
+
+        for (size_t t = 0; t < horizon; t += 1) {
+            std::vector<uint32_t> nextCosts((t + 2) * streakLength, unreachable);
+            auto& nextParents = parents[t];
+            nextParents.assign((t + 2) * streakLength, Parent{});
+            bool anyReachable = false;
+
+            for (size_t index = 0; index <= t; index += 1) {
+                const auto offset = t + index;
+                for (size_t streak = 0; streak < streakLength; streak += 1) {
+                    const auto cost = currentCosts[index * streakLength + streak];
+                    if ((cost == unreachable) || (cost >= goalCost)) {
+                        // Prune: Can't beat the best plan.
+                        continue;
+                    }
+
+                    for (size_t i = 0; i < drinkChoicesCount; i += 1) {
+                        const auto [advance, ability] = outcomes[offset * drinkChoicesCount + i];
+                        const auto nextCost = cost + ((i == 0) ? 0 : 1);
+                        const auto nextStreak = (ability == target) ? (streak + 1) : 0;
+                        const Parent parent{static_cast<uint8_t>(i), advance, static_cast<uint8_t>(streak)};
+
+                        if (nextStreak == streakLength) {
+                            // Layers are visited in roll order, so an equal cost never has fewer rolls.
+                            if (nextCost < goalCost) {
+                                const Goal goal{t + 1, nextCost, index, parent};
+                                if (!goals.empty() && (goals.back().rollsCount == goal.rollsCount)) {
+                                    goals.back() = goal;
+                                } else {
+                                    goals.push_back(goal);
+                                }
+                                goalCost = nextCost;
+                            }
+                        } else {
+                            const auto nextCell = (index + advance - 1) * streakLength + nextStreak;
+                            if (nextCost < nextCosts[nextCell]) {
+                                nextCosts[nextCell] = nextCost;
+                                nextParents[nextCell] = parent;
+                                anyReachable = true;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if ((stopAtFirstGoal && !goals.empty()) || (!anyReachable) || (goalCost == 0)) {
+                break;
+            }
+            currentCosts = std::move(nextCosts);
+        }
+
+        // Walk back from each goal.
+        std::vector<Plan> returnValue{};
+        returnValue.reserve(goals.size());
+        for (const auto& goal: goals) {
+            Plan plan{};
+            plan.drinksCount = goal.drinksCount;
+            plan.steps.resize(goal.rollsCount);
+
+            auto parent = goal.parent;
+            size_t index = goal.previousIndex;
+            for (size_t t = goal.rollsCount; t > 0; t -= 1) {
+                // `index` and `parent` describe the roll from layer `t - 1`.
+                const auto offset = (t - 1) + index;
+                const auto& outcome = outcomes[offset * drinkChoicesCount + parent.drinkChoiceIndex];
+                plan.steps[t - 1] = Step{AbilityHelper::getDrinkChoice(parent.drinkChoiceIndex), outcome.ability, cycleSeeds[offset + parent.advance]};
+
+                if (t > 1) {
+                    const auto previousStreak = parent.previousStreak;
+                    parent = parents[t - 2][index * streakLength + previousStreak];
+                    index = index + 1 - parent.advance;
+                }
+            }
+            returnValue.push_back(std::move(plan));
+        }
+
+        return returnValue;
+    }
+
+    /// `findPlan` after all drinks are cached. Safe to call from multiple threads.
+    static std::optional<Plan> findPlanWithCachedDrinks(const SeedHelper& seedHelper, const uint32_t seed, const Ability target, const size_t streakLength, const size_t horizon, const Objective objective) {
+        auto plans = findParetoPlansWithCachedDrinks(seedHelper, seed, target, streakLength, horizon, objective == Objective::fewestRolls);
+        if (plans.empty()) {
+            return std::nullopt;
+        }
+        // Fewest rolls first, fewest drinks last.
+        return (objective == Objective::fewestRolls) ? std::move(plans.front()) : std::move(plans.back());
+    }
+
+    std::optional<Plan> findPlan(SeedHelper& seedHelper, const uint32_t seed, const Ability target, const size_t streakLength, const size_t horizon, const Objective objective) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+        return findPlanWithCachedDrinks(seedHelper, seed, target, streakLength, horizon, objective);
+    }
+
+    std::vector<Plan> findParetoPlans(SeedHelper& seedHelper, const uint32_t seed, const Ability target, const size_t streakLength, const size_t horizon) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+        return findParetoPlansWithCachedDrinks(seedHelper, seed, target, streakLength, horizon, false);
+    }
+
+    std::vector<std::optional<Plan>> findPlansForAllAbilities(SeedHelper& seedHelper, const uint32_t seed, const size_t streakLength, const size_t horizon, const Objective objective, const size_t workersCount) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        const auto workerPlans = Parallel::mapRanges(AbilityHelper::abilitiesCount, workersCount, [&](const size_t start, const size_t stop) {
+            std::vector<std::optional<Plan>> plans{};
+            for (size_t i = start; i < stop; i += 1) {
+                plans.push_back(findPlanWithCachedDrinks(seedHelper, seed, static_cast<Ability>(i), streakLength, horizon, objective));
+            }
+            return plans;
+        });
+
+        std::vector<std::optional<Plan>> returnValue{};
+        returnValue.reserve(AbilityHelper::abilitiesCount);
+        for (const auto& plans: workerPlans) {
+            returnValue.insert(returnValue.end(), plans.begin(), plans.end());
+        }
+
+        return returnValue;
+    }
+}
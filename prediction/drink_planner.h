@@ -0,0 +1,68 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_DRINK_PLANNER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_DRINK_PLANNER_H
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "../seed_helper.h"
+
+
+/**
+ * Finds the cheapest per-roll drink choices that reach a streak of a target ability.
+ *
+ * Every roll advances the seed by 1 or 2 steps along the RNG's cycle.
+ * So after `t` rolls, the seed is one of the `t + 1` seeds at cycle offsets [t, 2t] from the start seed.
+ * The search is a DP over (roll count, cycle offset, current streak), which is O(horizon^2 * streak length).
+ */
+namespace DrinkPlanner {
+    /// The DP keeps O(horizon^2 * streak length) parents (~75 MB for 3-streaks at this horizon).
+    constexpr size_t maxHorizon = 4096;
+
+    enum class Objective {
+        /// Fewest rolls, then fewest drinks.
+        fewestRolls,
+        /// Fewest drinks, then fewest rolls.
+        fewestDrinks,
+    };
+
+    struct Step {
+        /// `Ability::noDrink` or a drink.
+        Ability drink;
+        Ability ability;
+        /// Seed after this roll.
+        uint32_t seed;
+    };
+
+    struct Plan {
+        std::vector<Step> steps;
+        size_t drinksCount;
+    };
+
+    /**
+     * @param seed Seed after the last logged roll.
+     * @param streakLength Number of `target` rolls in a row (1 to 255).
+     * @param horizon Max number of rolls (up to `maxHorizon`).
+     * @return `std::nullopt` if `target` streak can't be reached within `horizon` rolls.
+     * @throws std::invalid_argument if `streakLength` or `horizon` is out of range.
+     */
+    std::optional<Plan> findPlan(SeedHelper& seedHelper, uint32_t seed, Ability target, size_t streakLength = 3, size_t horizon = 100, Objective objective = Objective::fewestRolls);
+
+    /**
+     * Every plan that no other plan beats on both rolls and drinks.
+     * The first plan is `Objective::fewestRolls`'s, and the last is `Objective::fewestDrinks`'s.
+     *
+     * @return Sorted by rolls (ascending), so drinks are descending. Empty if `target` streak can't be reached within `horizon` rolls.
+     */
+    std::vector<Plan> findParetoPlans(SeedHelper& seedHelper, uint32_t seed, Ability target, size_t streakLength = 3, size_t horizon = 100);
+
+    /**
+     * `findPlan` for every ability, in parallel.
+     *
+     * @return Indices correspond to `Ability`'s values.
+     */
+    std::vector<std::optional<Plan>> findPlansForAllAbilities(SeedHelper& seedHelper, uint32_t seed, size_t streakLength = 3, size_t horizon = 100, Objective objective = Objective::fewestRolls, size_t workersCount = 0);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_DRINK_PLANNER_H
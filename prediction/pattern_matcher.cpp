@@ -0,0 +1,160 @@
+#include "pattern_matcher.h"
+
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+
+#pragma mark - Constructor
+PatternMatcher::PatternMatcher(const std::vector<Pattern>& patterns) {
+    constexpr auto abilitiesCount = AbilityHelper::abilitiesCount;
+    constexpr State noState = UINT32_MAX;
+
+    // Root.
+    transitions.assign(abilitiesCount, noState);
+    outputs.emplace_back();
+
+    // Trie: Each pattern is inserted once per concrete ability sequence it matches.
+    patternLengths.reserve(patterns.size());
+    for (size_t i = 0; i < patterns.size(); i += 1) {
+        const auto& pattern = patterns[i];
+        if (pattern.empty()) {
+            throw std::invalid_argument("Empty pattern.");
+        }
+        patternLengths.push_back(pattern.size());
+
+        std::vector<State> frontier{initialState};
+        for (const auto abilities: pattern) {
+            if ((abilities.getMask() & AbilitySet::allAbilitiesMask) == 0) {
+                throw std::invalid_argument("Empty ability set in pattern.");
+            }
+
+            std::vector<State> nextFrontier{};
+            for (const auto state: frontier) {
+                for (size_t j = 0; j < abilitiesCount; j += 1) {
+                    if (!abilities.contains(static_cast<Ability>(j))) {
+                        continue;
+                    }
+
+                    auto& child = transitions[state * abilitiesCount + j];
+                    if (child == noState) {
+                        if (outputs.size() >= maxStatesCount) {
+                            throw std::invalid_argument("Patterns expand to too many states.");
+                        }
+
+                        child = static_cast<State>(outputs.size());
+                        outputs.emplace_back();
+                        transitions.resize(transitions.size() + abilitiesCount, noState);
+                    }
+                    // `transitions` may have been reallocated.
+                    nextFrontier.push_back(transitions[state * abilitiesCount + j]);
+                }
+            }
+            frontier = std::move(nextFrontier);
+        }
+
+        for (const auto state: frontier) {
+            outputs[state].push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Failure links (BFS), folded into `transitions` to make a DFA.
+    std::vector<State> failureLinks(outputs.size(), initialState);
+    outputLinks.assign(outputs.size(), initialState);
+
+    std::queue<State> queue{};
+    for (size_t j = 0; j < abilitiesCount; j += 1) {
+        auto& child = transitions[j];
+        if (child == noState) {
+            child = initialState;
+        } else {
+            queue.push(child);
+        }
+    }
+
+    while (!queue.empty()) {
+        const auto state = queue.front();
+        queue.pop();
+
+        for (size_t j = 0; j < abilitiesCount; j += 1) {
+            const auto fallback = transitions[failureLinks[state] * abilitiesCount + j];
+            auto& child = transitions[state * abilitiesCount + j];
+            if (child == noState) {
+                child = fallback;
+                continue;
+            }
+
+            failureLinks[child] = fallback;
+            outputLinks[child] = outputs[fallback].empty() ? outputLinks[fallback] : fallback;
+            queue.push(child);
+        }
+    }
+}
+
+
+#pragma mark - Patterns
+PatternMatcher::Pattern PatternMatcher::parsePattern(std::string_view str) {
+    Pattern returnValue{};
+
+    size_t rollStart = 0;
+    while (rollStart < str.size()) {
+        auto rollStop = str.find(' ', rollStart);
+        if (rollStop == std::string_view::npos) {
+            rollStop = str.size();
+        }
+
+        if (rollStop > rollStart) {
+            AbilitySet abilities{};
+            const auto roll = str.substr(rollStart, rollStop - rollStart);
+
+            size_t idStart = 0;
+            while (idStart <= roll.size()) {
+                auto idStop = roll.find(',', idStart);
+                if (idStop == std::string_view::npos) {
+                    idStop = roll.size();
+                }
+
+                const auto ability = AbilityHelper::fromId(roll.substr(idStart, idStop - idStart));
+                if (ability == Ability::noDrink) {
+                    throw std::invalid_argument("Invalid ability in pattern.");
+                }
+                abilities.insert(ability);
+
+                idStart = idStop + 1;
+            }
+
+            returnValue.push_back(abilities);
+        }
+
+        rollStart = rollStop + 1;
+    }
+
+    if (returnValue.empty()) {
+        std::string exceptionMessage{"Empty pattern: "};
+        exceptionMessage += str;
+        throw std::invalid_argument(exceptionMessage);
+    }
+
+    return returnValue;
+}
+
+PatternMatcher::Pattern PatternMatcher::makeStreakPattern(const Ability ability, const size_t length) {
+    return Pattern(length, AbilitySet{ability});
+}
+
+
+#pragma mark - Matching
+std::vector<PatternMatcher::Match> PatternMatcher::findMatches(const std::vector<Ability>& rolls) const {
+    std::vector<Match> returnValue{};
+    auto onMatch = [&returnValue](const Match& match) {
+        returnValue.push_back(match);
+    };
+
+    State state = initialState;
+    for (size_t i = 0; i < rolls.size(); i += 1) {
+        state = advance(state, rolls[i]);
+        forEachMatch(state, i, onMatch);
+    }
+
+    return returnValue;
+}
@@ -0,0 +1,120 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_PATTERN_MATCHER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_PATTERN_MATCHER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../data/ability_set.h"
+#include "../roll_range.h"
+
+
+/**
+ * Aho-Corasick automaton that finds many roll patterns at once.
+ *
+ * A pattern is a sequence of ability sets, e.g.:
+ *
+ * - `A A B`: `{A}, {A}, {B}`
+ * - Any 3 of A/B in a row: `{A, B}, {A, B}, {A, B}`
+ *
+ * Ability sets are expanded into the trie, so the automaton is a plain DFA over the 14 abilities:
+ * Each roll costs one table lookup, plus one step per reported match.
+ */
+class PatternMatcher {
+public:
+    using Pattern = std::vector<AbilitySet>;
+
+    /// Automaton state. Start from `initialState`.
+    using State = uint32_t;
+    static constexpr State initialState = 0;
+
+    /// Expanding ability sets into the trie must not exceed this many states.
+    static constexpr size_t maxStatesCount = 1 << 20;
+
+    struct Match {
+        size_t patternIndex;
+
+        /// Index of the pattern's first roll.
+        size_t start;
+
+        friend bool operator==(const Match& lhs, const Match& rhs) {
+            return (lhs.patternIndex == rhs.patternIndex) && (lhs.start == rhs.start);
+        }
+    };
+
+private:
+    std::vector<size_t> patternLengths;
+
+    /// Indices: `state * abilitiesCount + ability`.
+    std::vector<State> transitions;
+
+    /// Patterns that end exactly at each state.
+    std::vector<std::vector<uint32_t>> outputs;
+
+    /// Nearest proper suffix state with outputs, or `initialState` if there's none.
+    std::vector<State> outputLinks;
+
+public:
+    /**
+     * @throws std::invalid_argument if a pattern is empty, contains an empty set, or expands to too many states.
+     */
+    explicit PatternMatcher(const std::vector<Pattern>& patterns);
+
+    /**
+     * Parse a pattern: Space separated rolls, each a comma separated list of ability IDs.
+     * `unknown` matches any ability.
+     *
+     * e.g. `ink_saver_main ink_saver_main run_speed_up`, `ink_saver_main,run_speed_up ink_saver_main,run_speed_up`
+     */
+    static Pattern parsePattern(std::string_view str);
+
+    /// A streak of `length` rolls of `ability`.
+    static Pattern makeStreakPattern(Ability ability, size_t length = 3);
+
+public:
+    [[nodiscard]] size_t getPatternsCount() const {
+        return patternLengths.size();
+    }
+
+    [[nodiscard]] size_t getStatesCount() const {
+        return outputs.size();
+    }
+
+    [[nodiscard]] State advance(const State state, const Ability roll) const {
+        return transitions[state * AbilityHelper::abilitiesCount + AbilityHelper::getIndex(roll)];
+    }
+
+    /// Call `onMatch(Match)` for each pattern that ends at `state`, where `position` is the index of the latest roll.
+    template <typename Callback>
+    void forEachMatch(const State state, const size_t position, Callback& onMatch) const {
+        for (State s = state; s != initialState; s = outputLinks[s]) {
+            for (const auto patternIndex: outputs[s]) {
+                onMatch(Match{patternIndex, position + 1 - patternLengths[patternIndex]});
+            }
+        }
+    }
+
+#pragma mark - Matching
+public:
+    /// Find all matches in `rolls` (no `Ability::unknown`), ordered by end position.
+    [[nodiscard]] std::vector<Match> findMatches(const std::vector<Ability>& rolls) const;
+
+    /**
+     * Stream `length` rolls from `seed` through the automaton without storing them, and call `onMatch(Match)` on each match.
+     *
+     * `drink` must be cached if it's not `Ability::noDrink`.
+     */
+    template <typename Callback>
+    void scanRolls(const SeedHelper& seedHelper, const uint32_t seed, const Ability drink, const size_t length, Callback onMatch) const {
+        State state = initialState;
+        size_t i = 0;
+        for (const auto& roll: RollRange{seedHelper, seed, drink, length}) {
+            state = advance(state, roll.ability);
+            forEachMatch(state, i, onMatch);
+            i += 1;
+        }
+    }
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_PATTERN_MATCHER_H
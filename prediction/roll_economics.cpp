@@ -0,0 +1,304 @@
+#include "roll_economics.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "../helpers/parallel.h"
+
+
+namespace RollEconomics {
+    namespace {
+        /// Seeds generated at once, before the (separate) ability and streak passes over them.
+        constexpr size_t blockSize = 1 << 16;
+
+        void validate(const size_t streakLength, const size_t horizon) {
+            if ((streakLength == 0) || (streakLength > horizon)) {
+                throw std::invalid_argument("Streak length must be 1 to the horizon.");
+            }
+        }
+
+        /// SplitMix64: Independent random seeds per sample index.
+        uint32_t getRandomSeed(const uint64_t randomSeed, const uint64_t index) {
+            auto value = randomSeed + (index + 1) * 0x9e3779b97f4a7c15;
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+            value ^= value >> 31;
+            // Non-zero (0 isn't on the seed cycle).
+            return static_cast<uint32_t>(1 + value % SeedHelper::cycleLength);
+        }
+
+        /// Histogram counts as a difference array, so that ranges of rolls are added in O(1).
+        struct RangeHistogram {
+            std::vector<int64_t> differences;
+            uint64_t overflowCount;
+
+            explicit RangeHistogram(const size_t horizon): differences(horizon + 2, 0), overflowCount{0} {}
+
+            /// 1 seed for each rolls count in [low, high].
+            void addRange(const uint64_t low, const uint64_t high) {
+                const uint64_t horizon = differences.size() - 2;
+                if (high > horizon) {
+                    overflowCount += high - std::max(low, horizon + 1) + 1;
+                }
+                if (low <= horizon) {
+                    differences[low] += 1;
+                    differences[std::min(high, horizon) + 1] -= 1;
+                }
+            }
+        };
+
+        /// `Histogram` has no default constructor.
+        template <size_t... i>
+        std::array<Histogram, sizeof...(i)> makeHistograms(const size_t streakLength, const size_t horizon, std::index_sequence<i...>) {
+            return {(static_cast<void>(i), Histogram{streakLength, horizon})...};
+        }
+    }
+
+
+#pragma mark - Histogram
+    Histogram::Histogram(const size_t streakLength, const size_t horizon): streakLength{streakLength}, horizon{horizon}, counts(horizon + 1, 0), overflowCount{0} {}
+
+    Histogram& Histogram::operator+=(const Histogram& other) {
+        if ((streakLength != other.streakLength) || (horizon != other.horizon)) {
+            throw std::invalid_argument("Cannot merge histograms with different streak lengths or horizons.");
+        }
+
+        for (size_t i = 0; i < counts.size(); i += 1) {
+            counts[i] += other.counts[i];
+        }
+        overflowCount += other.overflowCount;
+        return *this;
+    }
+
+    uint64_t Histogram::getTotalCount() const {
+        uint64_t returnValue = overflowCount;
+        for (const auto count: counts) {
+            returnValue += count;
+        }
+        return returnValue;
+    }
+
+    double Histogram::getMean() const {
+        const auto totalCount = getTotalCount();
+        if (totalCount == 0) {
+            return 0;
+        }
+
+        double sum = static_cast<double>(overflowCount) * static_cast<double>(horizon + 1);
+        for (size_t i = 0; i < counts.size(); i += 1) {
+            sum += static_cast<double>(counts[i]) * static_cast<double>(i);
+        }
+        return sum / static_cast<double>(totalCount);
+    }
+
+    std::optional<size_t> Histogram::getQuantile(const double probability) const {
+        const auto totalCount = getTotalCount();
+        uint64_t cumulativeCount = 0;
+        for (size_t i = 0; i < counts.size(); i += 1) {
+            cumulativeCount += counts[i];
+            if (static_cast<double>(cumulativeCount) >= probability * static_cast<double>(totalCount)) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+
+#pragma mark - Single seed
+    size_t getRollsNeeded(const SeedHelper& seedHelper, uint32_t seed, const Ability target, const Ability drink, const size_t streakLength, const size_t horizon) {
+        size_t streak = 0;
+        for (size_t rollsCount = 1; rollsCount <= horizon; rollsCount += 1) {
+            Ability ability;
+            std::tie(seed, ability) = (drink == Ability::noDrink) ? seedHelper.generateRoll(seed) : seedHelper.generateRollWithDrink(seed, drink);
+            streak = (ability == target) ? (streak + 1) : 0;
+            if (streak == streakLength) {
+                return rollsCount;
+            }
+        }
+        return horizon + 1;
+    }
+
+
+#pragma mark - Exhaustive
+    std::array<Histogram, AbilityHelper::abilitiesCount> sweepNoDrink(const SeedHelper& seedHelper, const size_t streakLength, const size_t horizon, const size_t workersCount, const uint64_t positionsCount) {
+        using AbilityHelper::abilitiesCount;
+        validate(streakLength, horizon);
+
+        const auto workerResults = Parallel::mapRanges(positionsCount, workersCount, [&](const uint64_t start, const uint64_t stop) {
+            std::vector<RangeHistogram> histograms(abilitiesCount, RangeHistogram{horizon});
+            if (start == stop) {
+                return histograms;
+            }
+
+            // Each ability's first seed (position) without a streak yet.
+            std::array<uint64_t, abilitiesCount> nextUnresolvedPositions{};
+            nextUnresolvedPositions.fill(start);
+
+            // Roll `p` is the roll from the seed at position `p`. The last seed's streak must end by roll `stop - 1 + horizon - 1`.
+            const auto walkStop = stop + horizon - 1;
+            auto seed = SeedHelper::seedAtPosition(static_cast<uint32_t>(start % SeedHelper::cycleLength));
+            std::vector<uint32_t> seeds(blockSize);
+            std::vector<uint8_t> abilities(blockSize);
+            uint8_t previousAbility = abilitiesCount;
+            size_t streak = 0;
+
+            for (auto blockStart = start; blockStart < walkStop; blockStart += blockSize) {
+                const auto count = static_cast<size_t>(std::min<uint64_t>(blockSize, walkStop - blockStart));
+                for (size_t i = 0; i < count; i += 1) {
+                    seed = SeedHelper::advanceSeed(seed);
+                    seeds[i] = seed;
+                }
+                for (size_t i = 0; i < count; i += 1) {
+                    abilities[i] = static_cast<uint8_t>(AbilityHelper::getIndex(seedHelper.getBrandedAbility(seeds[i])));
+                }
+
+                for (size_t i = 0; i < count; i += 1) {
+                    const auto ability = abilities[i];
+                    streak = (ability == previousAbility) ? (streak + 1) : 1;
+                    previousAbility = ability;
+                    if (streak < streakLength) {
+                        continue;
+                    }
+
+                    // A streak ending at roll `p` resolves every waiting seed up to position `p + 1 - streakLength`.
+                    const auto position = blockStart + i;
+                    const auto lastPosition = std::min(position + 1 - streakLength, stop - 1);
+                    auto& nextUnresolvedPosition = nextUnresolvedPositions[ability];
+                    if (nextUnresolvedPosition <= lastPosition) {
+                        histograms[ability].addRange(position + 1 - lastPosition, position + 1 - nextUnresolvedPosition);
+                        nextUnresolvedPosition = lastPosition + 1;
+                    }
+                }
+
+                if (*std::min_element(nextUnresolvedPositions.begin(), nextUnresolvedPositions.end()) >= stop) {
+                    break;
+                }
+            }
+
+            for (size_t i = 0; i < abilitiesCount; i += 1) {
+                histograms[i].overflowCount += stop - std::min(nextUnresolvedPositions[i], stop);
+            }
+            return histograms;
+        });
+
+        // Merge, then sum up the differences.
+        auto returnValue = makeHistograms(streakLength, horizon, std::make_index_sequence<abilitiesCount>{});
+        for (size_t i = 0; i < abilitiesCount; i += 1) {
+            int64_t count = 0;
+            for (size_t rollsCount = 0; rollsCount <= horizon; rollsCount += 1) {
+                for (const auto& histograms: workerResults) {
+                    count += histograms[i].differences[rollsCount];
+                }
+                returnValue[i].counts[rollsCount] = static_cast<uint64_t>(count);
+            }
+            for (const auto& histograms: workerResults) {
+                returnValue[i].overflowCount += histograms[i].overflowCount;
+            }
+        }
+
+        return returnValue;
+    }
+
+    Histogram sweep(const SeedHelper& seedHelper, const Ability target, const Ability drink, const size_t streakLength, const size_t horizon, const size_t workersCount, const uint64_t positionsCount) {
+        if (drink == Ability::noDrink) {
+            return sweepNoDrink(seedHelper, streakLength, horizon, workersCount, positionsCount)[AbilityHelper::getIndex(target)];
+        }
+        validate(streakLength, horizon);
+
+        const auto workerResults = Parallel::mapRanges(positionsCount, workersCount, [&](const uint64_t start, const uint64_t stop) {
+            Histogram histogram{streakLength, horizon};
+            if (start == stop) {
+                return histogram;
+            }
+
+            // Rolls needed, capped: `horizon + 1` means beyond the horizon.
+            // Each roll advances 1 or 2 positions, so `horizon + 1` rolls from `stop` stay before `walkStop`. Unknown positions start as beyond the horizon.
+            const auto maxRollsNeeded = horizon + 1;
+            const auto walkStop = stop + 2 * maxRollsNeeded;
+
+            // (rolls needed, streak of `target` rolls starting there) 1 and 2 positions ahead.
+            size_t nextRollsNeeded = maxRollsNeeded;
+            size_t secondNextRollsNeeded = maxRollsNeeded;
+            size_t nextStreak = 0;
+            size_t secondNextStreak = 0;
+
+            std::vector<uint32_t> seeds(blockSize + 2);
+            std::vector<uint8_t> advancesTwice(blockSize);
+            std::vector<uint8_t> isTarget(blockSize);
+
+            for (auto blockStop = walkStop; blockStop > start;) {
+                const auto blockStart = (blockStop - start > blockSize) ? (blockStop - blockSize) : start;
+                const auto count = static_cast<size_t>(blockStop - blockStart);
+
+                // Forwards: Seeds, then each position's roll.
+                seeds[0] = SeedHelper::seedAtPosition(static_cast<uint32_t>(blockStart % SeedHelper::cycleLength));
+                for (size_t i = 1; i < count + 2; i += 1) {
+                    seeds[i] = SeedHelper::advanceSeed(seeds[i - 1]);
+                }
+                for (size_t i = 0; i < count; i += 1) {
+                    // Same as `SeedHelper::generateRollWithDrink`.
+                    const auto isDrinkRoll = (seeds[i + 1] % 100) <= 29;
+                    advancesTwice[i] = !isDrinkRoll;
+                    isTarget[i] = isDrinkRoll ? (drink == target) : (seedHelper.getBrandedAbilityWithDrink(seeds[i + 2], drink) == target);
+                }
+
+                // Backwards: Rolls needed from each position.
+                for (size_t i = count; i-- > 0;) {
+                    const auto followingRollsNeeded = advancesTwice[i] ? secondNextRollsNeeded : nextRollsNeeded;
+                    const auto followingStreak = advancesTwice[i] ? secondNextStreak : nextStreak;
+
+                    const auto streak = isTarget[i] ? std::min(followingStreak + 1, streakLength) : 0;
+                    const auto rollsNeeded = (streak == streakLength) ? streakLength : std::min(followingRollsNeeded + 1, maxRollsNeeded);
+                    if (blockStart + i < stop) {
+                        if (rollsNeeded == maxRollsNeeded) {
+                            histogram.overflowCount += 1;
+                        } else {
+                            histogram.counts[rollsNeeded] += 1;
+                        }
+                    }
+
+                    secondNextRollsNeeded = nextRollsNeeded;
+                    secondNextStreak = nextStreak;
+                    nextRollsNeeded = rollsNeeded;
+                    nextStreak = streak;
+                }
+
+                blockStop = blockStart;
+            }
+
+            return histogram;
+        });
+
+        Histogram returnValue{streakLength, horizon};
+        for (const auto& histogram: workerResults) {
+            returnValue += histogram;
+        }
+        return returnValue;
+    }
+
+
+#pragma mark - Sampled
+    Histogram sample(const SeedHelper& seedHelper, const Ability target, const Ability drink, const uint64_t samplesCount, const uint64_t randomSeed, const size_t streakLength, const size_t horizon, const size_t workersCount) {
+        validate(streakLength, horizon);
+
+        const auto workerResults = Parallel::mapRanges(samplesCount, workersCount, [&](const uint64_t start, const uint64_t stop) {
+            Histogram histogram{streakLength, horizon};
+            for (auto i = start; i < stop; i += 1) {
+                const auto rollsNeeded = getRollsNeeded(seedHelper, getRandomSeed(randomSeed, i), target, drink, streakLength, horizon);
+                if (rollsNeeded > horizon) {
+                    histogram.overflowCount += 1;
+                } else {
+                    histogram.counts[rollsNeeded] += 1;
+                }
+            }
+            return histogram;
+        });
+
+        Histogram returnValue{streakLength, horizon};
+        for (const auto& histogram: workerResults) {
+            returnValue += histogram;
+        }
+        return returnValue;
+    }
+}
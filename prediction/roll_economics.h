@@ -0,0 +1,80 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_ROLL_ECONOMICS_H
+#define SPLATOON_3_GEAR_HELPER_CPP_ROLL_ECONOMICS_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "../seed_helper.h"
+
+
+/**
+ * Distribution of "rolls needed for a streak of `target`" over initial seeds, for gear whose seed isn't known yet.
+ *
+ * - Exhaustive (`sweep`): Every non-zero seed, i.e. every position of `advanceSeed`'s cycle
+ * - Sampled (`sample`): Monte Carlo over random seeds
+ *
+ * A strategy is 1 drink (or `Ability::noDrink`) held for every roll.
+ */
+namespace RollEconomics {
+    /// Long enough for no-drink 3-streaks (~2.7k rolls on average for a neutral brand).
+    constexpr size_t defaultHorizon = 1 << 15;
+
+    struct Histogram {
+        size_t streakLength;
+        size_t horizon;
+        /// Index: Rolls needed, [0, horizon]. Indices below `streakLength` are always 0.
+        std::vector<uint64_t> counts;
+        /// Seeds without a streak within `horizon` rolls.
+        uint64_t overflowCount;
+
+        Histogram(size_t streakLength, size_t horizon);
+
+        Histogram& operator+=(const Histogram& other);
+
+        [[nodiscard]] uint64_t getTotalCount() const;
+
+        /// Overflowing seeds count as `horizon + 1` rolls, so this is a lower bound if `overflowCount > 0`.
+        [[nodiscard]] double getMean() const;
+
+        /// Fewest rolls that reach the streak for at least `probability` of seeds, or `std::nullopt` if beyond the horizon.
+        [[nodiscard]] std::optional<size_t> getQuantile(double probability) const;
+    };
+
+    /**
+     * Rolls needed from `seed` until `streakLength` `target` rolls in a row, holding `drink`.
+     *
+     * @return `horizon + 1` if there's no streak within `horizon` rolls.
+     */
+    size_t getRollsNeeded(const SeedHelper& seedHelper, uint32_t seed, Ability target, Ability drink, size_t streakLength, size_t horizon);
+
+    /**
+     * Exhaustive no-drink distributions of all abilities, in 1 pass.
+     *
+     * A no-drink roll advances the seed once, so seeds along the cycle share their rolls:
+     * Each worker walks a segment of the cycle (starting at `SeedHelper::seedAtPosition`), and each streak resolves every earlier seed still waiting for it.
+     *
+     * @param positionsCount Seeds at cycle positions [0, positionsCount) only (e.g. tests). Default: All non-zero seeds.
+     * @return Indices correspond to `Ability`'s values.
+     */
+    std::array<Histogram, AbilityHelper::abilitiesCount> sweepNoDrink(const SeedHelper& seedHelper, size_t streakLength = 3, size_t horizon = defaultHorizon, size_t workersCount = 0, uint64_t positionsCount = SeedHelper::cycleLength);
+
+    /**
+     * Exhaustive distribution of 1 strategy.
+     *
+     * With a drink, each roll advances the seed 1 or 2 times, so each worker runs a DP backwards over its segment:
+     * rolls needed(p) = streak length if the rolls from p start a streak, else 1 + rolls needed(next position).
+     * Segments are generated forwards in blocks, then scanned backwards. `drink` must be cached.
+     */
+    Histogram sweep(const SeedHelper& seedHelper, Ability target, Ability drink, size_t streakLength = 3, size_t horizon = defaultHorizon, size_t workersCount = 0, uint64_t positionsCount = SeedHelper::cycleLength);
+
+    /**
+     * Monte Carlo estimate of `sweep` from `samplesCount` random non-zero seeds.
+     * The same `randomSeed` gives the same histogram, for any workers count. `drink` must be cached.
+     */
+    Histogram sample(const SeedHelper& seedHelper, Ability target, Ability drink, uint64_t samplesCount, uint64_t randomSeed = 0, size_t streakLength = 3, size_t horizon = defaultHorizon, size_t workersCount = 0);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_ROLL_ECONOMICS_H
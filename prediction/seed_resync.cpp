@@ -0,0 +1,166 @@
+#include "seed_resync.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <unordered_map>
+
+
+namespace SeedResync {
+    /// How a seed of a layer was reached.
+    struct State {
+        /// Seed in the same layer (`unloggedRoll`), or in the previous layer (logged roll).
+        uint32_t previousSeed;
+        uint8_t editsCount;
+        /// 0: Logged roll as logged, or the start seed. Else `EditKind` + 1.
+        uint8_t editKind;
+    };
+
+    constexpr auto unloggedRollKind = static_cast<uint8_t>(static_cast<uint8_t>(EditKind::unloggedRoll) + 1);
+    constexpr auto unloggedDrinkKind = static_cast<uint8_t>(static_cast<uint8_t>(EditKind::unloggedDrink) + 1);
+
+    /// Layer `i`: Seeds after `i` logged rolls (and any unlogged rolls before logged roll `i`).
+    using Layer = std::unordered_map<uint32_t, State>;
+
+    /// Insert or keep the state with fewer edits.
+    static void insertState(Layer& layer, const uint32_t seed, const State state) {
+        const auto [it, isNew] = layer.emplace(seed, state);
+        if (!isNew && (state.editsCount < it->second.editsCount)) {
+            it->second = state;
+        }
+    }
+
+    /// Add the seeds reachable with unlogged rolls to `layer`, fewest edits first.
+    static void expandUnloggedRolls(const SeedHelper& seedHelper, Layer& layer, const size_t maxEditsCount) {
+        std::vector<std::vector<uint32_t>> seedsByEditsCount(maxEditsCount + 1);
+        for (const auto& [seed, state]: layer) {
+            seedsByEditsCount[state.editsCount].push_back(seed);
+        }
+
+        std::array<uint32_t, 2> nextSeeds{};
+        for (size_t editsCount = 0; editsCount < maxEditsCount; editsCount += 1) {
+            // Sorted, so that equal edits counts always keep the same parent.
+            auto& seeds = seedsByEditsCount[editsCount];
+            std::sort(seeds.begin(), seeds.end());
+            for (const auto seed: seeds) {
+                if (layer.at(seed).editsCount != editsCount) {
+                    // Reached again with fewer edits.
+                    continue;
+                }
+
+                const auto nextSeedsCount = seedHelper.generateRollWithDrinks(seed, AbilitySet::anyDrink(), Ability::unknown, nextSeeds);
+                for (size_t i = 0; i < nextSeedsCount; i += 1) {
+                    const State nextState{seed, static_cast<uint8_t>(editsCount + 1), unloggedRollKind};
+                    const auto [it, isNew] = layer.emplace(nextSeeds[i], nextState);
+                    if (isNew || (nextState.editsCount < it->second.editsCount)) {
+                        it->second = nextState;
+                        seedsByEditsCount[editsCount + 1].push_back(nextSeeds[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<Alignment> findAlignments(SeedHelper& seedHelper, const uint32_t seed, const RollSequence& rollSequence, const size_t startIndex, const size_t maxEditsCount) {
+        if (maxEditsCount > UINT8_MAX) {
+            throw std::invalid_argument("Too many edits: " + std::to_string(maxEditsCount));
+        }
+        if (startIndex > rollSequence.size()) {
+            throw std::invalid_argument("Start index is after the last roll.");
+        }
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        const auto rollsCount = rollSequence.size() - startIndex;
+        std::vector<Layer> layers(rollsCount + 1);
+        layers[0].emplace(seed, State{seed, 0, 0});
+
+        std::array<uint32_t, 2> nextSeeds{};
+        std::array<uint32_t, 2> otherDrinkNextSeeds{};
+        for (size_t i = 0; i < rollsCount; i += 1) {
+            expandUnloggedRolls(seedHelper, layers[i], maxEditsCount);
+
+            const auto [abilities, drinks] = *(rollSequence.begin() + static_cast<std::ptrdiff_t>(startIndex + i));
+            auto& nextLayer = layers[i + 1];
+            for (const auto& [currentSeed, state]: layers[i]) {
+                const auto nextSeedsCount = seedHelper.generateRollWithDrinks(currentSeed, drinks, abilities, nextSeeds);
+                for (size_t j = 0; j < nextSeedsCount; j += 1) {
+                    insertState(nextLayer, nextSeeds[j], State{currentSeed, state.editsCount, 0});
+                }
+
+                if ((state.editsCount == maxEditsCount) || (drinks.getMask() == AbilitySet::anyDrink().getMask())) {
+                    continue;
+                }
+                const auto otherDrinkNextSeedsCount = seedHelper.generateRollWithDrinks(currentSeed, AbilitySet::anyDrink(), abilities, otherDrinkNextSeeds);
+                for (size_t j = 0; j < otherDrinkNextSeedsCount; j += 1) {
+                    if (std::find(nextSeeds.begin(), nextSeeds.begin() + static_cast<std::ptrdiff_t>(nextSeedsCount), otherDrinkNextSeeds[j]) == nextSeeds.begin() + static_cast<std::ptrdiff_t>(nextSeedsCount)) {
+                        insertState(nextLayer, otherDrinkNextSeeds[j], State{currentSeed, static_cast<uint8_t>(state.editsCount + 1), unloggedDrinkKind});
+                    }
+                }
+            }
+
+            if (nextLayer.empty()) {
+                // Prune: No alignment within `maxEditsCount` edits.
+                return {};
+            }
+        }
+
+        // Walk back from each final seed.
+        std::vector<Alignment> returnValue{};
+        returnValue.reserve(layers[rollsCount].size());
+        for (const auto& [finalSeed, finalState]: layers[rollsCount]) {
+            Alignment alignment{finalSeed, {}};
+            alignment.edits.reserve(finalState.editsCount);
+
+            auto currentSeed = finalSeed;
+            auto layerIndex = rollsCount;
+            while (true) {
+                const auto& state = layers[layerIndex].at(currentSeed);
+                if (state.editKind == unloggedRollKind) {
+                    // From the same layer.
+                    alignment.edits.push_back(Edit{EditKind::unloggedRoll, startIndex + layerIndex});
+                } else if (layerIndex == 0) {
+                    // Start seed.
+                    break;
+                } else {
+                    if (state.editKind == unloggedDrinkKind) {
+                        alignment.edits.push_back(Edit{EditKind::unloggedDrink, startIndex + layerIndex - 1});
+                    }
+                    layerIndex -= 1;
+                }
+                currentSeed = state.previousSeed;
+            }
+            std::reverse(alignment.edits.begin(), alignment.edits.end());
+            returnValue.push_back(std::move(alignment));
+        }
+
+        std::sort(returnValue.begin(), returnValue.end(), [](const Alignment& lhs, const Alignment& rhs) {
+            return (lhs.edits.size() != rhs.edits.size()) ? (lhs.edits.size() < rhs.edits.size()) : (lhs.finalSeed < rhs.finalSeed);
+        });
+        return returnValue;
+    }
+
+    size_t getVerifiedRollsCount(SeedHelper& seedHelper, const uint32_t seed, const RollSequence& rollSequence) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        // Uncertain drinks may leave more than 1 seed.
+        std::vector<uint32_t> seeds{seed};
+        std::array<uint32_t, 2> nextSeeds{};
+        size_t returnValue = 0;
+        for (const auto [abilities, drinks]: rollSequence) {
+            std::vector<uint32_t> currentNextSeeds{};
+            for (const auto currentSeed: seeds) {
+                const auto nextSeedsCount = seedHelper.generateRollWithDrinks(currentSeed, drinks, abilities, nextSeeds);
+                currentNextSeeds.insert(currentNextSeeds.end(), nextSeeds.begin(), nextSeeds.begin() + static_cast<std::ptrdiff_t>(nextSeedsCount));
+            }
+            if (currentNextSeeds.empty()) {
+                break;
+            }
+
+            std::sort(currentNextSeeds.begin(), currentNextSeeds.end());
+            currentNextSeeds.erase(std::unique(currentNextSeeds.begin(), currentNextSeeds.end()), currentNextSeeds.end());
+            seeds = std::move(currentNextSeeds);
+            returnValue += 1;
+        }
+        return returnValue;
+    }
+}
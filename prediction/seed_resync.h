@@ -0,0 +1,52 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_SEED_RESYNC_H
+#define SPLATOON_3_GEAR_HELPER_CPP_SEED_RESYNC_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../seed_helper.h"
+
+
+/**
+ * Re-aligns a known seed with logged rolls that no longer match it, because some rolls or drinks weren't logged.
+ *
+ * Searches forwards from the last verified seed, 1 logged roll at a time. Between logged rolls, an unlogged roll
+ * (any drink or none, any ability) advances the seed by 1 or 2. A logged roll may also have used another drink than the logged one.
+ * Each layer keeps every distinct seed once, with its fewest edits, so the search is tiny compared to a 2^32 `find`.
+ */
+namespace SeedResync {
+    enum class EditKind: uint8_t {
+        /// An unlogged roll right before the logged roll.
+        unloggedRoll,
+        /// The logged roll used another drink than the logged one(s).
+        unloggedDrink,
+    };
+
+    struct Edit {
+        EditKind kind;
+        /// Index of the logged roll.
+        size_t rollIndex;
+    };
+
+    struct Alignment {
+        /// Seed after the last logged roll.
+        uint32_t finalSeed;
+        /// In roll order.
+        std::vector<Edit> edits;
+    };
+
+    /**
+     * Every seed the logged rolls can end at with at most `maxEditsCount` edits. Unlogged rolls after the last logged roll aren't observable, so they aren't searched.
+     *
+     * @param seed Last verified seed, before `rollSequence`'s roll `startIndex`.
+     * @return Sorted by edits count, then final seed. Empty if no alignment has at most `maxEditsCount` edits.
+     * @throws std::invalid_argument if `maxEditsCount` is over `UINT8_MAX`.
+     */
+    std::vector<Alignment> findAlignments(SeedHelper& seedHelper, uint32_t seed, const RollSequence& rollSequence, size_t startIndex = 0, size_t maxEditsCount = 4);
+
+    /// Longest prefix of `rollSequence` that `seed` replays. `rollSequence.size()` if the seed matches.
+    size_t getVerifiedRollsCount(SeedHelper& seedHelper, uint32_t seed, const RollSequence& rollSequence);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_SEED_RESYNC_H
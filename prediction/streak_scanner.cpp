@@ -0,0 +1,177 @@
+#include "streak_scanner.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "../helpers/parallel.h"
+
+
+namespace StreakScanner {
+    /// All 14 abilities have a streak.
+    constexpr uint16_t allFoundMask = (1 << AbilityHelper::abilitiesCount) - 1;
+
+    /// Record a streak at `position` unless the ability already has an earlier one.
+    static inline void recordStreak(FirstStreaks& firstStreaks, uint16_t& foundMask, const uint8_t abilityIndex, const size_t position) {
+        if (((foundMask >> abilityIndex) & 1) == 0) {
+            foundMask |= (1 << abilityIndex);
+            firstStreaks[abilityIndex] = position;
+        }
+    }
+
+    /// Scan streak start positions [start, length) with the scalar kernel, and merge into `firstStreaks`.
+    static void scanTail(const uint8_t* rolls, const size_t length, const size_t streakLength, const size_t start, FirstStreaks& firstStreaks, uint16_t& foundMask) {
+        if (start >= length) {
+            return;
+        }
+
+        const auto tailStreaks = Kernels::findFirstStreaksScalar(rolls + start, length - start, streakLength);
+        for (size_t i = 0; i < AbilityHelper::abilitiesCount; i += 1) {
+            if (tailStreaks[i] != notFound) {
+                recordStreak(firstStreaks, foundMask, static_cast<uint8_t>(i), start + tailStreaks[i]);
+            }
+        }
+    }
+
+    namespace Kernels {
+        FirstStreaks findFirstStreaksScalar(const uint8_t* rolls, const size_t length, const size_t streakLength) {
+            FirstStreaks returnValue{};
+            returnValue.fill(notFound);
+            uint16_t foundMask = 0;
+
+            size_t streak = 0;
+            for (size_t i = 0; (i < length) && (foundMask != allFoundMask); i += 1) {
+                streak = ((i > 0) && (rolls[i] == rolls[i - 1])) ? (streak + 1) : 1;
+                if (streak >= streakLength) {
+                    recordStreak(returnValue, foundMask, rolls[i], i + 1 - streakLength);
+                }
+            }
+
+            return returnValue;
+        }
+
+        FirstStreaks findFirstStreaksSwar(const uint8_t* rolls, const size_t length, const size_t streakLength) {
+            constexpr size_t blockSize = 8;
+            constexpr uint64_t highBits = 0x8080808080808080;
+            constexpr uint64_t lowBits = 0x7f7f7f7f7f7f7f7f;
+
+            FirstStreaks returnValue{};
+            returnValue.fill(notFound);
+            uint16_t foundMask = 0;
+
+            size_t i = 0;
+            for (; (i + blockSize + streakLength - 1 <= length) && (foundMask != allFoundMask); i += blockSize) {
+                // Little endian: Byte `j` of the block is bits [8j, 8j + 8).
+                uint64_t window0;
+                std::memcpy(&window0, rolls + i, blockSize);
+
+                // 0x80 in each byte where all `streakLength` windows are equal.
+                // Ability indices are < 0x80, so adding 0x7f sets the high bit exactly for non-zero bytes without carries.
+                uint64_t equalMask = highBits;
+                for (size_t k = 1; (k < streakLength) && (equalMask != 0); k += 1) {
+                    uint64_t window;
+                    std::memcpy(&window, rolls + i + k, blockSize);
+                    equalMask &= ~((window0 ^ window) + lowBits) & highBits;
+                }
+
+                while (equalMask != 0) {
+                    const auto j = static_cast<size_t>(__builtin_ctzll(equalMask)) / 8;
+                    recordStreak(returnValue, foundMask, rolls[i + j], i + j);
+                    equalMask &= equalMask - 1;
+                }
+            }
+
+            scanTail(rolls, length, streakLength, i, returnValue, foundMask);
+            return returnValue;
+        }
+
+#ifdef __SSE2__
+        FirstStreaks findFirstStreaksSse2(const uint8_t* rolls, const size_t length, const size_t streakLength) {
+            constexpr size_t blockSize = 16;
+
+            FirstStreaks returnValue{};
+            returnValue.fill(notFound);
+            uint16_t foundMask = 0;
+
+            size_t i = 0;
+            for (; (i + blockSize + streakLength - 1 <= length) && (foundMask != allFoundMask); i += blockSize) {
+                const auto window0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rolls + i));
+
+                // Bit `j`: Rolls [i + j, i + j + streakLength) are equal.
+                unsigned int equalMask = 0xffff;
+                for (size_t k = 1; (k < streakLength) && (equalMask != 0); k += 1) {
+                    const auto window = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rolls + i + k));
+                    equalMask &= static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(window0, window)));
+                }
+
+                while (equalMask != 0) {
+                    const auto j = static_cast<size_t>(__builtin_ctz(equalMask));
+                    recordStreak(returnValue, foundMask, rolls[i + j], i + j);
+                    equalMask &= equalMask - 1;
+                }
+            }
+
+            scanTail(rolls, length, streakLength, i, returnValue, foundMask);
+            return returnValue;
+        }
+#endif
+    }
+
+    std::vector<uint8_t> generatePackedRolls(const SeedHelper& seedHelper, uint32_t seed, const Ability drink, const size_t length) {
+        std::vector<uint8_t> returnValue(length, 0);
+        Ability ability;
+        if (drink == Ability::noDrink) {
+            for (size_t i = 0; i < length; i += 1) {
+                std::tie(seed, ability) = seedHelper.generateRoll(seed);
+                returnValue[i] = static_cast<uint8_t>(ability);
+            }
+        } else {
+            for (size_t i = 0; i < length; i += 1) {
+                std::tie(seed, ability) = seedHelper.generateRollWithDrink(seed, drink);
+                returnValue[i] = static_cast<uint8_t>(ability);
+            }
+        }
+
+        return returnValue;
+    }
+
+    FirstStreaks findFirstStreaks(const std::vector<uint8_t>& rolls, const size_t streakLength) {
+        if (streakLength < 2) {
+            throw std::invalid_argument("Streak length must be at least 2.");
+        }
+
+#ifdef __SSE2__
+        return Kernels::findFirstStreaksSse2(rolls.data(), rolls.size(), streakLength);
+#else
+        return Kernels::findFirstStreaksSwar(rolls.data(), rolls.size(), streakLength);
+#endif
+    }
+
+    std::array<FirstStreaks, AbilityHelper::drinkChoicesCount> findFirstStreaksForAllDrinks(SeedHelper& seedHelper, const uint32_t seed, const size_t length, const size_t streakLength, const size_t workersCount) {
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        // Each worker generates and scans its own buffers.
+        const auto workerStreaks = Parallel::mapRanges(AbilityHelper::drinkChoicesCount, workersCount, [&](const size_t start, const size_t stop) {
+            std::vector<FirstStreaks> firstStreaks{};
+            for (size_t i = start; i < stop; i += 1) {
+                const auto rolls = generatePackedRolls(seedHelper, seed, AbilityHelper::getDrinkChoice(i), length);
+                firstStreaks.push_back(findFirstStreaks(rolls, streakLength));
+            }
+            return firstStreaks;
+        });
+
+        std::array<FirstStreaks, AbilityHelper::drinkChoicesCount> returnValue{};
+        size_t i = 0;
+        for (const auto& firstStreaks: workerStreaks) {
+            for (const auto& drinkFirstStreaks: firstStreaks) {
+                returnValue[i] = drinkFirstStreaks;
+                i += 1;
+            }
+        }
+
+        return returnValue;
+    }
+}
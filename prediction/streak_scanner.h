@@ -0,0 +1,51 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_STREAK_SCANNER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_STREAK_SCANNER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../seed_helper.h"
+
+
+/**
+ * Finds the first streak of each ability over long horizons (10^4 to 10^6 rolls).
+ *
+ * Rolls are generated into packed byte buffers (1 ability index per byte),
+ * and streaks are found by comparing shifted windows of the buffer, 16 (SSE2) or 8 (SWAR) rolls at a time.
+ */
+namespace StreakScanner {
+    /// No streak found.
+    constexpr size_t notFound = SIZE_MAX;
+
+    /// Indices correspond to `Ability`'s values: Start index of the first streak, or `notFound`.
+    using FirstStreaks = std::array<size_t, AbilityHelper::abilitiesCount>;
+
+    /**
+     * Generate `length` rolls as ability indices.
+     * `drink` must be cached if it's not `Ability::noDrink`.
+     */
+    std::vector<uint8_t> generatePackedRolls(const SeedHelper& seedHelper, uint32_t seed, Ability drink, size_t length);
+
+    /// Find the first streak (`streakLength` >= 2 identical rolls) of each ability.
+    FirstStreaks findFirstStreaks(const std::vector<uint8_t>& rolls, size_t streakLength = 3);
+
+    /**
+     * `findFirstStreaks` for no drink and each drink held for `length` rolls.
+     *
+     * @return Indices: `AbilityHelper::getDrinkChoice`.
+     */
+    std::array<FirstStreaks, AbilityHelper::drinkChoicesCount> findFirstStreaksForAllDrinks(SeedHelper& seedHelper, uint32_t seed, size_t length, size_t streakLength = 3, size_t workersCount = 0);
+
+    /// Implementations of `findFirstStreaks`. Exposed for tests.
+    namespace Kernels {
+        FirstStreaks findFirstStreaksScalar(const uint8_t* rolls, size_t length, size_t streakLength);
+        FirstStreaks findFirstStreaksSwar(const uint8_t* rolls, size_t length, size_t streakLength);
+#ifdef __SSE2__
+        FirstStreaks findFirstStreaksSse2(const uint8_t* rolls, size_t length, size_t streakLength);
+#endif
+    }
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_STREAK_SCANNER_H
@@ -0,0 +1,131 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_ROLL_RANGE_H
+#define SPLATOON_3_GEAR_HELPER_CPP_ROLL_RANGE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <tuple>
+
+#include "seed_helper.h"
+
+
+/**
+ * Lazy rolls from a seed, with or without a drink.
+ *
+ * Rolls are generated on demand by the iterator, so ranges never allocate and stopping early is free.
+ * Ranges are cheap to copy, and each `begin()` restarts from the initial seed.
+ *
+ * `drink` must be cached if it's not `Ability::noDrink`.
+ *
+ * ```
+ * for (const auto [seed, ability]: RollRange{seedHelper, initialSeed, drink}.take(15)) { ... }
+ * ```
+ */
+class RollRange {
+public:
+    struct Roll {
+        /// Seed after this roll (i.e. the seed that generates the next roll).
+        uint32_t seed;
+        Ability ability;
+    };
+
+    /// Practically unbounded: The seed cycle is shorter.
+    static constexpr size_t unbounded = SIZE_MAX;
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Roll;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Roll*;
+        using reference = const Roll&;
+
+    private:
+        const SeedHelper* seedHelper;
+        Ability drink;
+
+        /// The current roll. Its seed generates the next roll.
+        Roll roll;
+
+        /// Including the current roll. 0: End.
+        size_t remainingCount;
+
+        void generate() {
+            if (drink == Ability::noDrink) {
+                std::tie(roll.seed, roll.ability) = seedHelper->generateRoll(roll.seed);
+            } else {
+                std::tie(roll.seed, roll.ability) = seedHelper->generateRollWithDrink(roll.seed, drink);
+            }
+        }
+
+    public:
+        /// End iterator.
+        Iterator(): seedHelper{nullptr}, drink{Ability::noDrink}, roll{0, Ability::unknown}, remainingCount{0} {}
+
+        Iterator(const SeedHelper& seedHelper, const uint32_t seed, const Ability drink, const size_t count): seedHelper{&seedHelper}, drink{drink}, roll{seed, Ability::unknown}, remainingCount{count} {
+            if (remainingCount > 0) {
+                generate();
+            }
+        }
+
+        reference operator*() const {
+            return roll;
+        }
+
+        pointer operator->() const {
+            return &roll;
+        }
+
+        Iterator& operator++() {
+            remainingCount -= 1;
+            if (remainingCount > 0) {
+                generate();
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            auto returnValue = *this;
+            ++(*this);
+            return returnValue;
+        }
+
+        /// Only meaningful for iterators of the same range.
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.remainingCount == rhs.remainingCount;
+        }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.remainingCount != rhs.remainingCount;
+        }
+    };
+
+private:
+    const SeedHelper* seedHelper;
+    uint32_t seed;
+    Ability drink;
+    size_t length;
+
+public:
+    RollRange(const SeedHelper& seedHelper, const uint32_t seed, const Ability drink = Ability::noDrink, const size_t length = unbounded): seedHelper{&seedHelper}, seed{seed}, drink{drink}, length{length} {}
+
+    [[nodiscard]] Iterator begin() const {
+        return Iterator{*seedHelper, seed, drink, length};
+    }
+
+    [[nodiscard]] Iterator end() const {
+        return Iterator{};
+    }
+
+    /// The first `count` rolls (or fewer, if this range is shorter).
+    [[nodiscard]] RollRange take(const size_t count) const {
+        return RollRange{*seedHelper, seed, drink, std::min(length, count)};
+    }
+
+    [[nodiscard]] size_t size() const {
+        return length;
+    }
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_ROLL_RANGE_H
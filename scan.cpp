@@ -0,0 +1,62 @@
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "prediction/collection_scanner.h"
+#include "helpers/terminal_format.h"
+
+
+int main(int argc, char* argv[]) {
+    // Parse arguments.
+    if (argc < 3) {
+        throw std::invalid_argument("Usage: scan <directory> <ability ID>... [--horizon N] [--streak N] [--top N]");
+    }
+
+    const std::string directory{argv[1]};
+    std::vector<Ability> targets{};
+    size_t horizon = 100;
+    size_t streakLength = 3;
+    size_t topCount = 20;
+
+    for (int i = 2; i < argc; i += 1) {
+        const std::string_view argument{argv[i]};
+        if ((argument == "--horizon") && (i + 1 < argc)) {
+            i += 1;
+            horizon = std::stoul(argv[i]);
+        } else if ((argument == "--streak") && (i + 1 < argc)) {
+            i += 1;
+            streakLength = std::stoul(argv[i]);
+        } else if ((argument == "--top") && (i + 1 < argc)) {
+            i += 1;
+            topCount = std::stoul(argv[i]);
+        } else {
+            const auto target = AbilityHelper::fromId(argument);
+            if (target == Ability::unknown) {
+                throw std::invalid_argument("Target ability can't be `unknown`.");
+            }
+            targets.push_back(target);
+        }
+    }
+    if (targets.empty()) {
+        throw std::invalid_argument("No target ability given.");
+    }
+
+    // Load and scan.
+    const auto workersCount = std::thread::hardware_concurrency();
+    const auto collection = CollectionScanner::loadCollection(directory, workersCount);
+    for (const auto& [filename, message]: collection.errors) {
+        std::cerr << TerminalFormat::WARNING << "Skipped " << filename << ": " << message << TerminalFormat::ENDC << "\n";
+    }
+
+    const auto opportunities = CollectionScanner::findOpportunities(collection.gears, targets, streakLength, horizon, workersCount);
+    std::cout << TerminalFormat::BOLD << collection.gears.size() << " gears, " << opportunities.size() << " opportunities within " << horizon << " rolls" << TerminalFormat::ENDC << "\n";
+    std::cout << "rank\trolls\tability\tdrink\tname\tbrand\tfile\n";
+    for (size_t i = 0; (i < opportunities.size()) && (i < topCount); i += 1) {
+        const auto& [gearIndex, target, drink, rollsCount] = opportunities[i];
+        const auto& gear = collection.gears[gearIndex];
+        std::cout << (i + 1) << "\t" << rollsCount << "\t" << AbilityHelper::getId(target) << "\t" << ((drink == Ability::noDrink) ? "none" : AbilityHelper::getId(drink)) << "\t" << gear.name << "\t" << gear.brand << "\t" << gear.filename << "\n";
+    }
+    std::cout << std::flush;
+
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include "search_profile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "data/brand.h"
+
+
+namespace SearchProfile {
+    namespace {
+        /// Seeds of the calibration scans start here.
+        constexpr uint32_t calibrationSeedStart = 0x40000000;
+        constexpr size_t calibrationRollsCount = 10;
+        constexpr uint32_t calibrationInitialSeed = 0x5eed1234;
+
+        size_t getHardwareConcurrency() {
+            return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+
+        /// 10 rolls of a neutral brand. With drinks, every other roll uses a drink.
+        RollSequence makeCalibrationRollSequence(SeedHelper& seedHelper, const Shape shape) {
+            seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+            RollSequence returnValue{};
+            auto seed = calibrationInitialSeed;
+            for (size_t i = 0; i < calibrationRollsCount; i += 1) {
+                if ((shape == Shape::noDrinks) || (i % 2 == 0)) {
+                    const auto [nextSeed, ability] = seedHelper.generateRoll(seed);
+                    returnValue.addRoll(ability);
+                    seed = nextSeed;
+                    continue;
+                }
+
+                const auto drink = static_cast<Ability>(i % AbilityHelper::abilitiesCount);
+                const auto [nextSeed, ability] = seedHelper.generateRollWithDrink(seed, drink);
+                if (shape == Shape::uncertainDrinks) {
+                    returnValue.addRoll(ability, AbilitySet::fromMask(AbilitySet{drink}.getMask() | AbilitySet::noDrinkMask));
+                } else {
+                    returnValue.addRoll(ability, drink);
+                }
+                seed = nextSeed;
+            }
+
+            return returnValue;
+        }
+
+        std::vector<size_t> getWorkersCountCandidates() {
+            const auto hardwareConcurrency = getHardwareConcurrency();
+
+            std::vector<size_t> returnValue{};
+            for (size_t workersCount = 1; workersCount <= 2 * hardwareConcurrency; workersCount *= 2) {
+                returnValue.push_back(workersCount);
+            }
+            if (std::find(returnValue.begin(), returnValue.end(), hardwareConcurrency) == returnValue.end()) {
+                returnValue.push_back(hardwareConcurrency);
+                std::sort(returnValue.begin(), returnValue.end());
+            }
+            return returnValue;
+        }
+
+        [[noreturn]] void throwInvalidProfile(const std::string& filename, const size_t lineNumber, const std::string_view message) {
+            std::string exceptionMessage{"Invalid search profile "};
+            exceptionMessage += filename;
+            exceptionMessage += " (line " + std::to_string(lineNumber) + "): ";
+            exceptionMessage += message;
+            throw std::runtime_error(exceptionMessage);
+        }
+    }
+
+
+    Shape getShape(const RollSequence& rollSequence) {
+        if (rollSequence.hasUncertainDrinks()) {
+            return Shape::uncertainDrinks;
+        }
+        const auto drinksUsed = rollSequence.getDrinksUsed();
+        if (drinksUsed.empty() || ((drinksUsed.size() == 1) && (drinksUsed.count(Ability::noDrink) == 1))) {
+            return Shape::noDrinks;
+        }
+        return Shape::drinks;
+    }
+
+
+#pragma mark - File
+    std::string getDefaultFilename() {
+        std::filesystem::path directory{};
+        if (const auto* const configHome = std::getenv("XDG_CONFIG_HOME"); (configHome != nullptr) && (*configHome != '\0')) {
+            directory = configHome;
+        } else if (const auto* const home = std::getenv("HOME"); (home != nullptr) && (*home != '\0')) {
+            directory = std::filesystem::path{home} / ".config";
+        } else {
+            return {};
+        }
+
+        return (directory / "splatoon-3-gear-helper" / "search_profile.txt").string();
+    }
+
+    std::optional<Profile> load(const std::string& filename) {
+        std::ifstream file{filename};
+        if (!file) {
+            return std::nullopt;
+        }
+
+        std::optional<size_t> hardwareConcurrency{};
+        std::array<std::optional<SearchConfiguration>, shapesCount> configurations{};
+
+        std::string line{};
+        size_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber += 1;
+            if (const auto commentStart = line.find('#'); commentStart != std::string::npos) {
+                line.resize(commentStart);
+            }
+
+            std::istringstream lineStream{line};
+            std::string key{};
+            if (!(lineStream >> key)) {
+                // Blank line.
+                continue;
+            }
+
+            if (key == "hardware_concurrency") {
+                size_t value = 0;
+                if (!(lineStream >> value)) {
+                    throwInvalidProfile(filename, lineNumber, "Expected a thread count.");
+                }
+                hardwareConcurrency = value;
+            } else {
+                const auto shapeIterator = std::find(shapeIds.begin(), shapeIds.end(), key);
+                if (shapeIterator == shapeIds.end()) {
+                    throwInvalidProfile(filename, lineNumber, "Unknown key: " + key);
+                }
+
+                size_t workersCount = 0;
+                size_t chunksPerWorker = 0;
+                if (!(lineStream >> workersCount >> chunksPerWorker) || (workersCount == 0) || (chunksPerWorker == 0)) {
+                    throwInvalidProfile(filename, lineNumber, "Expected a workers count and chunks per worker (both positive).");
+                }
+                configurations[shapeIterator - shapeIds.begin()] = SearchConfiguration{workersCount, chunksPerWorker};
+            }
+
+            std::string extra{};
+            if (lineStream >> extra) {
+                throwInvalidProfile(filename, lineNumber, "Unexpected value: " + extra);
+            }
+        }
+
+        if (!hardwareConcurrency.has_value()) {
+            throwInvalidProfile(filename, lineNumber, "Missing hardware_concurrency.");
+        }
+        Profile returnValue{hardwareConcurrency.value(), {}};
+        for (size_t i = 0; i < shapesCount; i += 1) {
+            if (!configurations[i].has_value()) {
+                throwInvalidProfile(filename, lineNumber, "Missing " + std::string{shapeIds[i]} + ".");
+            }
+            returnValue.configurations[i] = configurations[i].value();
+        }
+
+        return returnValue;
+    }
+
+    void save(const Profile& profile, const std::string& filename) {
+        const std::filesystem::path path{filename};
+        if (path.has_parent_path()) {
+            std::error_code error{};
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        std::ofstream file{filename, std::ios::trunc};
+        if (!file) {
+            throw std::runtime_error("Failed to create search profile: " + filename);
+        }
+
+        file << "# Written by `find --autotune`. Shapes: <workers count> <chunks per worker>\n";
+        file << "hardware_concurrency " << profile.hardwareConcurrency << '\n';
+        for (size_t i = 0; i < shapesCount; i += 1) {
+            const auto& configuration = profile.configurations[i];
+            file << shapeIds[i] << ' ' << configuration.workersCount << ' ' << configuration.chunksPerWorker << '\n';
+        }
+
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write search profile: " + filename);
+        }
+    }
+
+    SearchConfiguration getConfiguration(const std::optional<Profile>& profile, const RollSequence& rollSequence) {
+        if (!profile.has_value() || (profile->hardwareConcurrency != getHardwareConcurrency())) {
+            return SearchConfiguration{getHardwareConcurrency()};
+        }
+
+        return profile->configurations[static_cast<size_t>(getShape(rollSequence))];
+    }
+
+
+#pragma mark - Autotune
+    Profile autotune(std::ostream& log, const uint32_t seedsCount) {
+        constexpr std::array<size_t, 4> chunksPerWorkerCandidates{1, 4, 16, 64};
+        constexpr size_t runsCount = 2;
+
+        SeedHelper seedHelper{neutralBrands[0]};
+        const auto workersCountCandidates = getWorkersCountCandidates();
+        const auto seedStop = calibrationSeedStart + (seedsCount - 1);
+
+        Profile returnValue{getHardwareConcurrency(), {}};
+        for (size_t i = 0; i < shapesCount; i += 1) {
+            const auto rollSequence = makeCalibrationRollSequence(seedHelper, static_cast<Shape>(i));
+
+            SearchConfiguration bestConfiguration{};
+            auto bestSeconds = std::numeric_limits<double>::infinity();
+            for (const auto workersCount: workersCountCandidates) {
+                for (const auto chunksPerWorker: chunksPerWorkerCandidates) {
+                    const SearchConfiguration configuration{workersCount, chunksPerWorker};
+                    for (size_t run = 0; run < runsCount; run += 1) {
+                        const auto start = std::chrono::steady_clock::now();
+                        static_cast<void>(seedHelper.findSeedInRange(rollSequence, calibrationSeedStart, seedStop, configuration));
+                        const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+                        // Ties go to the earlier (simpler) configuration.
+                        if (seconds.count() < bestSeconds) {
+                            bestSeconds = seconds.count();
+                            bestConfiguration = configuration;
+                        }
+                    }
+                }
+            }
+
+            returnValue.configurations[i] = bestConfiguration;
+            log << shapeIds[i] << ": " << bestConfiguration.workersCount << " workers, " << bestConfiguration.chunksPerWorker << " chunks per worker ("
+                << std::fixed << std::setprecision(1) << static_cast<double>(seedsCount) / bestSeconds / 1e6 << "M seeds/s)" << std::endl;
+        }
+
+        return returnValue;
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_SEARCH_PROFILE_H
+#define SPLATOON_3_GEAR_HELPER_CPP_SEARCH_PROFILE_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "seed_helper.h"
+
+
+/**
+ * Per host `findSeed` configurations, measured by `find --autotune` and loaded by later searches.
+ *
+ * Profile file (text, 1 setting per line, `#` comments):
+ *
+ * ```
+ * hardware_concurrency 8
+ * no_drinks 8 1
+ * drinks 8 4
+ * uncertain_drinks 16 16
+ * ```
+ *
+ * Shape lines: `<shape> <workers count> <chunks per worker>`.
+ */
+namespace SearchProfile {
+    /// Roll sequence shapes with different search costs. Each shape is tuned separately.
+    enum class Shape {
+        noDrinks,
+        drinks,
+        uncertainDrinks,
+    };
+    constexpr size_t shapesCount = 3;
+    /// Indices: `Shape`.
+    constexpr std::array<std::string_view, shapesCount> shapeIds{"no_drinks", "drinks", "uncertain_drinks"};
+
+    [[nodiscard]] Shape getShape(const RollSequence& rollSequence);
+
+    struct Profile {
+        /// `std::thread::hardware_concurrency()` when tuned. Profiles from other hosts (e.g. a shared home directory) are ignored.
+        size_t hardwareConcurrency;
+        /// Indices: `Shape`.
+        std::array<SearchConfiguration, shapesCount> configurations;
+    };
+
+    /// `$XDG_CONFIG_HOME/splatoon-3-gear-helper/search_profile.txt`, or under `~/.config`. Empty if neither is set.
+    [[nodiscard]] std::string getDefaultFilename();
+
+    /**
+     * @return `std::nullopt` if the file doesn't exist.
+     * @throws std::runtime_error for invalid files.
+     */
+    [[nodiscard]] std::optional<Profile> load(const std::string& filename);
+
+    /**
+     * Creates missing directories.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
+    void save(const Profile& profile, const std::string& filename);
+
+    /// The profile's configuration for `rollSequence`, or all hardware threads with 1 range each (no profile, or a profile from another host).
+    [[nodiscard]] SearchConfiguration getConfiguration(const std::optional<Profile>& profile, const RollSequence& rollSequence);
+
+    /**
+     * Find the fastest configuration for each shape, by timing short scans of `seedsCount` seeds.
+     *
+     * Candidates: 1 to 2× hardware threads (powers of 2, and the hardware thread count), with 1 to 64 chunks per worker.
+     * Each candidate's best of 2 runs counts.
+     *
+     * @param log Progress, 1 line per shape.
+     */
+    [[nodiscard]] Profile autotune(std::ostream& log, uint32_t seedsCount = 1 << 24);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_SEARCH_PROFILE_H
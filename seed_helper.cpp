@@ -4,10 +4,18 @@
 
 #include "seed_helper.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <numeric>
-#include <future>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
 
 #include "data/brand.h"
+#include "roll_range.h"
+#include "helpers/parallel.h"
+#include "helpers/trace.h"
 
 
 struct Weight {
@@ -45,6 +53,11 @@ SeedHelper::SeedHelper(std::string_view brandName): brandName(brandName), cached
             }
         }
     }
+    if (std::all_of(cachedWeights.begin(), cachedWeights.end(), [](const auto weight) { return weight == 0; })) {
+        std::string exceptionMessage{"Unknown brand: "};
+        exceptionMessage += brandName;
+        throw std::invalid_argument(exceptionMessage);
+    }
 
     this->totalWeight = std::accumulate(cachedWeights.begin(), cachedWeights.end(), 0);
 
@@ -66,6 +79,10 @@ SeedHelper::SeedHelper(std::string_view brandName): brandName(brandName), cached
 
 void SeedHelper::cacheDrinkRollToAbilityMap(const Ability drink) {
     size_t drinkIndex = AbilityHelper::getIndex(drink);
+    if (drinkRollToAbilityMap[drinkIndex].first != 0) {
+        // Already cached.
+        return;
+    }
 
     const size_t currentDrinkTotalWeight = totalWeight - cachedWeights[drinkIndex];
 
@@ -103,6 +120,194 @@ uint32_t SeedHelper::advanceSeed(uint32_t seed) {
     return seed;
 }
 
+
+#pragma mark - Cycle position
+namespace {
+    /**
+     * `advanceSeed` is linear over GF(2)^32, and its characteristic polynomial `p` is primitive.
+     * With the basis {seed 1, advanced 1 time, ..., advanced 31 times}, a seed `s` is a polynomial `q` (s = q(advanceSeed)(1)),
+     * and advancing is multiplying by `x` in GF(2^32) = GF(2)[x] / p.
+     * So the position of `s` is the discrete logarithm of `q` to the base `x`.
+     */
+    class SeedCycle {
+    private:
+        static constexpr std::array<uint32_t, 5> primeFactors{3, 5, 17, 257, 65537};
+        /// `x` as a polynomial.
+        static constexpr uint32_t generator = 0b10;
+
+        /// Seed 1 advanced `i` times.
+        std::array<uint32_t, 32> basisSeeds;
+        /**
+         * Reduced basis for solving `seed` -> polynomial: `reducedSeeds[i]` has its highest bit at `i`.
+         * `reducedPolynomials[i]`: The polynomial of `reducedSeeds[i]`.
+         */
+        std::array<uint32_t, 32> reducedSeeds;
+        std::array<uint32_t, 32> reducedPolynomials;
+        /// `p` without `x^32`.
+        uint32_t polynomialLowBits;
+
+        /// Baby steps of each prime's subgroup: (`x^(j * cycleLength / prime)`, j), sorted.
+        std::array<std::vector<std::pair<uint32_t, uint32_t>>, primeFactors.size()> babySteps;
+        /// `x^(-babySteps.size() * cycleLength / prime)`.
+        std::array<uint32_t, primeFactors.size()> giantSteps;
+        /// Chinese remainder theorem: `cofactor * (cofactor^-1 mod prime)`, where `cofactor = cycleLength / prime`.
+        std::array<uint64_t, primeFactors.size()> remainderCoefficients;
+
+    public:
+        SeedCycle(): basisSeeds{}, reducedSeeds{}, reducedPolynomials{}, polynomialLowBits{0}, babySteps{}, giantSteps{}, remainderCoefficients{} {
+            uint32_t seed = 1;
+            for (size_t i = 0; i < basisSeeds.size(); i += 1) {
+                basisSeeds[i] = seed;
+                seed = SeedHelper::advanceSeed(seed);
+
+                // Gaussian elimination.
+                auto reducedSeed = basisSeeds[i];
+                uint32_t reducedPolynomial = uint32_t{1} << i;
+                for (int bit = 31; bit >= 0; bit -= 1) {
+                    if (((reducedSeed >> bit) & 1) == 0) {
+                        continue;
+                    }
+                    if (reducedSeeds[bit] == 0) {
+                        reducedSeeds[bit] = reducedSeed;
+                        reducedPolynomials[bit] = reducedPolynomial;
+                        break;
+                    }
+                    reducedSeed ^= reducedSeeds[bit];
+                    reducedPolynomial ^= reducedPolynomials[bit];
+                }
+            }
+            // Seed 1 advanced 32 times = x^32.
+            polynomialLowBits = getPolynomial(seed);
+
+            for (size_t i = 0; i < primeFactors.size(); i += 1) {
+                const auto prime = primeFactors[i];
+                const auto subgroupGenerator = power(generator, SeedHelper::cycleLength / prime);
+                const auto babyStepsCount = static_cast<uint32_t>(std::ceil(std::sqrt(prime)));
+
+                uint32_t element = 1;
+                for (uint32_t j = 0; j < babyStepsCount; j += 1) {
+                    babySteps[i].emplace_back(element, j);
+                    element = multiply(element, subgroupGenerator);
+                }
+                std::sort(babySteps[i].begin(), babySteps[i].end());
+                // `element` = `subgroupGenerator ^ babyStepsCount`, and its inverse is its power `prime - 1`.
+                giantSteps[i] = power(element, prime - 1);
+
+                // Inverse by Fermat's little theorem.
+                const auto cofactor = SeedHelper::cycleLength / prime;
+                uint64_t cofactorInverse = 1;
+                for (uint32_t j = 0; j < prime - 2; j += 1) {
+                    cofactorInverse = cofactorInverse * (cofactor % prime) % prime;
+                }
+                remainderCoefficients[i] = cofactor * cofactorInverse;
+            }
+        }
+
+        [[nodiscard]] uint32_t getPolynomial(const uint32_t seed) const {
+            uint32_t returnValue = 0;
+            auto remainingSeed = seed;
+            for (int bit = 31; bit >= 0; bit -= 1) {
+                if (((remainingSeed >> bit) & 1) != 0) {
+                    remainingSeed ^= reducedSeeds[bit];
+                    returnValue ^= reducedPolynomials[bit];
+                }
+            }
+            return returnValue;
+        }
+
+        [[nodiscard]] uint32_t getSeed(const uint32_t polynomial) const {
+            uint32_t returnValue = 0;
+            for (size_t i = 0; i < basisSeeds.size(); i += 1) {
+                if (((polynomial >> i) & 1) != 0) {
+                    returnValue ^= basisSeeds[i];
+                }
+            }
+            return returnValue;
+        }
+
+        [[nodiscard]] uint32_t multiply(const uint32_t a, const uint32_t b) const {
+            // Carry-less product.
+            uint64_t product = 0;
+            for (size_t i = 0; i < 32; i += 1) {
+                if (((b >> i) & 1) != 0) {
+                    product ^= uint64_t{a} << i;
+                }
+            }
+
+            // Reduce x^32 = `polynomialLowBits`, from the highest bit.
+            for (int bit = 62; bit >= 32; bit -= 1) {
+                if (((product >> bit) & 1) != 0) {
+                    product ^= uint64_t{1} << bit;
+                    product ^= uint64_t{polynomialLowBits} << (bit - 32);
+                }
+            }
+            return static_cast<uint32_t>(product);
+        }
+
+        [[nodiscard]] uint32_t power(uint32_t base, uint32_t exponent) const {
+            uint32_t returnValue = 1;
+            while (exponent > 0) {
+                if ((exponent & 1) != 0) {
+                    returnValue = multiply(returnValue, base);
+                }
+                base = multiply(base, base);
+                exponent >>= 1;
+            }
+            return returnValue;
+        }
+
+        [[nodiscard]] uint32_t getPosition(const uint32_t seed) const {
+            const auto polynomial = getPolynomial(seed);
+
+            // Position modulo each prime (baby-step giant-step in the prime's subgroup), then the Chinese remainder theorem.
+            uint64_t returnValue = 0;
+            for (size_t i = 0; i < primeFactors.size(); i += 1) {
+                const auto prime = primeFactors[i];
+                const auto& steps = babySteps[i];
+
+                auto element = power(polynomial, SeedHelper::cycleLength / prime);
+                uint64_t remainder = prime;
+                for (uint32_t giantStep = 0; giantStep * steps.size() < prime; giantStep += 1) {
+                    const auto it = std::lower_bound(steps.begin(), steps.end(), std::make_pair(element, uint32_t{0}));
+                    if ((it != steps.end()) && (it->first == element)) {
+                        remainder = giantStep * steps.size() + it->second;
+                        break;
+                    }
+                    element = multiply(element, giantSteps[i]);
+                }
+                assert(remainder < prime);
+
+                returnValue = (returnValue + remainder * remainderCoefficients[i]) % SeedHelper::cycleLength;
+            }
+
+            return static_cast<uint32_t>(returnValue);
+        }
+    };
+
+    const SeedCycle& getSeedCycle() {
+        static const SeedCycle seedCycle{};
+        return seedCycle;
+    }
+}
+
+uint32_t SeedHelper::cyclePosition(const uint32_t seed) {
+    if (seed == 0) {
+        throw std::invalid_argument("Seed 0 isn't on the seed cycle.");
+    }
+    return getSeedCycle().getPosition(seed);
+}
+
+uint32_t SeedHelper::seedAtPosition(const uint32_t position) {
+    const auto& seedCycle = getSeedCycle();
+    return seedCycle.getSeed(seedCycle.power(0b10, position));
+}
+
+uint32_t SeedHelper::stepsBetween(const uint32_t fromSeed, const uint32_t toSeed) {
+    const auto fromPosition = cyclePosition(fromSeed);
+    const auto toPosition = cyclePosition(toSeed);
+    return (toPosition >= fromPosition) ? (toPosition - fromPosition) : (cycleLength - (fromPosition - toPosition));
+}
+
 std::pair<bool, uint32_t> SeedHelper::advanceSeedToEndOfRollSequence(const uint32_t initialSeed, const RollSequence &rollSequence) {
     // Cache weights with drinks applied.
     const auto drinksUsed = rollSequence.getDrinksUsed();
@@ -110,10 +315,19 @@ std::pair<bool, uint32_t> SeedHelper::advanceSeedToEndOfRollSequence(const uint3
         cacheDrinkRollToAbilityMap(drink);
     }
 
+    return replayRollSequence(initialSeed, rollSequence);
+}
+
+std::pair<bool, uint32_t> SeedHelper::replayRollSequence(const uint32_t initialSeed, const RollSequence &rollSequence) const {
+    if (rollSequence.hasUncertainDrinks()) {
+        throw std::invalid_argument("Cannot advance seed: Some drinks in the roll sequence are uncertain.");
+    }
+
     bool validity = true;
     uint32_t seed = initialSeed;
 
-    for (const auto [expectedAbility, drink]: rollSequence) {
+    for (const auto [expectedAbilities, drinks]: rollSequence) {
+        const auto drink = drinks.getSingle();
         Ability ability;
         if (drink == Ability::noDrink) {
             std::tie(seed, ability) = generateRoll(seed);
@@ -121,7 +335,7 @@ std::pair<bool, uint32_t> SeedHelper::advanceSeedToEndOfRollSequence(const uint3
             std::tie(seed, ability) = generateRollWithDrink(seed, drink);
         }
 
-        if (ability != expectedAbility) {
+        if (!expectedAbilities.contains(ability)) {
             validity = false;
         }
     }
@@ -167,10 +381,51 @@ std::pair<uint32_t, Ability> SeedHelper::generateRollWithDrink(uint32_t seed, co
     return std::make_pair(seed, ability);
 }
 
+size_t SeedHelper::generateRollWithDrinks(uint32_t seed, const AbilitySet drinks, const AbilitySet expectedAbilities, std::array<uint32_t, 2>& nextSeeds) const {
+    size_t nextSeedsCount = 0;
+
+    const auto seed1 = advanceSeed(seed);
+    const bool drinkAbilityRolled = (seed1 % 100) <= 29;
+
+    // 1 advance.
+    bool seed1Valid = false;
+    if (drinks.contains(Ability::noDrink)) {
+        seed1Valid = expectedAbilities.contains(getBrandedAbility(seed1));
+    }
+    if (drinkAbilityRolled) {
+        // Any drink in `drinks` rolls itself.
+        const auto expectedDrinksMask = drinks.getMask() & expectedAbilities.getMask() & AbilitySet::allAbilitiesMask;
+        seed1Valid = seed1Valid || (expectedDrinksMask != 0);
+    }
+    if (seed1Valid) {
+        nextSeeds[nextSeedsCount] = seed1;
+        nextSeedsCount += 1;
+    }
+
+    // 2 advances.
+    if (!drinkAbilityRolled) {
+        const auto seed2 = advanceSeed(seed1);
+        auto remainingDrinksMask = drinks.getMask() & AbilitySet::allAbilitiesMask;
+        while (remainingDrinksMask != 0) {
+            const auto drink = static_cast<Ability>(__builtin_ctz(remainingDrinksMask));
+            remainingDrinksMask &= remainingDrinksMask - 1;
+
+            if (expectedAbilities.contains(getBrandedAbilityWithDrink(seed2, drink))) {
+                nextSeeds[nextSeedsCount] = seed2;
+                nextSeedsCount += 1;
+                break;
+            }
+        }
+    }
+
+    return nextSeedsCount;
+}
+
 std::vector<Ability> SeedHelper::generateRolls(uint32_t seed, const size_t length) const {
-    std::vector<Ability> returnValue{length, Ability::unknown};
-    for (size_t i = 0; i < length; i += 1) {
-        std::tie(seed, returnValue[i]) = generateRoll(seed);
+    std::vector<Ability> returnValue{};
+    returnValue.reserve(length);
+    for (const auto& roll: RollRange{*this, seed, Ability::noDrink, length}) {
+        returnValue.push_back(roll.ability);
     }
 
     return returnValue;
@@ -179,15 +434,17 @@ std::vector<Ability> SeedHelper::generateRolls(uint32_t seed, const size_t lengt
 std::vector<Ability> SeedHelper::generateRollsWithDrink(uint32_t seed, Ability drink, size_t length) {
     cacheDrinkRollToAbilityMap(drink);
 
-    std::vector<Ability> returnValue{length, Ability::unknown};
-    for (size_t i = 0; i < length; i += 1) {
-        std::tie(seed, returnValue[i]) = generateRollWithDrink(seed, drink);
+    std::vector<Ability> returnValue{};
+    returnValue.reserve(length);
+    for (const auto& roll: RollRange{*this, seed, drink, length}) {
+        returnValue.push_back(roll.ability);
     }
 
     return returnValue;
 }
 
-std::vector<uint32_t> SeedHelper::findSeedWorker(const RollSequence &previousRolls, const uint32_t seedStart, const uint32_t seedStop) const {
+template <typename Counters>
+std::vector<uint32_t> SeedHelper::findSeedWorker(const RollSequence &previousRolls, const uint32_t seedStart, const uint32_t seedStop, Counters& counters) const {
     assert(seedStart <= seedStop);
 
     // Brute force solution: Try all possible start seeds.
@@ -197,18 +454,34 @@ std::vector<uint32_t> SeedHelper::findSeedWorker(const RollSequence &previousRol
     do {
         auto seed = initial_seed;
         auto valid = true;
-        for (const auto [expectedResult, drink]: previousRolls) {
+        size_t rollIndex = 0;
+        for (const auto [expectedResults, drinks]: previousRolls) {
+            const auto drink = drinks.getSingle();
             Ability result;
             if (drink == Ability::noDrink) {
                 std::tie(seed, result) = generateRoll(seed);
             } else {
+                const auto previousSeed = seed;
                 std::tie(seed, result) = generateRollWithDrink(seed, drink);
+                if constexpr (Counters::isEnabled) {
+                    // A hit only advances the seed once.
+                    if (seed == advanceSeed(previousSeed)) {
+                        counters.drinkHits += 1;
+                    } else {
+                        counters.drinkMisses += 1;
+                    }
+                }
             }
 
-            if ((result != expectedResult) && (result != Ability::unknown)) {
+            // `unknown` is the full set, so partially known rolls still prune here.
+            if (!expectedResults.contains(result)) {
                 valid = false;
+                if constexpr (Counters::isEnabled) {
+                    counters.countRejection(rollIndex);
+                }
                 break;
             }
+            rollIndex += 1;
         }
 
         if (valid) {
@@ -216,48 +489,145 @@ std::vector<uint32_t> SeedHelper::findSeedWorker(const RollSequence &previousRol
         }
     } while (initial_seed++ != seedStop);  // I hate `++`, but for an unsigned int this seems to be the best solution.
 
+    if constexpr (Counters::isEnabled) {
+        counters.seedsEvaluated += static_cast<uint64_t>(seedStop - seedStart) + 1;
+        counters.seedsMatched += returnValue.size();
+    }
+    return returnValue;
+}
+
+template <typename Counters>
+std::vector<uint32_t> SeedHelper::findSeedWithUncertainDrinksWorker(const RollSequence &previousRolls, const uint32_t seedStart, const uint32_t seedStop, Counters& counters) const {
+    assert(seedStart <= seedStop);
+
+    auto returnValue = std::vector<uint32_t>();
+
+    /// Seeds reachable after the current roll (deduplicated).
+    std::vector<uint32_t> currentSeeds{};
+    std::vector<uint32_t> nextSeeds{};
+    std::array<uint32_t, 2> rollNextSeeds{};
+
+    if (previousRolls.empty()) {
+        return findSeedWorker(previousRolls, seedStart, seedStop, counters);
+    }
+    const auto [firstExpectedResults, firstDrinks] = *previousRolls.begin();
+
+    uint32_t initial_seed = seedStart;
+    do {
+        // First roll: Most seeds are rejected here, so skip the intermediate seed vectors.
+        const auto firstNextSeedsCount = generateRollWithDrinks(initial_seed, firstDrinks, firstExpectedResults, rollNextSeeds);
+        if (firstNextSeedsCount == 0) {
+            if constexpr (Counters::isEnabled) {
+                counters.countRejection(0);
+            }
+            continue;
+        }
+        currentSeeds.assign(rollNextSeeds.begin(), rollNextSeeds.begin() + firstNextSeedsCount);
+
+        for (auto it = previousRolls.begin() + 1; it != previousRolls.end(); it += 1) {
+            const auto [expectedResults, drinks] = *it;
+            nextSeeds.clear();
+            for (const auto seed: currentSeeds) {
+                const auto rollNextSeedsCount = generateRollWithDrinks(seed, drinks, expectedResults, rollNextSeeds);
+                for (size_t i = 0; i < rollNextSeedsCount; i += 1) {
+                    if (std::find(nextSeeds.begin(), nextSeeds.end(), rollNextSeeds[i]) == nextSeeds.end()) {
+                        nextSeeds.push_back(rollNextSeeds[i]);
+                    }
+                }
+            }
+
+            std::swap(currentSeeds, nextSeeds);
+            if (currentSeeds.empty()) {
+                if constexpr (Counters::isEnabled) {
+                    counters.countRejection(static_cast<size_t>(it - previousRolls.begin()));
+                }
+                break;
+            }
+        }
+
+        if (!currentSeeds.empty()) {
+            returnValue.push_back(initial_seed);
+        }
+    } while (initial_seed++ != seedStop);
+
+    if constexpr (Counters::isEnabled) {
+        counters.seedsEvaluated += static_cast<uint64_t>(seedStop - seedStart) + 1;
+        counters.seedsMatched += returnValue.size();
+    }
     return returnValue;
 }
 
-std::vector<uint32_t> SeedHelper::findSeed(const RollSequence &previousRolls, const size_t workersCount) {
+std::vector<uint32_t> SeedHelper::findSeed(const RollSequence &previousRolls, const SearchConfiguration& configuration, SearchStats* const stats) {
+    return findSeedInRange(previousRolls, 0, UINT32_MAX, configuration, stats);
+}
+
+std::vector<uint32_t> SeedHelper::findSeedInRange(const RollSequence& previousRolls, const uint32_t seedStart, const uint32_t seedStop, const SearchConfiguration& configuration, SearchStats* const stats) {
     // Cache weights with drinks applied.
+    Trace::begin("cache");
     const auto drinksUsed = previousRolls.getDrinksUsed();
     for (const auto drink: drinksUsed) {
         cacheDrinkRollToAbilityMap(drink);
     }
+    Trace::end("cache");
+
+    // Workers take inclusive ranges.
+    const auto seedsCount = static_cast<size_t>(seedStop) - seedStart + 1;
+    const auto countHardwareEvents = (stats != nullptr) && stats->countHardwareEvents;
+    const auto workersCount = configuration.workersCount;
+    const auto chunksCount = workersCount * configuration.chunksPerWorker;
+    const auto search = [this, &previousRolls, seedStart, seedsCount, workersCount, chunksCount, countHardwareEvents](auto noCounters) {
+        using Counters = decltype(noCounters);
+
+        // Uncertain drinks need the (slower) branching worker.
+        const auto worker = previousRolls.hasUncertainDrinks() ? &SeedHelper::findSeedWithUncertainDrinksWorker<Counters> : &SeedHelper::findSeedWorker<Counters>;
+
+        return Parallel::mapChunks(seedsCount, workersCount, chunksCount, [this, worker, &previousRolls, seedStart, countHardwareEvents](const size_t start, const size_t stop) {
+            // Argument: The chunk's first seed.
+            const Trace::Scope traceScope{"scan", static_cast<int64_t>(seedStart + start)};
+            Counters counters{};
+            std::vector<uint32_t> results{};
+            if (start != stop) {
+                const auto workerSeedStart = static_cast<uint32_t>(seedStart + start);
+                const auto workerSeedStop = static_cast<uint32_t>(seedStart + stop - 1);
+                if constexpr (Counters::isEnabled) {
+                    // Opened before timing starts, and only counted around the scan.
+                    std::optional<HardwareCounters> hardwareCounters{};
+                    if (countHardwareEvents) {
+                        hardwareCounters.emplace();
+                    }
 
-    if (workersCount == 0) {
-        // Don't use worker threads.
-        return findSeedWorker(previousRolls, 0, UINT32_MAX);
-    } else {
-        // Use multiple threads.
-        std::vector<std::future<std::vector<uint32_t>>> futures{};
-        futures.reserve(workersCount);
-
-        // First (workersCount - 1) tasks.
-        for (size_t i = 0; i < (workersCount - 1); i += 1) {
-            const auto seedStart = UINT32_MAX / workersCount * i;
-            const auto seedStop = UINT32_MAX / workersCount * (i + 1) - 1;
-            auto currentFuture = std::async(std::launch::async, [this, &previousRolls, seedStart, seedStop]() {
-                return this->findSeedWorker(previousRolls, seedStart, seedStop);
-            });  // Dirty workaround using lambda 😂.
-            futures.push_back(std::move(currentFuture));
-        }
-        // Final task: Note `finalStop`.
-        auto finalFuture = std::async(std::launch::async, [this, &previousRolls, &workersCount]() {
-            const auto finalStart = UINT32_MAX / workersCount * (workersCount - 1);
-            constexpr auto finalStop = UINT32_MAX;
-            return this->findSeedWorker(previousRolls, finalStart, finalStop);
+                    const Stopwatch stopwatch{CLOCK_THREAD_CPUTIME_ID};
+                    if (hardwareCounters.has_value()) {
+                        hardwareCounters->start();
+                    }
+                    results = (this->*worker)(previousRolls, workerSeedStart, workerSeedStop, counters);
+                    if (hardwareCounters.has_value()) {
+                        counters.workerHardwareCounts.push_back(hardwareCounters->stop());
+                    }
+                    counters.workerTimings.push_back(stopwatch.getElapsed());
+                } else {
+                    results = (this->*worker)(previousRolls, workerSeedStart, workerSeedStop, counters);
+                }
+            }
+            return std::make_pair(std::move(results), std::move(counters));
         });
-        futures.push_back(std::move(finalFuture));
-
-        // Construct return value.
-        std::vector<uint32_t> returnValue{};
-        for (auto& future: futures) {
-            const auto workerResults = future.get();
-            returnValue.insert(returnValue.end(), workerResults.begin(), workerResults.end());
+    };
+
+    std::vector<uint32_t> returnValue{};
+    const auto appendResults = [&returnValue, stats](const auto& workerResults) {
+        const Trace::Scope traceScope{"merge"};
+        for (const auto& [results, counters]: workerResults) {
+            returnValue.insert(returnValue.end(), results.begin(), results.end());
+            if constexpr (std::decay_t<decltype(counters)>::isEnabled) {
+                *stats += counters;
+            }
         }
-
-        return returnValue;
+    };
+    if (stats == nullptr) {
+        appendResults(search(NoSearchStats{}));
+    } else {
+        appendResults(search(SearchStats{}));
     }
+
+    return returnValue;
 }
@@ -5,6 +5,7 @@
 #ifndef SPLATOON_3_GEAR_HELPER_CPP_SEED_HELPER_H
 #define SPLATOON_3_GEAR_HELPER_CPP_SEED_HELPER_H
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -12,6 +13,22 @@
 #include <unordered_map>
 
 #include "data/roll_sequence.h"
+#include "helpers/stats.h"
+
+
+/// How `SeedHelper::findSeed` splits its work between threads (tuned with `find --autotune`).
+struct SearchConfiguration {
+    /// 0: Search on the current thread.
+    size_t workersCount;
+    /**
+     * - 1: Each worker scans 1 contiguous range
+     * - More: Workers take smaller chunks in turn, so that slow workers don't hold up the whole search
+     */
+    size_t chunksPerWorker;
+
+    /// Implicit, so that callers can pass a workers count only.
+    SearchConfiguration(const size_t workersCount = 0, const size_t chunksPerWorker = 1): workersCount{workersCount}, chunksPerWorker{chunksPerWorker} {}
+};
 
 
 class SeedHelper {
@@ -51,18 +68,48 @@ private:
     std::array<std::pair<uint32_t, std::vector<Ability>>, AbilityHelper::abilitiesCount> drinkRollToAbilityMap;
 
 public:
+    /// No-op if `drink` is already cached.
     void cacheDrinkRollToAbilityMap(Ability drink);
 
-    /// Cache `drinkRollToAbilityMap` for all drink types.
+    /**
+     * Cache `drinkRollToAbilityMap` for all drink types.
+     *
+     * Afterwards, all `const` roll functions are safe to call from multiple threads.
+     */
     void cacheAllDrinkRollToAbilityMaps();
 
 #pragma mark Seed
 public:
     static uint32_t advanceSeed(uint32_t seed);
 
+    /// `advanceSeed` visits all non-zero seeds in 1 cycle of this length (0 maps to itself).
+    static constexpr uint32_t cycleLength = 0xffffffff;
+
+    /**
+     * Position of `seed` in `advanceSeed`'s cycle: The number of `advanceSeed` calls from seed 1 to `seed`.
+     *
+     * A discrete logarithm, solved with Pohlig-Hellman (`cycleLength` = 3 * 5 * 17 * 257 * 65537) in ~1k field multiplications.
+     *
+     * @return [0, cycleLength)
+     * @throws std::invalid_argument for seed 0 (not on the cycle).
+     */
+    [[nodiscard]] static uint32_t cyclePosition(uint32_t seed);
+
+    /// Inverse of `cyclePosition`: Seed 1 advanced `position` times (modulo `cycleLength`).
+    [[nodiscard]] static uint32_t seedAtPosition(uint32_t position);
+
+    /**
+     * Number of `advanceSeed` calls from `fromSeed` to `toSeed`, e.g. from a gear's logged seed to a seed observed later.
+     *
+     * @return [0, cycleLength)
+     * @throws std::invalid_argument if either seed is 0.
+     */
+    [[nodiscard]] static uint32_t stepsBetween(uint32_t fromSeed, uint32_t toSeed);
+
     /**
      * Advance from `initialSeed` to the end of the roll sequence.
      * The roll sequence is verified against the initial initialSeed.
+     * Every roll must have exactly 1 drink (or `noDrink`).
      *
      * Used in predictions.
      *
@@ -70,6 +117,12 @@ public:
      */
     [[nodiscard]] std::pair<bool, uint32_t> advanceSeedToEndOfRollSequence(uint32_t initialSeed, const RollSequence& rollSequence);
 
+    /**
+     * `advanceSeedToEndOfRollSequence` without caching drink weights.
+     * The drinks in `rollSequence` must already be cached.
+     */
+    [[nodiscard]] std::pair<bool, uint32_t> replayRollSequence(uint32_t initialSeed, const RollSequence& rollSequence) const;
+
 #pragma mark Roll abilities
 public:
     [[nodiscard]] Ability getBrandedAbility(uint32_t seed) const;
@@ -85,6 +138,18 @@ public:
 
     [[nodiscard]] std::pair<uint32_t, Ability> generateRollWithDrink(uint32_t seed, Ability drink) const;
 
+    /**
+     * Roll once with any of `drinks` (may contain `noDrink`), keeping only the outcomes in `expectedAbilities`.
+     *
+     * All drinks share the first seed advance, so there are at most 2 distinct next seeds:
+     *
+     * - 1 advance: The drink's ability (30% chance), or a no-drink roll
+     * - 2 advances: A roll with a drink's weights applied
+     *
+     * @return Number of next seeds written to `nextSeeds` (0 to 2).
+     */
+    size_t generateRollWithDrinks(uint32_t seed, AbilitySet drinks, AbilitySet expectedAbilities, std::array<uint32_t, 2>& nextSeeds) const;
+
 public:
     /**
      * Generate `length` rolls at once.
@@ -102,11 +167,38 @@ public:
 
 #pragma mark Find seed
 private:
-    /// Find valid seeds in the range [seedStart, seedStop].
-    [[nodiscard]] std::vector<uint32_t> findSeedWorker(const RollSequence& previousRolls, uint32_t seedStart, uint32_t seedStop) const;
+    /**
+     * Find valid seeds in the range [seedStart, seedStop].
+     *
+     * @tparam Counters `SearchStats` (with `--stats`) or `NoSearchStats` (counting compiled out).
+     */
+    template <typename Counters>
+    [[nodiscard]] std::vector<uint32_t> findSeedWorker(const RollSequence& previousRolls, uint32_t seedStart, uint32_t seedStop, Counters& counters) const;
+
+    /**
+     * `findSeedWorker` for roll sequences with uncertain drinks.
+     *
+     * Each initial seed follows every possible drink chain.
+     * Identical intermediate seeds are merged, and a seed is dropped as soon as no chain matches.
+     * Drink hits and misses aren't counted (a roll may follow several chains).
+     */
+    template <typename Counters>
+    [[nodiscard]] std::vector<uint32_t> findSeedWithUncertainDrinksWorker(const RollSequence& previousRolls, uint32_t seedStart, uint32_t seedStop, Counters& counters) const;
 
 public:
-    std::vector<uint32_t> findSeed(const RollSequence& previousRolls, size_t workersCount = 0);
+    /**
+     * Find all initial seeds matching `previousRolls`.
+     *
+     * @param stats If not null, each chunk's counters and time are added to it (`--stats`).
+     */
+    std::vector<uint32_t> findSeed(const RollSequence& previousRolls, const SearchConfiguration& configuration = {}, SearchStats* stats = nullptr);
+
+    /**
+     * `findSeed` over the initial seeds [seedStart, seedStop] only.
+     *
+     * Used for partial searches (e.g. benchmarks).
+     */
+    std::vector<uint32_t> findSeedInRange(const RollSequence& previousRolls, uint32_t seedStart, uint32_t seedStop, const SearchConfiguration& configuration = {}, SearchStats* stats = nullptr);
 };
 
 
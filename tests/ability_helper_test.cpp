@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 
 #include "../data/ability.h"
+#include "../data/ability_set.h"
 
 
 using namespace AbilityHelper;
@@ -18,6 +19,11 @@ TEST(AbilityHelperTest, FromId) {
 
     auto placeholderAbility = fromId(placeholderId);
     EXPECT_EQ(placeholderAbility, Ability::unknown);
+
+    // Near misses and short strings.
+    for (const auto invalidId: {"", "in", "ink", "ink_saver_mai", "ink_saver_mainn", "Ink_saver_main", "unknowm", "none", "null"}) {
+        EXPECT_THROW(fromId(invalidId), std::invalid_argument) << invalidId;
+    }
 }
 
 
@@ -38,3 +44,46 @@ TEST(AbilityHelperTest, GetIndex) {
         EXPECT_EQ(getIndex(ability), i);
     }
 }
+
+
+#pragma mark AbilitySet
+TEST(AbilitySetTest, SingleAbility) {
+    for (size_t i = 0; i < ids.size(); i += 1) {
+        const auto ability = static_cast<Ability>(i);
+        const AbilitySet abilitySet{ability};
+        EXPECT_EQ(abilitySet.size(), 1);
+        EXPECT_FALSE(abilitySet.isUnknown());
+        EXPECT_EQ(abilitySet.toVector(), std::vector<Ability>{ability});
+
+        for (size_t j = 0; j < ids.size(); j += 1) {
+            EXPECT_EQ(abilitySet.contains(static_cast<Ability>(j)), i == j);
+        }
+    }
+}
+
+
+TEST(AbilitySetTest, Unknown) {
+    const AbilitySet abilitySet{Ability::unknown};
+    EXPECT_EQ(abilitySet.size(), abilitiesCount);
+    EXPECT_TRUE(abilitySet.isUnknown());
+    EXPECT_FALSE(abilitySet.contains(Ability::noDrink));
+    for (size_t i = 0; i < ids.size(); i += 1) {
+        EXPECT_TRUE(abilitySet.contains(static_cast<Ability>(i)));
+    }
+}
+
+
+TEST(AbilitySetTest, Insert) {
+    AbilitySet abilitySet{};
+    EXPECT_TRUE(abilitySet.empty());
+
+    abilitySet.insert(Ability::inkSaverSub);
+    abilitySet.insert(Ability::inkSaverMain);
+    abilitySet.insert(Ability::inkSaverSub);
+    EXPECT_EQ(abilitySet.size(), 2);
+    EXPECT_TRUE(abilitySet.contains(Ability::inkSaverMain));
+    EXPECT_TRUE(abilitySet.contains(Ability::inkSaverSub));
+    EXPECT_FALSE(abilitySet.contains(Ability::inkRecoveryUp));
+    EXPECT_EQ(abilitySet.toVector(), std::vector<Ability>({Ability::inkSaverMain, Ability::inkSaverSub}));
+    EXPECT_NE(abilitySet, AbilitySet{Ability::inkSaverMain});
+}
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include "../batch_verifier.h"
+#include "../data/brand.h"
+
+#include "roll_randomizer.h"
+
+
+namespace {
+    struct Submission {
+        std::string brand;
+        uint32_t initialSeed;
+        RollSequence rollSequence;
+    };
+
+    /// Rolls of random gears with random drinks. Every 3rd submission has 1 wrong roll.
+    std::vector<Submission> makeSubmissions(const size_t count) {
+        std::vector<SeedHelper> seedHelpers{};
+        for (const auto brand: {neutralBrands[0], std::get<0>(biasedBrands[3]), std::get<0>(biasedBrands[16])}) {
+            seedHelpers.emplace_back(brand);
+            seedHelpers.back().cacheAllDrinkRollToAbilityMaps();
+        }
+
+        RollRandomizer randomizer{20221106};
+        std::vector<Submission> returnValue{};
+        for (size_t i = 0; i < count; i += 1) {
+            const auto& seedHelper = seedHelpers[i % seedHelpers.size()];
+            Submission submission{seedHelper.brandName, randomizer.getSeed(), {}};
+
+            auto seed = submission.initialSeed;
+            const auto length = i % 24;
+            for (size_t j = 0; j < length; j += 1) {
+                const auto drink = (j % 3 == 1) ? randomizer.getAbility() : Ability::noDrink;
+                Ability ability;
+                std::tie(seed, ability) = (drink == Ability::noDrink) ? seedHelper.generateRoll(seed) : seedHelper.generateRollWithDrink(seed, drink);
+
+                if ((i % 3 == 0) && (j == length / 2)) {
+                    ability = static_cast<Ability>((AbilityHelper::getIndex(ability) + 1) % AbilityHelper::abilitiesCount);
+                } else if (j % 5 == 4) {
+                    submission.rollSequence.addRoll(Ability::unknown, drink);
+                    continue;
+                }
+                submission.rollSequence.addRoll(ability, drink);
+            }
+            returnValue.push_back(std::move(submission));
+        }
+
+        return returnValue;
+    }
+
+    /// Expected result, by replaying 1 roll at a time.
+    VerificationResult getExpectedResult(SeedHelper& seedHelper, const Submission& submission) {
+        auto seed = submission.initialSeed;
+        uint32_t i = 0;
+        for (const auto [abilities, drinks]: submission.rollSequence) {
+            RollSequence roll{};
+            roll.addRoll(abilities, drinks);
+            const auto [isValid, nextSeed] = seedHelper.advanceSeedToEndOfRollSequence(seed, roll);
+            seed = nextSeed;
+            if (!isValid) {
+                return VerificationResult{false, i, seed};
+            }
+            i += 1;
+        }
+        return VerificationResult{true, i, seed};
+    }
+}
+
+
+TEST(BatchVerifierTest, Verify) {
+    const auto submissions = makeSubmissions(2000);
+    SubmissionBatch batch{};
+    for (const auto& [brand, initialSeed, rollSequence]: submissions) {
+        batch.add(brand, initialSeed, rollSequence);
+    }
+    ASSERT_EQ(batch.size(), submissions.size());
+
+    const BatchVerifier verifier{};
+    for (const auto workersCount: {0, 3}) {
+        const auto results = verifier.verify(batch, workersCount);
+        ASSERT_EQ(results.size(), submissions.size());
+
+        size_t invalidCount = 0;
+        for (size_t i = 0; i < submissions.size(); i += 1) {
+            SeedHelper seedHelper{submissions[i].brand};
+            const auto expectedResult = getExpectedResult(seedHelper, submissions[i]);
+            EXPECT_EQ(results[i].isValid, expectedResult.isValid) << "Submission " << i;
+            EXPECT_EQ(results[i].firstMismatchIndex, expectedResult.firstMismatchIndex) << "Submission " << i;
+            EXPECT_EQ(results[i].finalSeed, expectedResult.finalSeed) << "Submission " << i;
+
+            if (expectedResult.isValid) {
+                // Same as replaying the whole sequence.
+                const auto [isValid, finalSeed] = seedHelper.advanceSeedToEndOfRollSequence(submissions[i].initialSeed, submissions[i].rollSequence);
+                EXPECT_TRUE(isValid);
+                EXPECT_EQ(results[i].finalSeed, finalSeed);
+            } else {
+                invalidCount += 1;
+            }
+        }
+        // Every 3rd non-empty submission.
+        EXPECT_GT(invalidCount, submissions.size() / 4);
+    }
+}
+
+
+TEST(BatchVerifierTest, EmptyBatch) {
+    const BatchVerifier verifier{};
+    SubmissionBatch batch{};
+    EXPECT_TRUE(verifier.verify(batch, 3).empty());
+
+    batch.add("Zink", 0x1234, RollSequence{});
+    const auto results = verifier.verify(batch);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_TRUE(results[0].isValid);
+    EXPECT_EQ(results[0].firstMismatchIndex, 0);
+    EXPECT_EQ(results[0].finalSeed, 0x1234);
+}
+
+
+TEST(BatchVerifierTest, InvalidSubmissions) {
+    SubmissionBatch batch{};
+    EXPECT_THROW(batch.add("Not a brand", 1, RollSequence{}), std::invalid_argument);
+
+    RollSequence rollSequence{};
+    rollSequence.addRoll(Ability::inkSaverMain, AbilitySet::anyDrink());
+    EXPECT_THROW(batch.add("Zink", 1, rollSequence), std::invalid_argument);
+    EXPECT_EQ(batch.size(), 0);
+}
@@ -0,0 +1,180 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "../prediction/build_planner.h"
+
+#include "temporary_files.h"
+
+
+namespace {
+    /// Replay `plan` and check that it ends with a streak of the piece's target.
+    void verifyPlan(const BuildPlanner::Piece& piece, const DrinkPlanner::Plan& plan) {
+        SeedHelper seedHelper{piece.brand};
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        auto seed = piece.seed;
+        size_t drinksCount = 0;
+        size_t streak = 0;
+        for (const auto& [drink, expectedAbility, expectedSeed]: plan.steps) {
+            Ability ability;
+            std::tie(seed, ability) = (drink == Ability::noDrink) ? seedHelper.generateRoll(seed) : seedHelper.generateRollWithDrink(seed, drink);
+            drinksCount += (drink == Ability::noDrink) ? 0 : 1;
+            streak = (ability == piece.target) ? (streak + 1) : 0;
+            EXPECT_EQ(ability, expectedAbility);
+            EXPECT_EQ(seed, expectedSeed);
+        }
+        EXPECT_EQ(drinksCount, plan.drinksCount);
+        EXPECT_EQ(streak, piece.streakLength);
+    }
+
+    const std::vector<BuildPlanner::Piece> pieces{
+        {"Zink", 0x907b1ae9, Ability::swimSpeedUp, 3},
+        {"Krak-On", 0x12345678, Ability::subResistanceUp, 3},
+        {"Toni Kensa", 0x87b091, Ability::runSpeedUp, 2},
+    };
+}
+
+
+TEST(BuildPlannerTest, MatchesAllCombinations) {
+    constexpr size_t horizon = 60;
+    BuildPlanner::Planner planner{horizon};
+    const auto buildPlans = planner.findPlans(pieces, 3);
+    ASSERT_FALSE(buildPlans.empty());
+
+    // Every combination of the pieces' fronts.
+    const auto fronts = planner.getFronts(pieces);
+    std::vector<std::pair<size_t, size_t>> expectedCosts{};
+    for (const auto& plan0: *fronts[0]) {
+        for (const auto& plan1: *fronts[1]) {
+            for (const auto& plan2: *fronts[2]) {
+                expectedCosts.emplace_back(plan0.steps.size() + plan1.steps.size() + plan2.steps.size(), plan0.drinksCount + plan1.drinksCount + plan2.drinksCount);
+            }
+        }
+    }
+    std::sort(expectedCosts.begin(), expectedCosts.end());
+    std::vector<std::pair<size_t, size_t>> expectedFront{};
+    for (const auto& cost: expectedCosts) {
+        if (expectedFront.empty() || (cost.second < expectedFront.back().second)) {
+            expectedFront.push_back(cost);
+        }
+    }
+
+    ASSERT_EQ(buildPlans.size(), expectedFront.size());
+    for (size_t i = 0; i < buildPlans.size(); i += 1) {
+        const auto& [rollsCount, drinksCount, plans] = buildPlans[i];
+        EXPECT_EQ(rollsCount, expectedFront[i].first);
+        EXPECT_EQ(drinksCount, expectedFront[i].second);
+
+        ASSERT_EQ(plans.size(), pieces.size());
+        size_t totalRollsCount = 0;
+        size_t totalDrinksCount = 0;
+        for (size_t j = 0; j < pieces.size(); j += 1) {
+            verifyPlan(pieces[j], plans[j]);
+            totalRollsCount += plans[j].steps.size();
+            totalDrinksCount += plans[j].drinksCount;
+        }
+        EXPECT_EQ(totalRollsCount, rollsCount);
+        EXPECT_EQ(totalDrinksCount, drinksCount);
+    }
+
+    // Ends: Each piece's fewest rolls, and each piece's fewest drinks.
+    for (const auto objective: {DrinkPlanner::Objective::fewestRolls, DrinkPlanner::Objective::fewestDrinks}) {
+        size_t rollsCount = 0;
+        size_t drinksCount = 0;
+        for (const auto& [brand, seed, target, streakLength]: pieces) {
+            SeedHelper seedHelper{brand};
+            const auto plan = DrinkPlanner::findPlan(seedHelper, seed, target, streakLength, horizon, objective);
+            ASSERT_TRUE(plan.has_value());
+            rollsCount += plan->steps.size();
+            drinksCount += plan->drinksCount;
+        }
+        const auto& buildPlan = (objective == DrinkPlanner::Objective::fewestRolls) ? buildPlans.front() : buildPlans.back();
+        EXPECT_EQ(buildPlan.rollsCount, rollsCount);
+        EXPECT_EQ(buildPlan.drinksCount, drinksCount);
+    }
+}
+
+
+TEST(BuildPlannerTest, CachedFronts) {
+    BuildPlanner::Planner planner{60};
+    const auto buildPlans = planner.findPlans(pieces);
+    EXPECT_EQ(planner.getCachedFrontsCount(), 3);
+
+    // Only the changed piece is searched.
+    auto otherPieces = pieces;
+    otherPieces[1].target = Ability::inkSaverMain;
+    planner.findPlans(otherPieces, 3);
+    EXPECT_EQ(planner.getCachedFrontsCount(), 4);
+
+    const auto cachedBuildPlans = planner.findPlans(pieces, 3);
+    EXPECT_EQ(planner.getCachedFrontsCount(), 4);
+    ASSERT_EQ(cachedBuildPlans.size(), buildPlans.size());
+    for (size_t i = 0; i < buildPlans.size(); i += 1) {
+        EXPECT_EQ(cachedBuildPlans[i].rollsCount, buildPlans[i].rollsCount);
+        EXPECT_EQ(cachedBuildPlans[i].drinksCount, buildPlans[i].drinksCount);
+    }
+}
+
+
+TEST(BuildPlannerTest, Unreachable) {
+    BuildPlanner::Planner planner{2};
+    EXPECT_TRUE(planner.findPlans(pieces).empty());
+    EXPECT_TRUE(planner.findPlans({}).empty());
+}
+
+
+TEST(BuildPlannerTest, SaveAndLoad) {
+    // `save` creates the missing "cache" directory.
+    const TemporaryDirectory temporaryDirectory{"build_planner"};
+    const auto& directory = temporaryDirectory.path;
+    const auto filename = (directory / "cache" / "build_plans.txt").string();
+
+    BuildPlanner::Planner planner{60};
+    planner.load(filename);
+    const auto buildPlans = planner.findPlans(pieces);
+    EXPECT_EQ(planner.getSearchedFrontsCount(), 3);
+    planner.save(filename);
+
+    // A later run only searches the new piece.
+    BuildPlanner::Planner loadedPlanner{60};
+    loadedPlanner.load(filename);
+    const auto loadedBuildPlans = loadedPlanner.findPlans(pieces);
+    EXPECT_EQ(loadedPlanner.getSearchedFrontsCount(), 0);
+    ASSERT_EQ(loadedBuildPlans.size(), buildPlans.size());
+    for (size_t i = 0; i < buildPlans.size(); i += 1) {
+        EXPECT_EQ(loadedBuildPlans[i].rollsCount, buildPlans[i].rollsCount);
+        EXPECT_EQ(loadedBuildPlans[i].drinksCount, buildPlans[i].drinksCount);
+        for (size_t j = 0; j < pieces.size(); j += 1) {
+            verifyPlan(pieces[j], loadedBuildPlans[i].plans[j]);
+        }
+    }
+
+    auto otherPieces = pieces;
+    otherPieces[1].target = Ability::inkSaverMain;
+    loadedPlanner.findPlans(otherPieces);
+    EXPECT_EQ(loadedPlanner.getSearchedFrontsCount(), 1);
+
+    // Other horizons are searched again.
+    BuildPlanner::Planner otherHorizonPlanner{50};
+    otherHorizonPlanner.load(filename);
+    otherHorizonPlanner.findPlans(pieces);
+    EXPECT_EQ(otherHorizonPlanner.getSearchedFrontsCount(), 3);
+
+    // Plans that don't end with the streak (e.g. edited files) are searched again.
+    {
+        std::ofstream file{filename, std::ios::trunc};
+        file << "Zink\t2427132649\tswim_speed_up\t3\t60\tnone,none\n";
+    }
+    BuildPlanner::Planner editedPlanner{60};
+    editedPlanner.load(filename);
+    editedPlanner.findPlans({BuildPlanner::Piece{"Zink", 2427132649, Ability::swimSpeedUp, 3}});
+    EXPECT_EQ(editedPlanner.getSearchedFrontsCount(), 1);
+
+    {
+        std::ofstream file{filename, std::ios::trunc};
+        file << "Zink\t2427132649\tnot_an_ability\t3\t60\n";
+    }
+    EXPECT_THROW(editedPlanner.load(filename), std::runtime_error);
+}
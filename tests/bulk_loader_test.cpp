@@ -0,0 +1,91 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "../binary/gear_file.h"
+#include "../yaml/bulk_loader.h"
+#include "../yaml/yaml_helper.h"
+
+#include "roll_randomizer.h"
+#include "temporary_files.h"
+
+
+TEST(BulkLoaderTest, LoadDirectory) {
+    const TemporaryDirectory temporaryDirectory{"splatoon_bulk_"};
+    const auto& directory = temporaryDirectory.path;
+
+    // Valid files.
+    constexpr size_t validFilesCount = 50;
+    std::vector<RollSequence::DataType> expectedRolls{};
+    for (size_t i = 0; i < validFilesCount; i += 1) {
+        const auto filename = directory / ("gear_" + std::to_string(100 + i) + ".yaml");
+        std::optional<uint32_t> initialSeed{};
+        if (i % 3 != 0) {
+            initialSeed = static_cast<uint32_t>(i * 1000);
+        }
+
+        expectedRolls.push_back(getRandomRollsAndDrinks(i));
+        {
+            YamlFile yamlFile{filename.string(), "Gear " + std::to_string(i), "Takoroka", initialSeed};
+            for (const auto [ability, drink]: expectedRolls.back()) {
+                yamlFile.addRoll(ability, drink);
+            }
+        }
+
+        // Some binary files.
+        if (i % 5 == 0) {
+            GearFile::convertYamlToGear(filename.string(), (directory / ("gear_" + std::to_string(100 + i) + ".gear")).string());
+            std::filesystem::remove(filename);
+        }
+    }
+
+    // Invalid files.
+    {
+        std::ofstream f(directory / "invalid_brand.yaml");
+        f << "name: Invalid brand\nbrand: Not a brand\n";
+    }
+    {
+        std::ofstream f(directory / "invalid_yaml.yaml");
+        f << "name: [\n";
+    }
+    {
+        std::ofstream f(directory / "invalid_gear.gear");
+        f << "Not a gear file.";
+    }
+    {
+        std::ofstream f(directory / "ignored.txt");
+        f << "Ignored.";
+    }
+
+    for (const size_t workersCount: {0, 1, 4, 64}) {
+        const auto collection = BulkLoader::loadDirectory(directory.string(), workersCount);
+        ASSERT_EQ(collection.gears.size(), validFilesCount);
+        EXPECT_EQ(collection.errors.size(), 3);
+
+        size_t rollsCount = 0;
+        for (size_t i = 0; i < validFilesCount; i += 1) {
+            const auto& gear = collection.gears[i];
+            EXPECT_EQ(gear.name, "Gear " + std::to_string(i));
+            EXPECT_EQ(collection.getBrand(i), "Takoroka");
+            EXPECT_EQ(gear.initialSeed.has_value(), (i % 3 != 0));
+
+            const auto rollSequence = collection.getRollSequence(i);
+            ASSERT_EQ(rollSequence.size(), expectedRolls[i].size());
+            for (size_t j = 0; j < rollSequence.size(); j += 1) {
+                EXPECT_EQ((rollSequence.begin() + j)->first, AbilitySet{expectedRolls[i][j].first});
+                EXPECT_EQ((rollSequence.begin() + j)->second, AbilitySet{expectedRolls[i][j].second});
+            }
+            rollsCount += rollSequence.size();
+        }
+        EXPECT_EQ(collection.rolls.size(), rollsCount);
+    }
+}
+
+
+TEST(BulkLoaderTest, MissingFiles) {
+    const auto collection = BulkLoader::loadFiles({"/nonexistent/a.yaml", "/nonexistent/b.gear"}, 2);
+    EXPECT_TRUE(collection.gears.empty());
+    ASSERT_EQ(collection.errors.size(), 2);
+    EXPECT_EQ(collection.errors[0].filename, "/nonexistent/a.yaml");
+}
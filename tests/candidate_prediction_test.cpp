@@ -0,0 +1,64 @@
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "../prediction/candidate_prediction.h"
+
+
+TEST(CandidatePredictionTest, MatchesGenerateRolls) {
+    std::vector<uint32_t> seeds{};
+    uint32_t seed = 0xabcdef;
+    for (size_t i = 0; i < 2000; i += 1) {
+        seed = SeedHelper::advanceSeed(seed);
+        seeds.push_back(seed);
+    }
+
+    for (const auto brandName: {"Cuttlegear", "Zink"}) {
+        for (const size_t length: {1, 15, 40}) {
+            SeedHelper seedHelper{brandName};
+            const auto prediction = CandidatePrediction::predict(seedHelper, seeds, length, 3);
+            ASSERT_EQ(prediction.candidatesCount, seeds.size());
+            ASSERT_EQ(prediction.length, length);
+
+            for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+                const auto drink = AbilityHelper::getDrinkChoice(i);
+
+                // Expected counts.
+                std::vector<CandidatePrediction::AbilityCounts> expectedAbilityCounts(length, CandidatePrediction::AbilityCounts{});
+                CandidatePrediction::AbilityCounts expectedThreeStreakCounts{};
+                for (const auto currentSeed: seeds) {
+                    const auto rolls = (drink == Ability::noDrink) ? seedHelper.generateRolls(currentSeed, length) : seedHelper.generateRollsWithDrink(currentSeed, drink, length);
+
+                    std::set<Ability> threeStreakAbilities{};
+                    for (size_t j = 0; j < length; j += 1) {
+                        expectedAbilityCounts[j][AbilityHelper::getIndex(rolls[j])] += 1;
+                        if ((j >= 2) && (rolls[j - 2] == rolls[j]) && (rolls[j - 1] == rolls[j])) {
+                            threeStreakAbilities.insert(rolls[j]);
+                        }
+                    }
+                    for (const auto ability: threeStreakAbilities) {
+                        expectedThreeStreakCounts[AbilityHelper::getIndex(ability)] += 1;
+                    }
+                }
+
+                const std::string testCaseDescription = std::string{"Brand: "} + brandName + "; Length: " + std::to_string(length) + "; Drink choice: " + std::to_string(i);
+                for (size_t j = 0; j < length; j += 1) {
+                    EXPECT_EQ(prediction.getAbilityCounts(i, j), expectedAbilityCounts[j]) << testCaseDescription;
+                }
+                EXPECT_EQ(prediction.threeStreakCounts[i], expectedThreeStreakCounts) << testCaseDescription;
+            }
+        }
+    }
+}
+
+
+TEST(CandidatePredictionTest, Probability) {
+    SeedHelper seedHelper{"Zekko"};
+    const auto prediction = CandidatePrediction::predict(seedHelper, {0x1, 0x2, 0x3, 0x4});
+    EXPECT_DOUBLE_EQ(prediction.getProbability(0), 0);
+    EXPECT_DOUBLE_EQ(prediction.getProbability(1), 0.25);
+    EXPECT_DOUBLE_EQ(prediction.getProbability(4), 1);
+
+    const auto emptyPrediction = CandidatePrediction::predict(seedHelper, {});
+    EXPECT_DOUBLE_EQ(emptyPrediction.getProbability(0), 0);
+}
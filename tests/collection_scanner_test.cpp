@@ -0,0 +1,92 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "../binary/gear_file.h"
+#include "../prediction/collection_scanner.h"
+#include "../seed_helper.h"
+#include "../yaml/yaml_helper.h"
+
+#include "temporary_files.h"
+
+
+TEST(CollectionScannerTest, LoadAndScan) {
+    const TemporaryDirectory temporaryDirectory{"splatoon_collection_"};
+    const auto& directory = temporaryDirectory.path;
+
+    // Valid files (test cases from `SeedHelperTest`).
+    {
+        YamlFile yamlFile{(directory / "zekko.yaml").string(), "Zekko gear", "Zekko", 0x87b091};
+        for (const auto ability: {Ability::subResistanceUp, Ability::specialSaver, Ability::quickSuperJump, Ability::swimSpeedUp}) {
+            yamlFile.addRoll(ability);
+        }
+    }
+    {
+        YamlFile yamlFile{(directory / "zink.yml").string(), "Zink gear", "Zink", 0x907b1ae9};
+        for (const auto ability: {Ability::quickSuperJump, Ability::quickSuperJump, Ability::quickSuperJump, Ability::specialPowerUp, Ability::swimSpeedUp, Ability::specialSaver, Ability::quickSuperJump, Ability::inkSaverMain, Ability::quickSuperJump, Ability::inkRecoveryUp}) {
+            yamlFile.addRoll(ability, Ability::quickSuperJump);
+        }
+    }
+    // Binary gear file.
+    GearFile::convertYamlToGear((directory / "zink.yml").string(), (directory / "zink.gear").string());
+    std::filesystem::remove(directory / "zink.yml");
+    // Invalid files.
+    {
+        YamlFile yamlFile{(directory / "no_seed.yaml").string(), "No seed", "Zink", {}};
+        yamlFile.addRoll(Ability::inkSaverMain);
+    }
+    {
+        YamlFile yamlFile{(directory / "wrong_seed.yaml").string(), "Wrong seed", "Zekko", 0x87b092};
+        yamlFile.addRoll(Ability::subResistanceUp);
+        yamlFile.addRoll(Ability::subResistanceUp);
+    }
+    {
+        std::ofstream f(directory / "not_gear.txt");
+        f << "Not a YAML file.";
+    }
+
+    const auto collection = CollectionScanner::loadCollection(directory.string(), 3);
+    ASSERT_EQ(collection.gears.size(), 2);
+    EXPECT_EQ(collection.errors.size(), 2);
+    EXPECT_EQ(collection.gears[0].name, "Zekko gear");
+    EXPECT_EQ(collection.gears[1].name, "Zink gear");
+    EXPECT_EQ(collection.gears[1].finalSeed, 0x6aeddb71);
+
+    // Scan and compare with `generateRolls`.
+    constexpr size_t horizon = 60;
+    const std::vector<Ability> targets{Ability::swimSpeedUp, Ability::quickSuperJump, Ability::specialSaver};
+    const auto opportunities = CollectionScanner::findOpportunities(collection.gears, targets, 3, horizon, 2);
+    for (size_t i = 1; i < opportunities.size(); i += 1) {
+        EXPECT_LE(opportunities[i - 1].rollsCount, opportunities[i].rollsCount);
+    }
+
+    for (size_t i = 0; i < collection.gears.size(); i += 1) {
+        SeedHelper seedHelper{collection.gears[i].brand};
+        for (const auto target: targets) {
+            // Expected: (rolls, drink choice) of the soonest streak.
+            std::pair<size_t, size_t> expected{SIZE_MAX, 0};
+            for (size_t j = 0; j < AbilityHelper::drinkChoicesCount; j += 1) {
+                const auto drink = AbilityHelper::getDrinkChoice(j);
+                const auto rolls = (drink == Ability::noDrink) ? seedHelper.generateRolls(collection.gears[i].finalSeed, horizon) : seedHelper.generateRollsWithDrink(collection.gears[i].finalSeed, drink, horizon);
+                for (size_t k = 2; k < horizon; k += 1) {
+                    if ((rolls[k] == target) && (rolls[k - 1] == target) && (rolls[k - 2] == target)) {
+                        expected = std::min(expected, std::make_pair(k + 1, j));
+                        break;
+                    }
+                }
+            }
+
+            const auto it = std::find_if(opportunities.begin(), opportunities.end(), [i, target](const auto& opportunity) {
+                return (opportunity.gearIndex == i) && (opportunity.target == target);
+            });
+            if (expected.first == SIZE_MAX) {
+                EXPECT_EQ(it, opportunities.end());
+            } else {
+                ASSERT_NE(it, opportunities.end());
+                EXPECT_EQ(it->rollsCount, expected.first) << collection.gears[i].name << ": " << AbilityHelper::getId(target);
+                EXPECT_EQ(it->drink, AbilityHelper::getDrinkChoice(expected.second)) << collection.gears[i].name << ": " << AbilityHelper::getId(target);
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <numeric>
+
+#include "gtest/gtest.h"
+
+#include "../prediction/drink_advisor.h"
+
+
+/// Some seeds from the seed sequence starting with `initialSeed`.
+static std::vector<uint32_t> getSeeds(uint32_t initialSeed, size_t count) {
+    std::vector<uint32_t> returnValue{};
+    for (size_t i = 0; i < count; i += 1) {
+        initialSeed = SeedHelper::advanceSeed(initialSeed);
+        returnValue.push_back(initialSeed);
+    }
+
+    return returnValue;
+}
+
+
+TEST(DrinkAdvisorTest, SingleCandidate) {
+    SeedHelper seedHelper{"Zekko"};
+    const auto advice = DrinkAdvisor::adviseNextDrink(seedHelper, {0x87b091});
+
+    ASSERT_EQ(advice.size(), AbilityHelper::abilitiesCount + 1);
+    for (const auto& [drink, nextAbilityCounts, expectedRemainingCandidates]: advice) {
+        EXPECT_EQ(std::accumulate(nextAbilityCounts.begin(), nextAbilityCounts.end(), size_t{0}), 1);
+        EXPECT_DOUBLE_EQ(expectedRemainingCandidates, 1);
+    }
+}
+
+
+TEST(DrinkAdvisorTest, MatchesSerialRolls) {
+    const auto seeds = getSeeds(0x12345678, 10000);
+
+    for (const auto brandName: {"Amiibo", "Krak-On"}) {
+        SeedHelper seedHelper{brandName};
+        const auto advice = DrinkAdvisor::adviseNextDrink(seedHelper, seeds, 4);
+        ASSERT_EQ(advice.size(), AbilityHelper::abilitiesCount + 1);
+
+        for (size_t i = 1; i < advice.size(); i += 1) {
+            EXPECT_LE(advice[i - 1].expectedRemainingCandidates, advice[i].expectedRemainingCandidates);
+        }
+
+        for (const auto& [drink, nextAbilityCounts, expectedRemainingCandidates]: advice) {
+            std::array<size_t, AbilityHelper::abilitiesCount> expectedCounts{};
+            for (const auto seed: seeds) {
+                const auto ability = (drink == Ability::noDrink) ? seedHelper.generateRoll(seed).second : seedHelper.generateRollWithDrink(seed, drink).second;
+                expectedCounts[AbilityHelper::getIndex(ability)] += 1;
+            }
+            EXPECT_EQ(nextAbilityCounts, expectedCounts) << "Brand: " << brandName << "; Drink: " << AbilityHelper::getId(drink);
+            EXPECT_GE(expectedRemainingCandidates, 1);
+            EXPECT_LT(expectedRemainingCandidates, seeds.size());
+        }
+    }
+}
+
+
+TEST(DrinkAdvisorTest, GetCurrentSeeds) {
+    // Test case from `SeedHelperTest.AdvanceSeedToEndOfRollSequenceWithDrink`.
+    const std::string brand{"Zink"};
+    RollSequence rollSequence{};
+    for (const auto ability: {Ability::quickSuperJump, Ability::quickSuperJump, Ability::quickSuperJump, Ability::specialPowerUp}) {
+        rollSequence.addRoll(ability, Ability::quickSuperJump);
+    }
+    rollSequence.addRoll(Ability::swimSpeedUp);
+    const auto initialSeeds = getSeeds(0x907b1ae9, 1000);
+
+    SeedHelper seedHelper{brand};
+    const auto currentSeeds = DrinkAdvisor::getCurrentSeeds(seedHelper, initialSeeds, rollSequence, 3);
+    ASSERT_EQ(currentSeeds.size(), initialSeeds.size());
+    for (size_t i = 0; i < initialSeeds.size(); i += 1) {
+        EXPECT_EQ(currentSeeds[i], seedHelper.advanceSeedToEndOfRollSequence(initialSeeds[i], rollSequence).second);
+    }
+}
+
+
+TEST(DrinkAdvisorTest, GetCurrentSeedsWithUncertainDrinks) {
+    // Rolls with `quickSuperJump`, logged as "`quickSuperJump` or no drink".
+    SeedHelper seedHelper{"Zink"};
+    seedHelper.cacheDrinkRollToAbilityMap(Ability::quickSuperJump);
+    constexpr uint32_t initialSeed = 0x907b1ae9;
+    const AbilitySet uncertainDrinks = AbilitySet::fromMask(AbilitySet(Ability::quickSuperJump).getMask() | AbilitySet::noDrinkMask);
+
+    RollSequence rollSequence{};
+    auto seed = initialSeed;
+    for (size_t i = 0; i < 4; i += 1) {
+        Ability ability;
+        std::tie(seed, ability) = seedHelper.generateRollWithDrink(seed, Ability::quickSuperJump);
+        rollSequence.addRoll(ability, uncertainDrinks);
+    }
+    const auto finalSeed = seed;
+    ASSERT_TRUE(rollSequence.hasUncertainDrinks());
+
+    // Every resolution of the 4 uncertain drinks that matches.
+    std::vector<uint32_t> initialSeeds = getSeeds(0x12345678, 1000);
+    initialSeeds.push_back(initialSeed);
+    std::vector<uint32_t> expectedSeeds{};
+    for (const auto candidate: initialSeeds) {
+        for (uint32_t resolution = 0; resolution < (1 << 4); resolution += 1) {
+            RollSequence resolvedRollSequence{};
+            size_t i = 0;
+            for (const auto [abilities, drinks]: rollSequence) {
+                resolvedRollSequence.addRoll(abilities, ((resolution >> i) & 1) ? Ability::quickSuperJump : Ability::noDrink);
+                i += 1;
+            }
+            const auto [isValid, currentSeed] = seedHelper.replayRollSequence(candidate, resolvedRollSequence);
+            if (isValid) {
+                expectedSeeds.push_back(currentSeed);
+            }
+        }
+    }
+    std::sort(expectedSeeds.begin(), expectedSeeds.end());
+    expectedSeeds.erase(std::unique(expectedSeeds.begin(), expectedSeeds.end()), expectedSeeds.end());
+
+    for (const auto workersCount: {0, 3}) {
+        const auto currentSeeds = DrinkAdvisor::getCurrentSeeds(seedHelper, initialSeeds, rollSequence, workersCount);
+        EXPECT_EQ(currentSeeds, expectedSeeds);
+        EXPECT_NE(std::find(currentSeeds.begin(), currentSeeds.end(), finalSeed), currentSeeds.end());
+    }
+
+    // `find`'s advice for these results: Every current seed is counted once per drink.
+    const auto advice = DrinkAdvisor::adviseNextDrinkAfterRolls(seedHelper, initialSeeds, rollSequence, 3);
+    ASSERT_EQ(advice.size(), AbilityHelper::drinkChoicesCount);
+    for (const auto& [drink, nextAbilityCounts, expectedRemainingCandidates]: advice) {
+        size_t candidatesCount = 0;
+        for (const auto count: nextAbilityCounts) {
+            candidatesCount += count;
+        }
+        EXPECT_EQ(candidatesCount, expectedSeeds.size()) << AbilityHelper::getId(drink);
+        EXPECT_GT(expectedRemainingCandidates, 0);
+    }
+}
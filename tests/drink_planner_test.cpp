@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <map>
+
+#include "gtest/gtest.h"
+
+#include "../prediction/drink_planner.h"
+
+
+/**
+ * Brute force reference: Layered search over (seed, streak) without the cycle offset trick.
+ * @return (rolls, drinks) of the best plan, or (0, 0) if unreachable.
+ */
+static std::pair<size_t, size_t> findBestPlanSlowly(SeedHelper& seedHelper, uint32_t seed, Ability target, size_t streakLength, size_t horizon, DrinkPlanner::Objective objective) {
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+    std::map<std::pair<uint32_t, size_t>, size_t> currentStates{{{seed, 0}, 0}};
+    std::pair<size_t, size_t> best{0, SIZE_MAX};
+    for (size_t t = 1; t <= horizon; t += 1) {
+        std::map<std::pair<uint32_t, size_t>, size_t> nextStates{};
+        for (const auto& [state, drinksCount]: currentStates) {
+            const auto [currentSeed, streak] = state;
+            for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+                const auto drink = AbilityHelper::getDrinkChoice(i);
+                const auto [nextSeed, ability] = (drink == Ability::noDrink) ? seedHelper.generateRoll(currentSeed) : seedHelper.generateRollWithDrink(currentSeed, drink);
+                const auto nextDrinksCount = drinksCount + ((drink == Ability::noDrink) ? 0 : 1);
+                const auto nextStreak = (ability == target) ? (streak + 1) : 0;
+                if (nextStreak == streakLength) {
+                    if (nextDrinksCount < best.second) {
+                        best = std::make_pair(t, nextDrinksCount);
+                    }
+                } else {
+                    const auto key = std::make_pair(nextSeed, nextStreak);
+                    const auto it = nextStates.find(key);
+                    if ((it == nextStates.end()) || (it->second > nextDrinksCount)) {
+                        nextStates[key] = nextDrinksCount;
+                    }
+                }
+            }
+        }
+
+        if ((objective == DrinkPlanner::Objective::fewestRolls) && (best.second != SIZE_MAX)) {
+            break;
+        }
+        currentStates = std::move(nextStates);
+    }
+
+    return (best.second == SIZE_MAX) ? std::make_pair(size_t{0}, size_t{0}) : best;
+}
+
+
+/// Replay `plan` and check that it ends with a `target` streak.
+static void verifyPlan(SeedHelper& seedHelper, uint32_t seed, Ability target, size_t streakLength, const DrinkPlanner::Plan& plan) {
+    size_t drinksCount = 0;
+    for (const auto& [drink, expectedAbility, expectedSeed]: plan.steps) {
+        Ability ability;
+        if (drink == Ability::noDrink) {
+            std::tie(seed, ability) = seedHelper.generateRoll(seed);
+        } else {
+            std::tie(seed, ability) = seedHelper.generateRollWithDrink(seed, drink);
+            drinksCount += 1;
+        }
+        EXPECT_EQ(seed, expectedSeed);
+        EXPECT_EQ(ability, expectedAbility);
+    }
+    EXPECT_EQ(drinksCount, plan.drinksCount);
+
+    ASSERT_GE(plan.steps.size(), streakLength);
+    for (size_t i = plan.steps.size() - streakLength; i < plan.steps.size(); i += 1) {
+        EXPECT_EQ(plan.steps[i].ability, target);
+    }
+}
+
+
+TEST(DrinkPlannerTest, MatchesBruteForce) {
+    constexpr size_t horizon = 10;
+    for (const auto brandName: {"Grizzco", "Krak-On"}) {
+        SeedHelper seedHelper{brandName};
+        for (const uint32_t seed: {0x1u, 0x12345678u, 0x87b091u}) {
+            for (const auto objective: {DrinkPlanner::Objective::fewestRolls, DrinkPlanner::Objective::fewestDrinks}) {
+                for (const auto target: {Ability::swimSpeedUp, Ability::subResistanceUp, Ability::intensifyAction}) {
+                    const std::string testCaseDescription = std::string{"Brand: "} + brandName + "; Seed: " + std::to_string(seed) + "; Target: " + std::string{AbilityHelper::getId(target)};
+                    const auto [expectedRollsCount, expectedDrinksCount] = findBestPlanSlowly(seedHelper, seed, target, 3, horizon, objective);
+
+                    const auto plan = DrinkPlanner::findPlan(seedHelper, seed, target, 3, horizon, objective);
+                    if (expectedRollsCount == 0) {
+                        EXPECT_FALSE(plan.has_value()) << testCaseDescription;
+                    } else {
+                        ASSERT_TRUE(plan.has_value()) << testCaseDescription;
+                        EXPECT_EQ(plan->steps.size(), expectedRollsCount) << testCaseDescription;
+                        EXPECT_EQ(plan->drinksCount, expectedDrinksCount) << testCaseDescription;
+                        verifyPlan(seedHelper, seed, target, 3, plan.value());
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+TEST(DrinkPlannerTest, AllAbilitiesLongHorizon) {
+    SeedHelper seedHelper{"Zink"};
+    constexpr uint32_t seed = 0x907b1ae9;
+
+    const auto plans = DrinkPlanner::findPlansForAllAbilities(seedHelper, seed, 3, 500, DrinkPlanner::Objective::fewestDrinks, 4);
+    ASSERT_EQ(plans.size(), AbilityHelper::abilitiesCount);
+    for (size_t i = 0; i < plans.size(); i += 1) {
+        const auto target = static_cast<Ability>(i);
+        ASSERT_TRUE(plans[i].has_value()) << AbilityHelper::getId(target);
+        verifyPlan(seedHelper, seed, target, 3, plans[i].value());
+
+        // Must match the single ability search.
+        const auto plan = DrinkPlanner::findPlan(seedHelper, seed, target, 3, 500, DrinkPlanner::Objective::fewestDrinks);
+        EXPECT_EQ(plan->steps.size(), plans[i]->steps.size());
+        EXPECT_EQ(plan->drinksCount, plans[i]->drinksCount);
+    }
+}
+
+
+TEST(DrinkPlannerTest, StreakLength1) {
+    SeedHelper seedHelper{"Zekko"};
+    const auto plan = DrinkPlanner::findPlan(seedHelper, 0x87b091, Ability::subResistanceUp, 1, 10);
+
+    // From `SeedHelperTest.FindSeedBiasedBrandsNoDrink`: The first roll is `subResistanceUp` without drink.
+    ASSERT_TRUE(plan.has_value());
+    EXPECT_EQ(plan->steps.size(), 1);
+    EXPECT_EQ(plan->drinksCount, 0);
+    EXPECT_EQ(plan->steps[0].drink, Ability::noDrink);
+}
+
+
+TEST(DrinkPlannerTest, ParetoPlans) {
+    constexpr size_t horizon = 10;
+    SeedHelper seedHelper{"Krak-On"};
+    for (const uint32_t seed: {0x1u, 0x12345678u, 0x87b091u}) {
+        for (const auto target: {Ability::swimSpeedUp, Ability::subResistanceUp, Ability::intensifyAction}) {
+            const std::string testCaseDescription = "Seed: " + std::to_string(seed) + "; Target: " + std::string{AbilityHelper::getId(target)};
+            const auto plans = DrinkPlanner::findParetoPlans(seedHelper, seed, target, 3, horizon);
+            for (size_t i = 0; i < plans.size(); i += 1) {
+                verifyPlan(seedHelper, seed, target, 3, plans[i]);
+                if (i > 0) {
+                    EXPECT_GT(plans[i].steps.size(), plans[i - 1].steps.size()) << testCaseDescription;
+                    EXPECT_LT(plans[i].drinksCount, plans[i - 1].drinksCount) << testCaseDescription;
+                }
+            }
+
+            // Within `maxRollsCount` rolls, the fewest drinks are the last plan's that fits.
+            for (size_t maxRollsCount = 1; maxRollsCount <= horizon; maxRollsCount += 1) {
+                const auto [expectedRollsCount, expectedDrinksCount] = findBestPlanSlowly(seedHelper, seed, target, 3, maxRollsCount, DrinkPlanner::Objective::fewestDrinks);
+                const auto it = std::find_if(plans.rbegin(), plans.rend(), [&](const DrinkPlanner::Plan& plan) {
+                    return plan.steps.size() <= maxRollsCount;
+                });
+                if (expectedRollsCount == 0) {
+                    EXPECT_EQ(it, plans.rend()) << testCaseDescription << "; Max rolls: " << maxRollsCount;
+                } else {
+                    ASSERT_NE(it, plans.rend()) << testCaseDescription << "; Max rolls: " << maxRollsCount;
+                    EXPECT_EQ(it->steps.size(), expectedRollsCount) << testCaseDescription << "; Max rolls: " << maxRollsCount;
+                    EXPECT_EQ(it->drinksCount, expectedDrinksCount) << testCaseDescription << "; Max rolls: " << maxRollsCount;
+                }
+            }
+
+            // Ends are the single objective plans.
+            const auto fewestRollsPlan = DrinkPlanner::findPlan(seedHelper, seed, target, 3, horizon, DrinkPlanner::Objective::fewestRolls);
+            const auto fewestDrinksPlan = DrinkPlanner::findPlan(seedHelper, seed, target, 3, horizon, DrinkPlanner::Objective::fewestDrinks);
+            ASSERT_EQ(fewestRollsPlan.has_value(), !plans.empty()) << testCaseDescription;
+            if (!plans.empty()) {
+                EXPECT_EQ(plans.front().steps.size(), fewestRollsPlan->steps.size()) << testCaseDescription;
+                EXPECT_EQ(plans.front().drinksCount, fewestRollsPlan->drinksCount) << testCaseDescription;
+                EXPECT_EQ(plans.back().steps.size(), fewestDrinksPlan->steps.size()) << testCaseDescription;
+                EXPECT_EQ(plans.back().drinksCount, fewestDrinksPlan->drinksCount) << testCaseDescription;
+            }
+        }
+    }
+}
+
+
+TEST(DrinkPlannerTest, InvalidArguments) {
+    SeedHelper seedHelper{"Zekko"};
+    EXPECT_THROW(DrinkPlanner::findPlan(seedHelper, 0x87b091, Ability::subResistanceUp, 0, 10), std::invalid_argument);
+    EXPECT_THROW(DrinkPlanner::findPlan(seedHelper, 0x87b091, Ability::subResistanceUp, 256, 10), std::invalid_argument);
+    EXPECT_THROW(DrinkPlanner::findParetoPlans(seedHelper, 0x87b091, Ability::subResistanceUp, 3, DrinkPlanner::maxHorizon + 1), std::invalid_argument);
+}
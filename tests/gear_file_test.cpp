@@ -0,0 +1,153 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "../binary/gear_file.h"
+#include "../yaml/yaml_helper.h"
+
+#include "roll_randomizer.h"
+#include "temporary_files.h"
+
+
+TEST(GearFileTest, Brands) {
+    EXPECT_EQ(GearFile::getBrand(GearFile::getBrandIndex("Amiibo")), "Amiibo");
+    EXPECT_EQ(GearFile::getBrand(GearFile::getBrandIndex("Zink")), "Zink");
+    EXPECT_EQ(GearFile::getBrandIndex("Grizzco"), 2);
+    EXPECT_EQ(GearFile::getBrandIndex("Annaki"), 3);
+    EXPECT_THROW(GearFile::getBrandIndex("Not a brand"), std::invalid_argument);
+    EXPECT_THROW(GearFile::getBrand(20), std::invalid_argument);
+}
+
+
+TEST(GearFileTest, SaveAndView) {
+    const TemporaryFile temporaryFile{"view.gear"};
+    const auto filename = temporaryFile.getFilename();
+
+    RollSequence rollSequence{};
+    rollSequence.addRoll(Ability::inkSaverMain);
+    rollSequence.addRoll(Ability::unknown, Ability::runSpeedUp);
+    auto abilities = AbilitySet{Ability::swimSpeedUp};
+    abilities.insert(Ability::quickRespawn);
+    auto drinks = AbilitySet{Ability::noDrink};
+    drinks.insert(Ability::subPowerUp);
+    rollSequence.addRoll(abilities, drinks);
+    rollSequence.addRoll(Ability::intensifyAction, AbilitySet::anyDrink());
+
+    GearFile::save(filename, "Name with \"quotes\": 名前", "Toni Kensa", 0xfedcba98, rollSequence);
+    EXPECT_EQ(std::filesystem::file_size(filename), GearFile::headerSize + GearFile::rollSize * 4 + std::string_view{"Name with \"quotes\": 名前"}.size());
+
+    {
+        const GearFileView gearFile{filename};
+        EXPECT_EQ(gearFile.getName(), "Name with \"quotes\": 名前");
+        EXPECT_EQ(gearFile.getBrand(), "Toni Kensa");
+        EXPECT_EQ(gearFile.getInitialSeed(), 0xfedcba98);
+        ASSERT_EQ(gearFile.getRollsCount(), 4);
+        EXPECT_EQ(gearFile.getRoll(2), std::make_pair(abilities, drinks));
+
+        const auto loadedRollSequence = gearFile.getRollSequence();
+        EXPECT_TRUE(std::equal(loadedRollSequence.begin(), loadedRollSequence.end(), rollSequence.begin(), rollSequence.end()));
+    }
+
+    // No initial seed, no rolls.
+    GearFile::save(filename, "", "Zekko", std::nullopt, RollSequence{});
+    {
+        const GearFileView gearFile{filename};
+        EXPECT_EQ(gearFile.getName(), "");
+        EXPECT_EQ(gearFile.getInitialSeed(), std::nullopt);
+        EXPECT_EQ(gearFile.getRollsCount(), 0);
+    }
+}
+
+
+TEST(GearFileTest, InvalidFiles) {
+    const TemporaryFile temporaryFile{"invalid.gear"};
+    const auto filename = temporaryFile.getFilename();
+    EXPECT_THROW(GearFileView{filename}, std::runtime_error);
+    EXPECT_THROW(GearFile::save(filename, "", "Not a brand", 0, RollSequence{}), std::invalid_argument);
+    EXPECT_FALSE(std::filesystem::exists(filename));
+
+    RollSequence rollSequence{};
+    rollSequence.addRoll(Ability::inkSaverMain);
+    GearFile::save(filename, "Name", "Zink", 0, rollSequence);
+    std::string contents{};
+    {
+        std::ifstream f{filename, std::ios::binary};
+        contents.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+
+    const auto writeAndCheck = [&filename](const std::string& fileContents) {
+        {
+            std::ofstream f{filename, std::ios::binary | std::ios::trunc};
+            f << fileContents;
+        }
+        EXPECT_THROW(GearFileView{filename}, std::runtime_error);
+    };
+    // Truncated.
+    writeAndCheck(contents.substr(0, 10));
+    writeAndCheck(contents.substr(0, contents.size() - 1));
+    // Wrong magic, version, brand.
+    for (const size_t offset: {0, 4, 5}) {
+        auto corruptedContents = contents;
+        corruptedContents[offset] = 100;
+        writeAndCheck(corruptedContents);
+    }
+    // Empty masks, `unknown`'s bit, and bits past `noDrink`.
+    for (const auto [abilitiesMask, drinksMask]: {std::make_pair(0, 1), std::make_pair(1 << 14, 1), std::make_pair(1, 0), std::make_pair(1, 1 << 14), std::make_pair(1, 1 << 16)}) {
+        auto corruptedContents = contents;
+        for (size_t i = 0; i < 2; i += 1) {
+            corruptedContents[GearFile::headerSize + i] = static_cast<char>(abilitiesMask >> (8 * i));
+            corruptedContents[GearFile::headerSize + 2 + i] = static_cast<char>(drinksMask >> (8 * i));
+        }
+        writeAndCheck(corruptedContents);
+    }
+}
+
+
+TEST(GearFileTest, ConvertLossless) {
+    const TemporaryFile temporaryYamlFile{"original.yaml"};
+    const auto yamlFilename = temporaryYamlFile.getFilename();
+    const TemporaryFile temporaryGearFile{"converted.gear"};
+    const auto gearFilename = temporaryGearFile.getFilename();
+    const TemporaryFile temporaryConvertedYamlFile{"converted.yaml"};
+    const auto convertedYamlFilename = temporaryConvertedYamlFile.getFilename();
+
+    const auto rolls = getRandomRollsAndDrinks(200);
+    {
+        YamlFile yamlFile{yamlFilename, "Random gear", "Krak-On", 123456789};
+        for (size_t i = 0; i < rolls.size(); i += 1) {
+            const auto [ability, drink] = rolls[i];
+            // Some uncertain rolls.
+            auto abilities = AbilitySet{ability};
+            if (i % 7 == 0) {
+                abilities.insert(Ability::unknown);
+            } else if (i % 5 == 0) {
+                abilities.insert(Ability::subPowerUp);
+            }
+            auto drinks = AbilitySet{drink};
+            if (i % 11 == 0) {
+                drinks = AbilitySet::anyDrink();
+            } else if (i % 3 == 0) {
+                drinks.insert(Ability::noDrink);
+            }
+            yamlFile.addRoll(abilities, drinks);
+        }
+    }
+
+    GearFile::convertYamlToGear(yamlFilename, gearFilename);
+    GearFile::convertGearToYaml(gearFilename, convertedYamlFilename);
+
+    YamlFile original{yamlFilename};
+    YamlFile converted{convertedYamlFilename};
+    EXPECT_EQ(converted.getName(), original.getName());
+    EXPECT_EQ(converted.getBrand(), original.getBrand());
+    EXPECT_EQ(converted.getInitialSeed(), original.getInitialSeed());
+    EXPECT_TRUE(std::equal(converted.getRollSequence().begin(), converted.getRollSequence().end(), original.getRollSequence().begin(), original.getRollSequence().end()));
+
+    // Same YAML text.
+    const auto readFile = [](const std::string& filename) {
+        std::ifstream f{filename};
+        return std::string{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+    };
+    EXPECT_EQ(readFile(convertedYamlFilename), readFile(yamlFilename));
+}
@@ -0,0 +1,358 @@
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "yaml-cpp/yaml.h"
+
+#include "../helpers/output_buffer.h"
+#include "../yaml/gear_yaml.h"
+
+#include "roll_randomizer.h"
+
+
+#pragma mark - yaml-cpp reference
+/// The original yaml-cpp based implementation, used as the reference.
+namespace Reference {
+    static AbilitySet loadAbilitySet(const YAML::Node& node) {
+        if (node.IsSequence()) {
+            AbilitySet returnValue{};
+            for (const auto& abilityNode: node) {
+                returnValue.insert(AbilityHelper::fromId(abilityNode.as<std::string>()));
+            }
+            if (returnValue.empty()) {
+                throw std::runtime_error("Empty ability list.");
+            }
+            return returnValue;
+        } else {
+            return AbilityHelper::fromId(node.as<std::string>());
+        }
+    }
+
+    static YAML::Node saveAbilitySet(const AbilitySet abilities) {
+        if (abilities.isUnknown()) {
+            return YAML::Node{std::string{AbilityHelper::placeholderId}};
+        }
+
+        const auto abilitiesVector = abilities.toVector();
+        if (abilitiesVector.size() == 1) {
+            return YAML::Node{std::string{AbilityHelper::getId(abilitiesVector[0])}};
+        }
+
+        YAML::Node returnValue{YAML::NodeType::Sequence};
+        for (const auto ability: abilitiesVector) {
+            returnValue.push_back(std::string{AbilityHelper::getId(ability)});
+        }
+        returnValue.SetStyle(YAML::EmitterStyle::Flow);
+        return returnValue;
+    }
+
+    static AbilitySet loadDrinkSet(const YAML::Node& node) {
+        if (node.IsSequence()) {
+            AbilitySet returnValue{};
+            for (const auto& drinkNode: node) {
+                const auto drinkId = drinkNode.as<std::string>();
+                if (drinkId == "none") {
+                    returnValue.insert(Ability::noDrink);
+                } else {
+                    returnValue.insert(AbilityHelper::fromId(drinkId));
+                }
+            }
+            if (returnValue.empty()) {
+                throw std::runtime_error("Empty drink list.");
+            }
+            return returnValue;
+        } else {
+            const auto drinkId = node.as<std::string>();
+            if (drinkId == "none") {
+                return Ability::noDrink;
+            }
+            const auto drink = AbilityHelper::fromId(drinkId);
+            if (drink == Ability::unknown) {
+                return AbilitySet::anyDrink();
+            }
+            return drink;
+        }
+    }
+
+    static YAML::Node saveDrinkSet(const AbilitySet drinks) {
+        if (drinks == AbilitySet::anyDrink()) {
+            return YAML::Node{std::string{AbilityHelper::placeholderId}};
+        }
+
+        const auto drinksVector = drinks.toVector();
+        if (drinksVector.size() == 1) {
+            return YAML::Node{std::string{AbilityHelper::getId(drinksVector[0])}};
+        }
+
+        YAML::Node returnValue{YAML::NodeType::Sequence};
+        for (const auto drink: drinksVector) {
+            returnValue.push_back((drink == Ability::noDrink) ? std::string{"none"} : std::string{AbilityHelper::getId(drink)});
+        }
+        returnValue.SetStyle(YAML::EmitterStyle::Flow);
+        return returnValue;
+    }
+
+    static GearYamlContents parse(const std::string& contents) {
+        GearYamlContents returnValue{};
+        auto root = YAML::Load(contents);
+
+        if (!root["name"] || !root["brand"]) {
+            throw std::runtime_error("`name` or `brand` absent.");
+        }
+        returnValue.name = root["name"].as<std::string>();
+        returnValue.brand = root["brand"].as<std::string>();
+        if (root["initial_seed"] && !root["initial_seed"].IsNull()) {
+            returnValue.initialSeed = root["initial_seed"].as<uint32_t>();
+        }
+
+        const auto& abilitiesNode = root["abilities"];
+        if (abilitiesNode) {
+            for (YAML::const_iterator it = abilitiesNode.begin(); it != abilitiesNode.end(); it ++) {
+                if (it->IsMap()) {
+                    const auto abilityNode = (*it)["ability"];
+                    if (!abilityNode) {
+                        throw std::runtime_error("No ability key in map.");
+                    }
+                    const auto ability = loadAbilitySet(abilityNode);
+
+                    const auto drinkNode = (*it)["drink"];
+                    if (drinkNode) {
+                        returnValue.rollSequence.addRoll(ability, loadDrinkSet(drinkNode));
+                    } else {
+                        returnValue.rollSequence.addRoll(ability);
+                    }
+                } else {
+                    returnValue.rollSequence.addRoll(loadAbilitySet(*it));
+                }
+            }
+        }
+
+        return returnValue;
+    }
+
+    static std::string emit(const GearYamlContents& contents) {
+        YAML::Node root{};
+        root["name"] = contents.name;
+        root["brand"] = contents.brand;
+        if (contents.initialSeed.has_value()) {
+            root["initial_seed"] = contents.initialSeed.value();
+        }
+        for (const auto [ability, drink]: contents.rollSequence) {
+            const auto abilityNode = saveAbilitySet(ability);
+            if (drink == Ability::noDrink) {
+                root["abilities"].push_back(abilityNode);
+            } else {
+                YAML::Node currentNode{};
+                currentNode["ability"] = abilityNode;
+                currentNode["drink"] = saveDrinkSet(drink);
+                root["abilities"].push_back(currentNode);
+            }
+        }
+
+        std::stringstream stream{};
+        stream << root;
+        return stream.str();
+    }
+}
+
+
+#pragma mark - Helpers
+static void expectSameContents(const GearYamlContents& lhs, const GearYamlContents& rhs, const std::string& description) {
+    EXPECT_EQ(lhs.name, rhs.name) << description;
+    EXPECT_EQ(lhs.brand, rhs.brand) << description;
+    EXPECT_EQ(lhs.initialSeed, rhs.initialSeed) << description;
+    ASSERT_EQ(lhs.rollSequence.size(), rhs.rollSequence.size()) << description;
+    for (size_t i = 0; i < lhs.rollSequence.size(); i += 1) {
+        EXPECT_EQ(lhs.rollSequence.begin()[i], rhs.rollSequence.begin()[i]) << description << " (roll " << i << ")";
+    }
+}
+
+static std::string emit(const GearYamlContents& contents) {
+    OutputBuffer output{-1};
+    GearYaml::emit(output, contents.name, contents.brand, contents.initialSeed, contents.rollSequence);
+    return std::string{output.getData()};
+}
+
+/// Random ability or drink set: Single, a list, or unknown.
+static AbilitySet getRandomSet(std::mt19937& generator, const bool isDrink) {
+    const auto kind = generator() % 4;
+    if (kind == 0) {
+        return isDrink ? AbilitySet::anyDrink() : AbilitySet{Ability::unknown};
+    } else if (kind == 1) {
+        auto mask = static_cast<AbilitySet::MaskType>(generator() & AbilitySet::allAbilitiesMask);
+        if (isDrink && (generator() % 2 == 0)) {
+            mask |= AbilitySet::noDrinkMask;
+        }
+        if (AbilitySet::fromMask(mask).size() >= 2) {
+            return AbilitySet::fromMask(mask);
+        }
+    }
+    return getRandomAbility();
+}
+
+
+#pragma mark - Tests
+TEST(GearYamlTest, TestYamlFiles) {
+    const auto directory = std::filesystem::path{__FILE__}.parent_path() / "test_yaml";
+    ASSERT_TRUE(std::filesystem::is_directory(directory));
+
+    size_t filesCount = 0;
+    for (const auto& entry: std::filesystem::directory_iterator(directory)) {
+        std::ifstream file{entry.path()};
+        std::stringstream contents{};
+        contents << file.rdbuf();
+
+        const auto expected = Reference::parse(contents.str());
+        const auto actual = GearYaml::parse(contents.str(), entry.path().string());
+        expectSameContents(actual, expected, entry.path().string());
+        filesCount += 1;
+    }
+    EXPECT_GT(filesCount, 0);
+}
+
+
+TEST(GearYamlTest, Syntax) {
+    // Both parsers should produce the same contents.
+    const std::vector<std::string> documents = {
+        // Empty abilities.
+        "name: a\nbrand: b",
+        "name: a\nbrand: b\nabilities:\ninitial_seed: 1",
+        // Comments, blank lines, and CRLF.
+        "# Comment\nname: a # Comment\n\n   \nbrand: b\t# Comment\r\n  # Indented comment\ninitial_seed: 12 #\r\n",
+        // Quoted scalars.
+        "name: 'It''s # not a comment'\nbrand: \"Tab\\x09quote\\\"backslash\\\\\"",
+        "name: ''\nbrand: \"\" # Comment",
+        // Null and missing values.
+        "name:\nbrand: ~\ninitial_seed: null",
+        "name: null\nbrand: NULL\ninitial_seed: ~",
+        "name: a\nbrand: b\ninitial_seed:",
+        // Seeds.
+        "name: a\nbrand: b\ninitial_seed: 0",
+        "name: a\nbrand: b\ninitial_seed: 4294967295",
+        "name: a\nbrand: b\ninitial_seed: '5'",
+        // Plain scalars with indicators inside.
+        "name: a:b #c d\nbrand: -b ?c [d] {e}, f#g",
+        // Unknown keys.
+        "name: a\nother: [1, {x: y}]\nbrand: c\nnotes: text",
+        // Sequences at the key's indentation, and deeper indentation.
+        "name: a\nbrand: b\nabilities:\n- ink_saver_main\n- ability: [ink_saver_sub, swim_speed_up]\n  drink: [none]\n-   ability: unknown\n    drink: unknown",
+        "name: a\nbrand: b\nabilities:\n      -   quick_respawn\n      -  [quick_respawn , sub_power_up ,]\n",
+        // `none` as a single drink, like a list of `none`.
+        "name: a\nbrand: b\nabilities:\n  - ability: ink_saver_main\n    drink: none\n  - ability: ink_saver_sub\n    drink: 'none'\n  - ability: unknown\n    drink: [none]",
+        // Extra keys in rolls.
+        "name: a\nbrand: b\nabilities:\n  - ability: intensify_action\n    next_seed: 12345\n    drink: ink_resistance_up\n  - sub_resistance_up",
+    };
+
+    for (const auto& document: documents) {
+        SCOPED_TRACE(document);
+        expectSameContents(GearYaml::parse(document, "test.yaml"), Reference::parse(document), document);
+    }
+}
+
+
+TEST(GearYamlTest, InvalidContents) {
+    // Rejected by both parsers.
+    const std::vector<std::string> invalidDocuments = {
+        "",
+        "# Comment only",
+        "brand: b",
+        "name: a",
+        "- a",
+        "plain",
+        "name: [a]\nbrand: b",
+        "name: a\nbrand: b\ninitial_seed: -1",
+        "name: a\nbrand: b\ninitial_seed: 4294967296",
+        "name: a\nbrand: b\ninitial_seed: 09",
+        "name: a\nbrand: b\ninitial_seed: ' 5'",
+        "name: a\nbrand: b\ninitial_seed: 5.0",
+        "name: a\nbrand: b\ninitial_seed: \"null\"",
+        "name: a\nbrand: b\nabilities:\n  - ink_saver",
+        "name: a\nbrand: b\nabilities:\n  - []",
+        "name: a\nbrand: b\nabilities:\n  -",
+        "name: a\nbrand: b\nabilities:\n  - drink: none",
+        "name: a\nbrand: b\nabilities:\n  - ability: ink_saver_main\n    drink: []",
+        "name: a\nbrand: b\nabilities:\n  - ability: ink_saver_main\n    drink: [ink_saver_main, nothing]",
+        "name: a\nbrand: b\nabilities:\n  - ability: none",
+        "name: a\nbrand: b\nabilities:\n  - [ink_saver_main, [ink_saver_sub]]",
+        "name: a\nbrand: b\nabilities:\n  - {ability: {a: b}}",
+        "name: a\n  brand: b",
+        "name: a: b\nbrand: c",
+    };
+    for (const auto& document: invalidDocuments) {
+        EXPECT_ANY_THROW(Reference::parse(document)) << document;
+        EXPECT_ANY_THROW(GearYaml::parse(document, "test.yaml")) << document;
+    }
+
+    // Valid YAML outside of the gear schema.
+    const std::vector<std::string> unsupportedDocuments = {
+        "---\nname: a\nbrand: b",
+        "%YAML 1.2\n---\nname: a\nbrand: b",
+        "  name: a\n  brand: b",
+        "\"name\": a\nbrand: b",
+        "name: a\nname: b\nbrand: c",
+        "name: &anchor a\nbrand: *anchor",
+        "name: !!str a\nbrand: b",
+        "name: |\n  a\nbrand: b",
+        "name: a\n  continued\nbrand: b",
+        "name: 'a\n  continued'\nbrand: b",
+        "name: \"\\u00e9\"\nbrand: b",
+        "name: a\nbrand: b\ninitial_seed: 0x1F",
+        "name: a\nbrand: b\ninitial_seed: 017",
+        "name: a\nbrand: b\ninitial_seed: +5",
+        "name: a\nbrand: b\nnotes:\n  - a",
+        "name: a\nbrand: b\nabilities: []",
+        "name: a\nbrand: b\nabilities: [ink_saver_main,\n  ink_saver_sub]",
+        "name: a\nbrand: b\nabilities:\n  - {ability: ink_saver_main}",
+        "name: a\nbrand: b\nabilities:\n  - ability:\n    - ink_saver_main\n    - ink_saver_sub",
+        "name: a\nbrand: b\nabilities:\n  - ability: ink_saver_main\n    notes:\n      - a",
+        "name: a\nbrand:\tb\n\tinitial_seed: 1",
+    };
+    for (const auto& document: unsupportedDocuments) {
+        EXPECT_THROW(GearYaml::parse(document, "test.yaml"), std::runtime_error) << document;
+    }
+
+    // Invalid IDs are reported by `AbilityHelper::fromId`.
+    EXPECT_THROW(GearYaml::parse("name: a\nbrand: b\nabilities:\n  - [ink_saver_main, ink_saver]", "test.yaml"), std::invalid_argument);
+}
+
+
+TEST(GearYamlTest, Emit) {
+    // Plain scalars, as written by yaml-cpp.
+    const std::vector<std::string> plainNames = {
+        "Crimson Parashooter", "nULL", "a:b", "a# b", "a]", "a,b", "a\"b'c\\d", "yes", "123", "0x1F", "\xC3\xA9\xE5\x90\x8D\xF0\x9F\x98\x80",
+    };
+    // Double quoted, unlike yaml-cpp in some cases.
+    const std::vector<std::string> quotedNames = {
+        "", "null", "~", "Null", "a: b", "a:", "#a", "a #b", " a", "a ", "- a", "-a", "-", "? a", ":a", "[a", "{a", "&a", "*a", "!a", "|a", ">a",
+        "'a", "\"a", "%a", "@a", "`a", "\\a", "tab\ta", "line\nbreak", "return\rb", "\b\f\x01\x1F\x7F",
+    };
+
+    std::mt19937 generator{std::random_device{}()};
+    const auto check = [&](const std::vector<std::string>& names, const bool isSameAsYamlCpp) {
+        for (size_t i = 0; i < names.size(); i += 1) {
+            GearYamlContents contents{names[i], names[names.size() - 1 - i], {}, {}};
+            if (i % 2 == 0) {
+                contents.initialSeed = static_cast<uint32_t>(generator());
+            }
+            for (size_t j = 0; j < i; j += 1) {
+                if (generator() % 3 == 0) {
+                    contents.rollSequence.addRoll(getRandomSet(generator, false));
+                } else {
+                    contents.rollSequence.addRoll(getRandomSet(generator, false), getRandomSet(generator, true));
+                }
+            }
+
+            // Both parsers read it back.
+            const auto text = emit(contents);
+            if (isSameAsYamlCpp) {
+                EXPECT_EQ(text, Reference::emit(contents)) << names[i];
+            }
+            expectSameContents(GearYaml::parse(text, "test.yaml"), contents, text);
+            expectSameContents(Reference::parse(text), contents, text);
+        }
+    };
+    check(plainNames, true);
+    check(quotedNames, false);
+}
@@ -0,0 +1,81 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "../helpers/hardware_counters.h"
+#include "../helpers/stats.h"
+#include "../seed_helper.h"
+
+
+// perf events may not be permitted here (e.g. in containers), so both outcomes are valid.
+TEST(HardwareCountersTest, StartStop) {
+    HardwareCounters counters{};
+    counters.start();
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 1'000'000; i += 1) {
+        sum = sum + i;
+    }
+    const auto counts = counters.stop();
+
+    if (counts.availableMask == 0) {
+        EXPECT_NE(counts.error, 0);
+        EXPECT_EQ(counts.values, (std::array<uint64_t, HardwareCounts::eventsCount>{}));
+        GTEST_SKIP() << "perf_event_open isn't permitted.";
+    }
+
+    if (counts.isAvailable(HardwareCounts::instructions)) {
+        EXPECT_GE(counts.values[HardwareCounts::instructions], 1'000'000);
+    }
+    if (counts.isAvailable(HardwareCounts::cycles)) {
+        EXPECT_GT(counts.values[HardwareCounts::cycles], 0);
+    }
+}
+
+
+TEST(HardwareCountersTest, SearchWorkers) {
+    constexpr size_t workersCount = 2;
+    const RollSequence rollSequence{std::vector<Ability>{Ability::inkSaverMain, Ability::runSpeedUp, Ability::swimSpeedUp}};
+    SeedHelper seedHelper{"Zink"};
+
+    SearchStats stats{};
+    stats.countHardwareEvents = true;
+    const auto results = seedHelper.findSeedInRange(rollSequence, 0, (1 << 16) - 1, workersCount, &stats);
+    EXPECT_EQ(results, seedHelper.findSeedInRange(rollSequence, 0, (1 << 16) - 1, workersCount));
+    ASSERT_EQ(stats.workerHardwareCounts.size(), workersCount);
+
+    // Not counted unless requested.
+    SearchStats statsWithoutHardwareCounts{};
+    static_cast<void>(seedHelper.findSeedInRange(rollSequence, 0, (1 << 16) - 1, workersCount, &statsWithoutHardwareCounts));
+    EXPECT_TRUE(statsWithoutHardwareCounts.workerHardwareCounts.empty());
+}
+
+
+TEST(HardwareCountersTest, Report) {
+    RunStats stats{true};
+    stats.enableHardwareCounters();
+    auto& searchStats = *stats.getSearchStats();
+    searchStats.seedsEvaluated = 100;
+
+    // Unavailable.
+    HardwareCounts unavailableCounts{};
+    unavailableCounts.error = EACCES;
+    searchStats.workerHardwareCounts = {unavailableCounts};
+    std::ostringstream unavailableStream{};
+    stats.print(unavailableStream);
+    EXPECT_NE(unavailableStream.str().find("Hardware counters: Unavailable"), std::string::npos);
+
+    // Only events counted on every worker are reported.
+    HardwareCounts counts{};
+    counts.values = {1000, 2000, 10, 20, 0};
+    counts.availableMask = 0b1111;
+    auto otherCounts = counts;
+    otherCounts.availableMask = 0b0111;
+    searchStats.workerHardwareCounts = {counts, otherCounts};
+    std::ostringstream stream{};
+    stats.print(stream);
+    const auto text = stream.str();
+    EXPECT_NE(text.find("cycles: 20.000\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("branch-misses: 0.200\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("L1-dcache-load-misses: Unavailable\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("IPC: 2.000 (workers: 2.000 2.000)\n"), std::string::npos) << text;
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "../helpers/output_buffer.h"
+
+
+/// Read a whole file.
+static std::string readFile(const std::string& filename) {
+    std::ifstream file{filename, std::ios::binary};
+    std::stringstream stream{};
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+
+TEST(OutputBufferTest, FromId) {
+    EXPECT_EQ(OutputFormatHelper::fromId("text"), OutputFormat::text);
+    EXPECT_EQ(OutputFormatHelper::fromId("json"), OutputFormat::json);
+    EXPECT_EQ(OutputFormatHelper::fromId("tsv"), OutputFormat::tsv);
+    EXPECT_EQ(OutputFormatHelper::fromId("binary"), OutputFormat::binary);
+    EXPECT_THROW(OutputFormatHelper::fromId("yaml"), std::invalid_argument);
+}
+
+
+TEST(OutputBufferTest, Render) {
+    OutputBuffer output{-1};
+    output << "a" << '\t' << size_t{0} << ' ' << uint32_t{4294967295} << ' ' << -12 << ' ';
+    output.appendHex(0x88554788) << ' ';
+    output.appendHex(0) << ' ';
+    output.appendJsonString("Quote \" backslash \\ newline \n tab \t control \x01 utf-8 \xe3\x82\xa4");
+    EXPECT_EQ(output.getData(), "a\t0 4294967295 -12 0x88554788 0x0 \"Quote \\\" backslash \\\\ newline \\n tab \\t control \\u0001 utf-8 \xe3\x82\xa4\"");
+
+    // Escape codes are only written to terminals.
+    if (!TerminalFormat::isEnabled()) {
+        OutputBuffer styledOutput{-1};
+        styledOutput << TerminalFormat::BOLD << "bold" << TerminalFormat::ENDC;
+        EXPECT_EQ(styledOutput.getData(), "bold");
+    }
+}
+
+
+TEST(OutputBufferTest, Binary) {
+    OutputBuffer output{-1};
+    output.appendBinary(uint32_t{0x01020304});
+    output.appendBinary(uint16_t{0xabcd});
+    output.appendBinary(int8_t{-1});
+    output.appendBinary(uint64_t{1});
+    EXPECT_EQ(output.getData(), std::string_view("\x04\x03\x02\x01\xcd\xab\xff\x01\x00\x00\x00\x00\x00\x00\x00", 15));
+}
+
+
+TEST(OutputBufferTest, FlushAndStreaming) {
+    const std::string filename = testing::TempDir() + "output_buffer_test.txt";
+    auto* const file = std::fopen(filename.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+
+    std::string expectedContents{};
+    {
+        // Streaming: Never holds much more than the threshold.
+        OutputBuffer output{fileno(file), 64, 32};
+        for (size_t i = 0; i < 1000; i += 1) {
+            output << i << '\n';
+            expectedContents += std::to_string(i) + "\n";
+            EXPECT_LT(output.getData().size(), 32);
+        }
+
+        output << "tail";
+        expectedContents += "tail";
+        // Destruction writes the rest.
+    }
+    std::fclose(file);
+
+    EXPECT_EQ(readFile(filename), expectedContents);
+    std::remove(filename.c_str());
+
+    // Invalid file descriptor.
+    OutputBuffer invalidOutput{-1};
+    invalidOutput << "data";
+    EXPECT_THROW(invalidOutput.flush(), std::runtime_error);
+    EXPECT_TRUE(invalidOutput.getData().empty());
+}
@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+#include "../prediction/pattern_matcher.h"
+
+#include "roll_randomizer.h"
+
+
+/// Check every pattern at every position.
+static std::vector<PatternMatcher::Match> findMatchesBruteForce(const std::vector<PatternMatcher::Pattern>& patterns, const std::vector<Ability>& rolls) {
+    std::vector<PatternMatcher::Match> returnValue{};
+    for (size_t i = 0; i < patterns.size(); i += 1) {
+        const auto& pattern = patterns[i];
+        for (size_t start = 0; start + pattern.size() <= rolls.size(); start += 1) {
+            bool matches = true;
+            for (size_t j = 0; (j < pattern.size()) && matches; j += 1) {
+                matches = pattern[j].contains(rolls[start + j]);
+            }
+            if (matches) {
+                returnValue.push_back({i, start});
+            }
+        }
+    }
+
+    return returnValue;
+}
+
+static void sortMatches(std::vector<PatternMatcher::Match>& matches) {
+    std::sort(matches.begin(), matches.end(), [](const auto& lhs, const auto& rhs) {
+        return std::make_pair(lhs.patternIndex, lhs.start) < std::make_pair(rhs.patternIndex, rhs.start);
+    });
+}
+
+
+TEST(PatternMatcherTest, ParsePattern) {
+    const auto pattern = PatternMatcher::parsePattern("ink_saver_main  ink_saver_main,run_speed_up unknown");
+    ASSERT_EQ(pattern.size(), 3);
+    EXPECT_EQ(pattern[0], AbilitySet{Ability::inkSaverMain});
+    EXPECT_EQ(pattern[1].toVector(), (std::vector<Ability>{Ability::inkSaverMain, Ability::runSpeedUp}));
+    EXPECT_TRUE(pattern[2].isUnknown());
+
+    EXPECT_THROW(PatternMatcher::parsePattern(""), std::invalid_argument);
+    EXPECT_THROW(PatternMatcher::parsePattern("ink_saver_main,"), std::invalid_argument);
+    EXPECT_THROW(PatternMatcher::parsePattern("not_an_ability"), std::invalid_argument);
+    EXPECT_THROW(PatternMatcher{{PatternMatcher::Pattern{}}}, std::invalid_argument);
+}
+
+
+TEST(PatternMatcherTest, Overlapping) {
+    // Patterns that are suffixes/prefixes of each other.
+    const std::vector<PatternMatcher::Pattern> patterns{
+        PatternMatcher::parsePattern("ink_saver_main ink_saver_main"),
+        PatternMatcher::makeStreakPattern(Ability::inkSaverMain, 3),
+        PatternMatcher::parsePattern("ink_saver_main ink_saver_main run_speed_up"),
+        PatternMatcher::parsePattern("ink_saver_main"),
+    };
+    const PatternMatcher matcher{patterns};
+
+    const std::vector<Ability> rolls{Ability::inkSaverMain, Ability::inkSaverMain, Ability::inkSaverMain, Ability::runSpeedUp};
+    auto matches = matcher.findMatches(rolls);
+    sortMatches(matches);
+    const std::vector<PatternMatcher::Match> expectedMatches{{0, 0}, {0, 1}, {1, 0}, {2, 1}, {3, 0}, {3, 1}, {3, 2}};
+    EXPECT_EQ(matches, expectedMatches);
+}
+
+
+TEST(PatternMatcherTest, RandomPatterns) {
+    for (size_t i = 0; i < 200; i += 1) {
+        std::vector<PatternMatcher::Pattern> patterns{};
+        for (size_t j = 0; j < 1 + i % 20; j += 1) {
+            // Short patterns over few abilities, so that there are matches.
+            PatternMatcher::Pattern pattern{};
+            for (size_t k = 0; k < 1 + (i + j) % 4; k += 1) {
+                AbilitySet abilities{static_cast<Ability>(AbilityHelper::getIndex(getRandomAbility()) % 3)};
+                if (getRandomAbility() == Ability::inkSaverMain) {
+                    abilities.insert(getRandomAbility());
+                }
+                pattern.push_back(abilities);
+            }
+            patterns.push_back(pattern);
+        }
+        const PatternMatcher matcher{patterns};
+
+        auto rolls = getRandomRolls(500);
+        for (auto& roll: rolls) {
+            roll = static_cast<Ability>(AbilityHelper::getIndex(roll) % 4);
+        }
+
+        auto matches = matcher.findMatches(rolls);
+        sortMatches(matches);
+        EXPECT_EQ(matches, findMatchesBruteForce(patterns, rolls)) << "Iteration: " << i;
+    }
+}
+
+
+TEST(PatternMatcherTest, ScanRolls) {
+    constexpr size_t length = 5000;
+    constexpr uint32_t seed = 0x1234567;
+    SeedHelper seedHelper{"Zink"};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+    std::vector<PatternMatcher::Pattern> patterns{};
+    for (size_t i = 0; i < AbilityHelper::abilitiesCount; i += 1) {
+        patterns.push_back(PatternMatcher::makeStreakPattern(static_cast<Ability>(i), 3));
+    }
+    patterns.push_back(PatternMatcher::parsePattern("run_speed_up,swim_speed_up run_speed_up,swim_speed_up run_speed_up,swim_speed_up"));
+    patterns.push_back(PatternMatcher::parsePattern("unknown ink_saver_main unknown"));
+    const PatternMatcher matcher{patterns};
+
+    for (const auto drink: {Ability::noDrink, Ability::runSpeedUp, Ability::intensifyAction}) {
+        const auto rolls = (drink == Ability::noDrink) ? seedHelper.generateRolls(seed, length) : seedHelper.generateRollsWithDrink(seed, drink, length);
+
+        std::vector<PatternMatcher::Match> matches{};
+        matcher.scanRolls(seedHelper, seed, drink, length, [&matches](const PatternMatcher::Match& match) {
+            matches.push_back(match);
+        });
+        EXPECT_EQ(matches, matcher.findMatches(rolls));
+
+        sortMatches(matches);
+        EXPECT_EQ(matches, findMatchesBruteForce(patterns, rolls));
+    }
+}
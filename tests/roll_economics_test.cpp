@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+
+#include "../prediction/roll_economics.h"
+
+
+namespace {
+    /// Brute force `RollEconomics::sweep` over the seeds at cycle positions [0, positionsCount).
+    RollEconomics::Histogram getExpectedHistogram(const SeedHelper& seedHelper, const Ability target, const Ability drink, const size_t streakLength, const size_t horizon, const uint64_t positionsCount) {
+        RollEconomics::Histogram returnValue{streakLength, horizon};
+        uint32_t seed = 1;
+        for (uint64_t i = 0; i < positionsCount; i += 1) {
+            const auto rollsNeeded = RollEconomics::getRollsNeeded(seedHelper, seed, target, drink, streakLength, horizon);
+            if (rollsNeeded > horizon) {
+                returnValue.overflowCount += 1;
+            } else {
+                returnValue.counts[rollsNeeded] += 1;
+            }
+            seed = SeedHelper::advanceSeed(seed);
+        }
+        return returnValue;
+    }
+}
+
+
+TEST(RollEconomicsTest, Histogram) {
+    RollEconomics::Histogram histogram{3, 10};
+    histogram.counts[3] = 2;
+    histogram.counts[5] = 1;
+    histogram.overflowCount = 1;
+
+    EXPECT_EQ(histogram.getTotalCount(), 4);
+    EXPECT_DOUBLE_EQ(histogram.getMean(), (3 + 3 + 5 + 11) / 4.0);
+    EXPECT_EQ(histogram.getQuantile(0.5), 3);
+    EXPECT_EQ(histogram.getQuantile(0.75), 5);
+    EXPECT_FALSE(histogram.getQuantile(0.9).has_value());
+
+    histogram += histogram;
+    EXPECT_EQ(histogram.counts[3], 4);
+    EXPECT_EQ(histogram.overflowCount, 2);
+    EXPECT_THROW(histogram += RollEconomics::Histogram(2, 10), std::invalid_argument);
+}
+
+
+TEST(RollEconomicsTest, GetRollsNeeded) {
+    SeedHelper seedHelper{"Zink"};
+    constexpr uint32_t seed = 0x12345678;
+    const auto rolls = seedHelper.generateRolls(seed, 10);
+
+    // The 1st roll is a streak of 1.
+    EXPECT_EQ(RollEconomics::getRollsNeeded(seedHelper, seed, rolls[0], Ability::noDrink, 1, 10), 1);
+    // No streak within 0 rolls.
+    EXPECT_EQ(RollEconomics::getRollsNeeded(seedHelper, seed, rolls[0], Ability::noDrink, 1, 0), 1);
+}
+
+
+TEST(RollEconomicsTest, SweepNoDrink) {
+    SeedHelper seedHelper{"Amiibo"};
+    constexpr uint64_t positionsCount = 3000;
+
+    for (const auto [streakLength, horizon]: {std::make_pair(2, 300), std::make_pair(3, 2000)}) {
+        for (const auto workersCount: {0, 3}) {
+            const auto histograms = RollEconomics::sweepNoDrink(seedHelper, streakLength, horizon, workersCount, positionsCount);
+            for (size_t i = 0; i < AbilityHelper::abilitiesCount; i += 1) {
+                const auto target = static_cast<Ability>(i);
+                const auto expectedHistogram = getExpectedHistogram(seedHelper, target, Ability::noDrink, streakLength, horizon, positionsCount);
+                EXPECT_EQ(histograms[i].counts, expectedHistogram.counts) << AbilityHelper::getId(target) << ", streak length " << streakLength;
+                EXPECT_EQ(histograms[i].overflowCount, expectedHistogram.overflowCount) << AbilityHelper::getId(target) << ", streak length " << streakLength;
+                EXPECT_EQ(histograms[i].getTotalCount(), positionsCount);
+            }
+        }
+    }
+}
+
+
+TEST(RollEconomicsTest, SweepWithDrink) {
+    SeedHelper seedHelper{"Toni Kensa"};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    constexpr uint64_t positionsCount = 20'000;
+
+    for (const auto [target, drink]: {std::make_pair(Ability::runSpeedUp, Ability::runSpeedUp), std::make_pair(Ability::inkSaverMain, Ability::runSpeedUp), std::make_pair(Ability::quickRespawn, Ability::noDrink)}) {
+        for (const auto [streakLength, horizon]: {std::make_pair(2, 20), std::make_pair(3, 400)}) {
+            const auto expectedHistogram = getExpectedHistogram(seedHelper, target, drink, streakLength, horizon, positionsCount);
+            for (const auto workersCount: {0, 3}) {
+                const auto histogram = RollEconomics::sweep(seedHelper, target, drink, streakLength, horizon, workersCount, positionsCount);
+                EXPECT_EQ(histogram.counts, expectedHistogram.counts) << AbilityHelper::getId(target) << ", streak length " << streakLength;
+                EXPECT_EQ(histogram.overflowCount, expectedHistogram.overflowCount) << AbilityHelper::getId(target) << ", streak length " << streakLength;
+            }
+        }
+    }
+}
+
+
+TEST(RollEconomicsTest, Sample) {
+    SeedHelper seedHelper{"Toni Kensa"};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    constexpr uint64_t samplesCount = 20'000;
+
+    const auto histogram = RollEconomics::sample(seedHelper, Ability::runSpeedUp, Ability::runSpeedUp, samplesCount, 42, 3, 1000);
+    EXPECT_EQ(histogram.getTotalCount(), samplesCount);
+
+    // Same samples for any workers count.
+    const auto parallelHistogram = RollEconomics::sample(seedHelper, Ability::runSpeedUp, Ability::runSpeedUp, samplesCount, 42, 3, 1000, 3);
+    EXPECT_EQ(parallelHistogram.counts, histogram.counts);
+
+    // Close to the exhaustive distribution (over a slice of the cycle).
+    const auto sweptHistogram = RollEconomics::sweep(seedHelper, Ability::runSpeedUp, Ability::runSpeedUp, 3, 1000, 0, 1 << 20);
+    EXPECT_NEAR(histogram.getMean(), sweptHistogram.getMean(), 0.05 * sweptHistogram.getMean());
+}
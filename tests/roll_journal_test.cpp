@@ -0,0 +1,195 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "../binary/roll_journal.h"
+#include "../yaml/yaml_helper.h"
+
+#include "roll_randomizer.h"
+#include "temporary_files.h"
+
+
+TEST(RollJournalTest, AppendAndReload) {
+    const TemporaryFile temporaryFile{"append.journal"};
+    const auto filename = temporaryFile.getFilename();
+    RollJournal::create(filename, "Journal gear", "Zink", std::nullopt);
+    EXPECT_THROW(RollJournal::create(filename, "Journal gear", "Zink", std::nullopt), std::runtime_error);
+
+    auto drinks = AbilitySet{Ability::noDrink};
+    drinks.insert(Ability::inkSaverSub);
+    {
+        RollJournal journal{filename};
+        EXPECT_EQ(journal.getName(), "Journal gear");
+        EXPECT_EQ(journal.getBrand(), "Zink");
+        EXPECT_FALSE(journal.getInitialSeed().has_value());
+        EXPECT_TRUE(journal.getRollSequence().empty());
+
+        journal.addRoll(Ability::inkSaverMain);
+        journal.addRoll(Ability::unknown, drinks);
+        journal.setInitialSeed(1234);
+    }
+    {
+        RollJournal journal{filename};
+        EXPECT_EQ(journal.getInitialSeed(), 1234);
+        ASSERT_EQ(journal.getRollSequence().size(), 2);
+        EXPECT_EQ(journal.getRollSequence().begin()->first, AbilitySet{Ability::inkSaverMain});
+        EXPECT_EQ((journal.getRollSequence().begin() + 1)->second, drinks);
+        EXPECT_FALSE(journal.getLastCheckpoint().has_value());
+
+        // Only new rolls are written.
+        const auto sizeBefore = std::filesystem::file_size(filename);
+        journal.addRoll(Ability::runSpeedUp);
+        EXPECT_EQ(std::filesystem::file_size(filename), sizeBefore + RollJournal::recordSize);
+    }
+}
+
+
+TEST(RollJournalTest, Checkpoints) {
+    const TemporaryFile temporaryFile{"checkpoints.journal"};
+    const auto filename = temporaryFile.getFilename();
+
+    // Test case from `SeedHelperTest`.
+    const std::vector<Ability> rolls{Ability::quickSuperJump, Ability::quickSuperJump, Ability::quickSuperJump, Ability::specialPowerUp, Ability::swimSpeedUp, Ability::specialSaver, Ability::quickSuperJump, Ability::inkSaverMain, Ability::quickSuperJump, Ability::inkRecoveryUp};
+    constexpr uint32_t initialSeed = 0x907b1ae9;
+    constexpr uint32_t finalSeed = 0x6aeddb71;
+
+    RollJournal::create(filename, "Zink gear", "Zink", initialSeed);
+    SeedHelper seedHelper{"Zink"};
+    {
+        RollJournal journal{filename};
+        for (size_t i = 0; i < 6; i += 1) {
+            journal.addRoll(rolls[i], Ability::quickSuperJump);
+        }
+
+        // Below the interval: No checkpoint.
+        const auto [valid, seed] = journal.advanceToEnd(seedHelper, 8);
+        EXPECT_TRUE(valid);
+        EXPECT_FALSE(journal.getLastCheckpoint().has_value());
+
+        // Checkpoint after 6 rolls.
+        EXPECT_EQ(journal.advanceToEnd(seedHelper, 6), std::make_pair(true, seed));
+        ASSERT_TRUE(journal.getLastCheckpoint().has_value());
+        EXPECT_EQ(journal.getLastCheckpoint()->rollsCount, 6);
+        EXPECT_EQ(journal.getLastCheckpoint()->seed, seed);
+
+        for (size_t i = 6; i < rolls.size(); i += 1) {
+            journal.addRoll(rolls[i], Ability::quickSuperJump);
+        }
+    }
+    {
+        // Read-only: Replays without recording a checkpoint, and can't append.
+        const auto fileSize = std::filesystem::file_size(filename);
+        RollJournal journal{filename, RollJournal::OpenMode::readOnly};
+        EXPECT_EQ(journal.getRollSequence().size(), rolls.size());
+        EXPECT_EQ(journal.advanceToEnd(seedHelper, 0), std::make_pair(true, finalSeed));
+        EXPECT_EQ(journal.getLastCheckpoint()->rollsCount, 6);
+        EXPECT_THROW(journal.addRoll(Ability::quickSuperJump), std::runtime_error);
+        EXPECT_EQ(std::filesystem::file_size(filename), fileSize);
+    }
+    {
+        RollJournal journal{filename};
+        ASSERT_TRUE(journal.getLastCheckpoint().has_value());
+        EXPECT_EQ(journal.getLastCheckpoint()->rollsCount, 6);
+        EXPECT_EQ(journal.advanceToEnd(seedHelper, 0), std::make_pair(true, finalSeed));
+        EXPECT_EQ(journal.getLastCheckpoint()->rollsCount, rolls.size());
+
+        // Replays start from the checkpoint: A wrong checkpoint seed changes the result.
+        journal.addCheckpoint(rolls.size(), 42);
+        EXPECT_EQ(journal.advanceToEnd(seedHelper).second, 42);
+
+        // A new initial seed invalidates checkpoints.
+        journal.setInitialSeed(initialSeed);
+        EXPECT_FALSE(journal.getLastCheckpoint().has_value());
+        EXPECT_EQ(journal.advanceToEnd(seedHelper), std::make_pair(true, finalSeed));
+
+        EXPECT_THROW(journal.addCheckpoint(rolls.size() + 1, 0), std::invalid_argument);
+    }
+}
+
+
+TEST(RollJournalTest, TornRecord) {
+    const TemporaryFile temporaryFile{"torn.journal"};
+    const auto filename = temporaryFile.getFilename();
+    RollJournal::create(filename, "Torn", "Forge", 1);
+    {
+        RollJournal journal{filename};
+        journal.addRoll(Ability::subPowerUp);
+    }
+    const auto validSize = std::filesystem::file_size(filename);
+
+    // Crash in the middle of appending a record.
+    for (const size_t tornSize: {5, static_cast<int>(RollJournal::recordSize)}) {
+        {
+            std::ofstream f{filename, std::ios::binary | std::ios::app};
+            f << std::string(tornSize, 'R');
+        }
+
+        RollJournal journal{filename};
+        EXPECT_EQ(journal.getRollSequence().size(), 1);
+
+        // The torn record is replaced.
+        journal.addRoll(Ability::subResistanceUp);
+        EXPECT_EQ(std::filesystem::file_size(filename), validSize + RollJournal::recordSize);
+
+        RollJournal reloadedJournal{filename};
+        ASSERT_EQ(reloadedJournal.getRollSequence().size(), 2);
+        EXPECT_EQ((reloadedJournal.getRollSequence().begin() + 1)->first, AbilitySet{Ability::subResistanceUp});
+
+        // Reset.
+        std::filesystem::resize_file(filename, validSize);
+    }
+
+    // Corruption before the last record.
+    {
+        RollJournal journal{filename};
+        journal.addRoll(Ability::subResistanceUp);
+    }
+    {
+        std::fstream f{filename, std::ios::binary | std::ios::in | std::ios::out};
+        f.seekp(static_cast<std::streamoff>(validSize - RollJournal::recordSize + 4));
+        f << 'x';
+    }
+    EXPECT_THROW(RollJournal{filename}, std::runtime_error);
+
+    // Roll records with valid checksums, but masks that aren't ability or drink sets.
+    for (const auto [abilitiesMask, drinksMask]: {std::make_pair(0, 1), std::make_pair(1 << 14, 1), std::make_pair(1, 0), std::make_pair(1, 1 << 14)}) {
+        std::filesystem::remove(filename);
+        RollJournal::create(filename, "Invalid masks", "Forge", 1);
+        {
+            RollJournal journal{filename};
+            journal.addRoll(AbilitySet::fromMask(abilitiesMask), AbilitySet::fromMask(drinksMask));
+        }
+        EXPECT_THROW(RollJournal{filename}, std::runtime_error) << abilitiesMask << " " << drinksMask;
+    }
+}
+
+
+TEST(RollJournalTest, ConvertLossless) {
+    const TemporaryFile temporaryYamlFile{"original.yaml"};
+    const auto yamlFilename = temporaryYamlFile.getFilename();
+    const TemporaryFile temporaryJournalFile{"converted.journal"};
+    const auto journalFilename = temporaryJournalFile.getFilename();
+    const TemporaryFile temporaryConvertedYamlFile{"converted.yaml"};
+    const auto convertedYamlFilename = temporaryConvertedYamlFile.getFilename();
+
+    {
+        YamlFile yamlFile{yamlFilename, "Random gear", "Skalop", 987654321};
+        for (const auto [ability, drink]: getRandomRollsAndDrinks(100)) {
+            auto drinks = AbilitySet{drink};
+            if (ability == Ability::inkSaverSub) {
+                drinks = AbilitySet::anyDrink();
+            }
+            yamlFile.addRoll(ability, drinks);
+        }
+    }
+
+    RollJournal::convertYamlToJournal(yamlFilename, journalFilename);
+    RollJournal::convertJournalToYaml(journalFilename, convertedYamlFilename);
+
+    const auto readFile = [](const std::string& filename) {
+        std::ifstream f{filename};
+        return std::string{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+    };
+    EXPECT_EQ(readFile(convertedYamlFilename), readFile(yamlFilename));
+}
@@ -35,3 +35,38 @@ RollSequence::DataType getRandomRollsAndDrinks(size_t length) {
 
     return returnValue;
 }
+
+
+#pragma mark RollRandomizer
+size_t RollRandomizer::getIndex(const size_t count) {
+    return generator() % count;
+}
+
+uint32_t RollRandomizer::getSeed() {
+    return static_cast<uint32_t>(generator());
+}
+
+Ability RollRandomizer::getAbility() {
+    return static_cast<Ability>(getIndex(AbilityHelper::abilitiesCount));
+}
+
+std::vector<Ability> RollRandomizer::getRolls(const size_t length) {
+    std::vector<Ability> returnValue(length, Ability::unknown);
+    for (size_t i = 0; i < length; i += 1) {
+        returnValue[i] = getAbility();
+    }
+
+    return returnValue;
+}
+
+std::vector<Ability> RollRandomizer::getDrinks(const size_t length, const double drinkRatio) {
+    std::vector<Ability> returnValue(length, Ability::noDrink);
+    for (size_t i = 0; i < length; i += 1) {
+        // 2^-32 resolution.
+        if (static_cast<double>(generator()) < drinkRatio * 4294967296.0) {
+            returnValue[i] = getAbility();
+        }
+    }
+
+    return returnValue;
+}
@@ -26,4 +26,32 @@ std::vector<Ability> getRandomRolls(size_t length);
 RollSequence::DataType getRandomRollsAndDrinks(size_t length);
 
 
+/**
+ * Deterministic version of the functions above (e.g. for benchmark workloads): The same seed always produces the same results.
+ *
+ * Only uses `std::mt19937`'s raw output (distributions are implementation-defined), so results are the same on every platform.
+ */
+class RollRandomizer {
+private:
+    std::mt19937 generator;
+
+    /// In [0, count).
+    size_t getIndex(size_t count);
+
+public:
+    explicit RollRandomizer(uint32_t seed): generator{seed} {}
+
+    uint32_t getSeed();
+
+    /// Not placeholder/noDrink.
+    Ability getAbility();
+
+    /// Not placeholder/noDrink.
+    std::vector<Ability> getRolls(size_t length);
+
+    /// Each drink is a random ability with probability `drinkRatio`, and `noDrink` otherwise.
+    std::vector<Ability> getDrinks(size_t length, double drinkRatio);
+};
+
+
 #endif //SPLATOON_3_GEAR_HELPER_CPP_ROLL_RANDOMIZER_H
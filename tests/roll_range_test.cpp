@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../roll_range.h"
+
+
+#pragma mark - Allocation counter
+/// Heap allocations made by this test executable.
+static std::atomic<size_t> allocationsCount{0};
+
+void* operator new(size_t size) {
+    allocationsCount += 1;
+    if (void* pointer = std::malloc(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+
+#pragma mark - Tests
+TEST(RollRangeTest, MatchesGenerateRolls) {
+    constexpr size_t length = 1000;
+    constexpr uint32_t seed = 0x5a5a5a5a;
+    SeedHelper seedHelper{"Forge"};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        const auto expectedRolls = (drink == Ability::noDrink) ? seedHelper.generateRolls(seed, length) : seedHelper.generateRollsWithDrink(seed, drink, length);
+
+        const RollRange range{seedHelper, seed, drink, length};
+        EXPECT_EQ(std::distance(range.begin(), range.end()), length);
+
+        // Seeds chain: Each roll's seed generates the next roll.
+        size_t j = 0;
+        uint32_t previousSeed = seed;
+        for (const auto& roll: range) {
+            ASSERT_LT(j, length);
+            EXPECT_EQ(roll.ability, expectedRolls[j]);
+
+            const auto expectedRoll = (drink == Ability::noDrink) ? seedHelper.generateRoll(previousSeed) : seedHelper.generateRollWithDrink(previousSeed, drink);
+            EXPECT_EQ(roll.seed, expectedRoll.first);
+
+            previousSeed = roll.seed;
+            j += 1;
+        }
+        EXPECT_EQ(j, length);
+    }
+}
+
+
+TEST(RollRangeTest, TakeAndEarlyTermination) {
+    constexpr uint32_t seed = 0x13572468;
+    const SeedHelper seedHelper{"Splash Mob"};
+    const auto expectedRolls = seedHelper.generateRolls(seed, 100);
+
+    // Unbounded range, then `take`.
+    const RollRange range{seedHelper, seed};
+    EXPECT_EQ(range.take(0).begin(), range.take(0).end());
+    EXPECT_EQ(range.take(100).take(1000).size(), 100);
+    EXPECT_EQ(std::count_if(range.take(100).begin(), range.take(100).end(), [](const auto& roll) {
+        return roll.ability == Ability::inkSaverMain;
+    }), std::count(expectedRolls.begin(), expectedRolls.end(), Ability::inkSaverMain));
+
+    // Stop at the first match.
+    const auto target = expectedRolls[57];
+    const auto firstMatch = std::find_if(range.begin(), range.end(), [target](const auto& roll) {
+        return roll.ability == target;
+    });
+    EXPECT_EQ(firstMatch->ability, target);
+    EXPECT_EQ(std::distance(range.begin(), firstMatch), std::find(expectedRolls.begin(), expectedRolls.end(), target) - expectedRolls.begin());
+
+    // Each `begin` restarts.
+    EXPECT_EQ(range.begin()->ability, expectedRolls[0]);
+    EXPECT_EQ(range.begin()->ability, expectedRolls[0]);
+}
+
+
+TEST(RollRangeTest, NoAllocation) {
+    const SeedHelper seedHelper{"Rockenberg"};
+
+    const auto allocationsCountBefore = allocationsCount.load();
+    size_t count = 0;
+    for (const auto& roll: RollRange{seedHelper, 0xabcdef, Ability::noDrink, 100000}) {
+        count += (roll.ability == Ability::runSpeedUp);
+    }
+    const auto allocationsCountAfter = allocationsCount.load();
+
+    EXPECT_GT(count, 0);
+    EXPECT_EQ(allocationsCountAfter, allocationsCountBefore);
+}
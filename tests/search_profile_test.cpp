@@ -0,0 +1,176 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "../search_profile.h"
+#include "../helpers/parallel.h"
+
+
+namespace {
+    std::string getTemporaryFilename(const std::string_view name) {
+        return (std::filesystem::temp_directory_path() / "search_profile_test" / name).string();
+    }
+
+    void writeFile(const std::string& filename, const std::string_view contents) {
+        std::filesystem::create_directories(std::filesystem::path{filename}.parent_path());
+        std::ofstream file{filename, std::ios::trunc};
+        file << contents;
+    }
+
+    size_t getHardwareConcurrency() {
+        return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+}
+
+
+#pragma mark Chunks
+TEST(SearchProfileTest, MapChunks) {
+    for (const auto [count, workersCount, chunksCount]: {std::make_tuple(1000, 0, 10), std::make_tuple(1000, 3, 2), std::make_tuple(1000, 3, 64), std::make_tuple(5, 2, 8)}) {
+        const auto results = Parallel::mapChunks(count, workersCount, chunksCount, [](const size_t start, const size_t stop) {
+            return std::make_pair(start, stop);
+        });
+
+        // Contiguous, in order, covering [0, count).
+        ASSERT_FALSE(results.empty());
+        EXPECT_EQ(results.front().first, 0);
+        EXPECT_EQ(results.back().second, count);
+        for (size_t i = 1; i < results.size(); i += 1) {
+            EXPECT_EQ(results[i].first, results[i - 1].second);
+        }
+        if (chunksCount > workersCount && workersCount > 0) {
+            EXPECT_EQ(results.size(), chunksCount);
+        }
+    }
+
+    // `bool` results, which `std::vector<bool>` would pack into shared words.
+    const auto results = Parallel::mapChunks(1000, 4, 256, [](const size_t start, const size_t) {
+        return (start % 2) == 0;
+    });
+    ASSERT_EQ(results.size(), 256);
+    for (size_t chunk = 0; chunk < results.size(); chunk += 1) {
+        EXPECT_EQ(results[chunk], ((1000 * chunk / 256) % 2) == 0) << chunk;
+    }
+
+    std::vector<std::atomic<size_t>> callsCounts(1000);
+    Parallel::forEachChunk(callsCounts.size(), 3, 64, [&](const size_t start, const size_t stop) {
+        for (auto i = start; i < stop; i += 1) {
+            callsCounts[i] += 1;
+        }
+    });
+    for (const auto& callsCount: callsCounts) {
+        EXPECT_EQ(callsCount, 1);
+    }
+}
+
+
+TEST(SearchProfileTest, ChunkedSearch) {
+    const RollSequence rollSequence{std::vector<Ability>{Ability::inkSaverMain, Ability::runSpeedUp}};
+    SeedHelper seedHelper{"Zink"};
+    const auto expectedResults = seedHelper.findSeedInRange(rollSequence, 1000, 300'000);
+
+    for (const auto& configuration: {SearchConfiguration{3, 1}, SearchConfiguration{3, 16}, SearchConfiguration{2, 64}}) {
+        SearchStats stats{};
+        EXPECT_EQ(seedHelper.findSeedInRange(rollSequence, 1000, 300'000, configuration, &stats), expectedResults);
+        EXPECT_EQ(stats.seedsEvaluated, 299'001);
+        EXPECT_EQ(stats.workerTimings.size(), configuration.workersCount * configuration.chunksPerWorker);
+    }
+}
+
+
+#pragma mark Shapes
+TEST(SearchProfileTest, GetShape) {
+    RollSequence rollSequence{std::vector<Ability>{Ability::inkSaverMain}};
+    EXPECT_EQ(SearchProfile::getShape(rollSequence), SearchProfile::Shape::noDrinks);
+    EXPECT_EQ(SearchProfile::getShape(RollSequence{}), SearchProfile::Shape::noDrinks);
+
+    rollSequence.addRoll(Ability::runSpeedUp, Ability::runSpeedUp);
+    EXPECT_EQ(SearchProfile::getShape(rollSequence), SearchProfile::Shape::drinks);
+
+    rollSequence.addRoll(Ability::unknown, AbilitySet::anyDrink());
+    EXPECT_EQ(SearchProfile::getShape(rollSequence), SearchProfile::Shape::uncertainDrinks);
+}
+
+
+#pragma mark File
+TEST(SearchProfileTest, SaveLoad) {
+    const auto filename = getTemporaryFilename("nested/profile.txt");
+    std::filesystem::remove_all(std::filesystem::path{filename}.parent_path());
+    EXPECT_FALSE(SearchProfile::load(filename).has_value());
+
+    const SearchProfile::Profile profile{getHardwareConcurrency(), {SearchConfiguration{1, 1}, SearchConfiguration{4, 16}, SearchConfiguration{8, 64}}};
+    SearchProfile::save(profile, filename);
+    const auto loadedProfile = SearchProfile::load(filename);
+    ASSERT_TRUE(loadedProfile.has_value());
+    EXPECT_EQ(loadedProfile->hardwareConcurrency, profile.hardwareConcurrency);
+    for (size_t i = 0; i < SearchProfile::shapesCount; i += 1) {
+        EXPECT_EQ(loadedProfile->configurations[i].workersCount, profile.configurations[i].workersCount);
+        EXPECT_EQ(loadedProfile->configurations[i].chunksPerWorker, profile.configurations[i].chunksPerWorker);
+    }
+
+    std::filesystem::remove_all(std::filesystem::path{filename}.parent_path());
+}
+
+
+TEST(SearchProfileTest, GetConfiguration) {
+    const RollSequence rollSequence{std::vector<Ability>{Ability::inkSaverMain}};
+
+    // No profile: All hardware threads, 1 range each.
+    auto configuration = SearchProfile::getConfiguration(std::nullopt, rollSequence);
+    EXPECT_EQ(configuration.workersCount, getHardwareConcurrency());
+    EXPECT_EQ(configuration.chunksPerWorker, 1);
+
+    SearchProfile::Profile profile{getHardwareConcurrency(), {SearchConfiguration{5, 4}, SearchConfiguration{6, 4}, SearchConfiguration{7, 4}}};
+    configuration = SearchProfile::getConfiguration(profile, rollSequence);
+    EXPECT_EQ(configuration.workersCount, 5);
+    EXPECT_EQ(configuration.chunksPerWorker, 4);
+
+    // Tuned on another host.
+    profile.hardwareConcurrency += 1;
+    configuration = SearchProfile::getConfiguration(profile, rollSequence);
+    EXPECT_EQ(configuration.workersCount, getHardwareConcurrency());
+}
+
+
+TEST(SearchProfileTest, InvalidFiles) {
+    const auto filename = getTemporaryFilename("invalid.txt");
+    for (const auto contents: {
+        "no_drinks 1 1\ndrinks 1 1\nuncertain_drinks 1 1\n",  // Missing hardware_concurrency.
+        "hardware_concurrency 4\nno_drinks 1 1\ndrinks 1 1\n",  // Missing shape.
+        "hardware_concurrency 4\nno_drinks 1 1\ndrinks 1 1\nuncertain_drinks 1 0\n",
+        "hardware_concurrency 4\nno_drinks 1 1\ndrinks 1 1\nuncertain_drinks 1\n",
+        "hardware_concurrency 4\nno_drinks 1 1 1\ndrinks 1 1\nuncertain_drinks 1 1\n",
+        "hardware_concurrency 4\nsome_drinks 1 1\n",
+    }) {
+        writeFile(filename, contents);
+        EXPECT_THROW(static_cast<void>(SearchProfile::load(filename)), std::runtime_error) << contents;
+    }
+
+    // Comments and blank lines.
+    writeFile(filename, "# Comment\n\nhardware_concurrency 4  # Trailing comment\nno_drinks 1 1\ndrinks 2 4\nuncertain_drinks 3 16\n");
+    const auto profile = SearchProfile::load(filename);
+    ASSERT_TRUE(profile.has_value());
+    EXPECT_EQ(profile->configurations[2].chunksPerWorker, 16);
+
+    std::filesystem::remove_all(std::filesystem::path{filename}.parent_path());
+}
+
+
+#pragma mark Autotune
+TEST(SearchProfileTest, Autotune) {
+    std::ostringstream log{};
+    const auto profile = SearchProfile::autotune(log, 1 << 12);
+
+    EXPECT_EQ(profile.hardwareConcurrency, getHardwareConcurrency());
+    for (const auto& configuration: profile.configurations) {
+        EXPECT_GE(configuration.workersCount, 1);
+        EXPECT_LE(configuration.workersCount, 2 * getHardwareConcurrency());
+        EXPECT_GE(configuration.chunksPerWorker, 1);
+    }
+    for (const auto shapeId: SearchProfile::shapeIds) {
+        EXPECT_NE(log.str().find(shapeId), std::string::npos);
+    }
+}
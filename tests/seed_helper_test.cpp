@@ -28,6 +28,50 @@ TEST(SeedHelperTest, AdvanceSeed) {
 }
 
 
+#pragma mark Cycle position
+TEST(SeedHelperTest, CyclePosition) {
+    EXPECT_EQ(SeedHelper::cyclePosition(1), 0);
+    EXPECT_EQ(SeedHelper::seedAtPosition(0), 1);
+    EXPECT_EQ(SeedHelper::seedAtPosition(SeedHelper::cycleLength), 1);
+    EXPECT_THROW(static_cast<void>(SeedHelper::cyclePosition(0)), std::invalid_argument);
+
+    // From `AdvanceSeed`'s test cases.
+    EXPECT_EQ(SeedHelper::cyclePosition(0x42021), 1);
+    EXPECT_EQ(SeedHelper::cyclePosition(0x2c6f5bd0), 6);
+
+    // Seed 1 advanced `steps` times, including the end of the cycle.
+    uint32_t seed = 1;
+    for (uint32_t position = 0; position < 1000; position += 1) {
+        ASSERT_EQ(SeedHelper::cyclePosition(seed), position);
+        ASSERT_EQ(SeedHelper::seedAtPosition(position), seed);
+        seed = SeedHelper::advanceSeed(seed);
+    }
+    const auto lastSeed = SeedHelper::seedAtPosition(SeedHelper::cycleLength - 1);
+    EXPECT_EQ(SeedHelper::advanceSeed(lastSeed), 1);
+    EXPECT_EQ(SeedHelper::cyclePosition(lastSeed), SeedHelper::cycleLength - 1);
+
+    // Round trips.
+    for (uint32_t initialSeed = 0x12345678; initialSeed < 0x12345678 + 2000; initialSeed += 1) {
+        ASSERT_EQ(SeedHelper::seedAtPosition(SeedHelper::cyclePosition(initialSeed)), initialSeed);
+    }
+}
+
+
+TEST(SeedHelperTest, StepsBetween) {
+    constexpr uint32_t initialSeed = 0xb0980324;
+    uint32_t seed = initialSeed;
+    for (uint32_t steps = 0; steps < 100; steps += 1) {
+        EXPECT_EQ(SeedHelper::stepsBetween(initialSeed, seed), steps);
+        if (steps > 0) {
+            // Backwards: The rest of the cycle.
+            EXPECT_EQ(SeedHelper::stepsBetween(seed, initialSeed), SeedHelper::cycleLength - steps);
+        }
+        seed = SeedHelper::advanceSeed(seed);
+    }
+    EXPECT_THROW(static_cast<void>(SeedHelper::stepsBetween(initialSeed, 0)), std::invalid_argument);
+}
+
+
 TEST(SeedHelperTest, AdvanceSeedToEndOfRollSequenceEmptyRoll) {
     // Test case.
     const std::string brand{"Tentatek"};
@@ -101,6 +145,45 @@ TEST(SeedHelperTest, AdvanceSeedToEndOfRollSequenceWithDrink) {
 }
 
 
+TEST(SeedHelperTest, AdvanceSeedToEndOfRollSequenceAbilitySets) {
+    // Test case: Same as `AdvanceSeedToEndOfRollSequenceNoDrink`, but some rolls are only partially known.
+    const std::string brand{"Toni Kensa"};
+    constexpr uint32_t initialSeed = 0xb0980324;
+    AbilitySet inkSavers{Ability::inkSaverMain};
+    inkSavers.insert(Ability::inkSaverSub);
+    AbilitySet specials{Ability::specialSaver};
+    specials.insert(Ability::specialPowerUp);
+    const std::vector<AbilitySet> rolledAbilities {
+        inkSavers,
+        specials,
+        Ability::unknown,
+        inkSavers,
+        Ability::inkSaverMain,
+        Ability::specialPowerUp,
+        specials,
+        Ability::unknown,
+        Ability::subResistanceUp,
+        Ability::intensifyAction,
+    };
+    RollSequence rollSequence{};
+    for (const auto abilities: rolledAbilities) {
+        rollSequence.addRoll(abilities);
+    }
+    constexpr uint32_t expectedFinalSeed = 0x88554788;
+
+    // Test.
+    SeedHelper seedHelper{brand};
+    const auto [validity, finalSeed] = seedHelper.advanceSeedToEndOfRollSequence(initialSeed, rollSequence);
+    EXPECT_TRUE(validity);
+    EXPECT_EQ(finalSeed, expectedFinalSeed);
+
+    // A set without the actual ability.
+    rollSequence.addRoll(inkSavers);
+    const auto [validity2, finalSeed2] = seedHelper.advanceSeedToEndOfRollSequence(initialSeed, rollSequence);
+    EXPECT_FALSE(validity2);
+}
+
+
 #pragma mark getBrandedAbility
 TEST(SeedHelperTest, GetBrandedAbilityNeutralBrands) {
     /// (seed, expected result)
@@ -457,6 +540,29 @@ TEST(SeedHelperTest, FindSeedBiasedBrandsNoDrink) {
 }
 
 
+TEST(SeedHelperTest, FindSeedAbilitySetsNoDrink) {
+    // Same rolls as the first `FindSeedNeutralBrandsNoDrink` test case, with some rolls only partially known.
+    constexpr uint32_t expectedSeed = 0x87a4b37e;
+    const std::vector<Ability> rolledAbilities{Ability::runSpeedUp, Ability::specialChargeUp, Ability::specialChargeUp, Ability::subPowerUp, Ability::runSpeedUp, Ability::specialSaver, Ability::specialChargeUp, Ability::intensifyAction, Ability::specialChargeUp, Ability::specialSaver, Ability::specialChargeUp, Ability::specialSaver, Ability::swimSpeedUp, Ability::specialSaver, Ability::specialSaver};
+
+    RollSequence rollSequence{};
+    for (size_t i = 0; i < rolledAbilities.size(); i += 1) {
+        AbilitySet abilities{rolledAbilities[i]};
+        if (i % 3 == 1) {
+            abilities.insert(Ability::inkSaverMain);
+            abilities.insert(Ability::inkSaverSub);
+        } else if (i == 14) {
+            abilities = Ability::unknown;
+        }
+        rollSequence.addRoll(abilities);
+    }
+
+    auto seedHelper = SeedHelper("Amiibo");
+    const auto results = seedHelper.findSeed(rollSequence);
+    EXPECT_EQ(results, std::vector<uint32_t>({expectedSeed}));
+}
+
+
 #pragma mark findSeed, with drink
 TEST(SeedHelperTest, FindSeedNeutralBrandsWithDrink) {
     /// (expected results/initial seeds, (rolled ability, drink))
@@ -512,6 +618,59 @@ TEST(SeedHelperTest, FindSeedNeutralBrandsWithDrink) {
 }
 
 
+TEST(SeedHelperTest, FindSeedUncertainDrinks) {
+    // Same rolls as the last `FindSeedNeutralBrandsWithDrink` test case, with some drinks unknown.
+    const std::vector<uint32_t> expectedResults{0x9dbce285, 0xb06fb5d3, 0xfaac03bf};
+    const std::vector<Ability> rolledAbilities{Ability::intensifyAction, Ability::swimSpeedUp, Ability::swimSpeedUp, Ability::inkSaverMain, Ability::subResistanceUp, Ability::swimSpeedUp, Ability::specialSaver, Ability::swimSpeedUp, Ability::runSpeedUp, Ability::swimSpeedUp};
+
+    AbilitySet swimSpeedUpOrNoDrink{Ability::swimSpeedUp};
+    swimSpeedUpOrNoDrink.insert(Ability::noDrink);
+
+    RollSequence rollSequence{};
+    for (size_t i = 0; i < rolledAbilities.size(); i += 1) {
+        if (i == 2) {
+            rollSequence.addRoll(rolledAbilities[i], AbilitySet::anyDrink());
+        } else if (i % 4 == 0) {
+            rollSequence.addRoll(rolledAbilities[i], swimSpeedUpOrNoDrink);
+        } else {
+            rollSequence.addRoll(rolledAbilities[i], Ability::swimSpeedUp);
+        }
+    }
+    ASSERT_TRUE(rollSequence.hasUncertainDrinks());
+
+    SeedHelper seedHelper{"Grizzco"};
+    const auto results = seedHelper.findSeed(rollSequence, 4);
+
+    // Uncertain drinks can only add results.
+    const std::set<uint32_t> resultsSet(results.begin(), results.end());
+    EXPECT_EQ(resultsSet.size(), results.size());
+    for (const auto expectedResult: expectedResults) {
+        EXPECT_EQ(resultsSet.count(expectedResult), 1) << "Missing: 0x" << std::hex << expectedResult;
+    }
+    EXPECT_LT(results.size(), 100);
+
+    // Every result must be explained by at least 1 drink chain.
+    for (const auto result: results) {
+        bool valid = false;
+        for (const auto drink2: AbilitySet::anyDrink().toVector()) {
+            for (const auto drink0: swimSpeedUpOrNoDrink.toVector()) {
+                for (const auto drink4: swimSpeedUpOrNoDrink.toVector()) {
+                    for (const auto drink8: swimSpeedUpOrNoDrink.toVector()) {
+                        RollSequence certainRollSequence{};
+                        for (size_t i = 0; i < rolledAbilities.size(); i += 1) {
+                            const auto drink = (i == 0) ? drink0 : (i == 2) ? drink2 : (i == 4) ? drink4 : (i == 8) ? drink8 : Ability::swimSpeedUp;
+                            certainRollSequence.addRoll(rolledAbilities[i], drink);
+                        }
+                        valid = valid || seedHelper.advanceSeedToEndOfRollSequence(result, certainRollSequence).first;
+                    }
+                }
+            }
+        }
+        EXPECT_TRUE(valid) << "Unexplained result: 0x" << std::hex << result;
+    }
+}
+
+
 TEST(SeedHelperTest, FindSeedBiasedBrandsWithDrink) {
     /// (brand, expected results/initial seeds, (rolled ability, drink))
     const std::vector<std::tuple<std::string_view, std::vector<uint32_t>, std::vector<std::pair<Ability, Ability>>>> testCases {
@@ -0,0 +1,141 @@
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "../binary/seed_index.h"
+#include "../seed_helper.h"
+
+#include "temporary_files.h"
+
+
+namespace {
+    /// Partial indices, so that tests stay fast.
+    constexpr uint64_t seedsCount = 1 << 18;
+
+    RollSequence makeRollSequence(const SeedHelper& seedHelper, uint32_t seed, const size_t rollsCount) {
+        RollSequence returnValue{};
+        for (size_t i = 0; i < rollsCount; i += 1) {
+            Ability ability;
+            std::tie(seed, ability) = seedHelper.generateRoll(seed);
+            returnValue.addRoll(ability);
+        }
+        return returnValue;
+    }
+}
+
+
+TEST(SeedIndexTest, Tables) {
+    EXPECT_EQ(SeedIndex::getTableIndex("Amiibo"), 0);
+    EXPECT_EQ(SeedIndex::getTableIndex("Grizzco"), 0);
+    EXPECT_EQ(SeedIndex::getTableIndex("Annaki"), 1);
+    EXPECT_EQ(SeedIndex::getTableIndex("Zink"), 17);
+    EXPECT_THROW(static_cast<void>(SeedIndex::getTableIndex("Not a brand")), std::invalid_argument);
+
+    // Neutral brands share 1 file.
+    EXPECT_EQ(SeedIndex::getFilename("index", "Amiibo"), SeedIndex::getFilename("index", "Cuttlegear"));
+    EXPECT_EQ(std::filesystem::path{SeedIndex::getFilename("index", "Amiibo")}.filename(), "neutral.s3gi");
+    EXPECT_EQ(std::filesystem::path{SeedIndex::getFilename("index", "Splash Mob")}.filename(), "splash_mob.s3gi");
+}
+
+
+TEST(SeedIndexTest, BuildAndFind) {
+    const TemporaryDirectory temporaryDirectory{"index"};
+    const auto directory = temporaryDirectory.getFilename();
+
+    for (const auto [brand, rollsCount, workersCount]: {std::make_tuple("Amiibo", 2, 0), std::make_tuple("Zink", 4, 3), std::make_tuple("Splash Mob", 8, 2)}) {
+        const auto filename = SeedIndex::getFilename(directory, brand);
+        SeedIndex::build(filename, brand, rollsCount, seedsCount, workersCount);
+        EXPECT_FALSE(std::filesystem::exists(filename + ".buckets"));
+        EXPECT_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+        const SeedIndexView index{filename};
+        EXPECT_EQ(index.getRollsCount(), rollsCount);
+        EXPECT_EQ(index.getTableIndex(), SeedIndex::getTableIndex(brand));
+        EXPECT_EQ(index.getSeedsCount(), seedsCount);
+        EXPECT_FALSE(index.isComplete());
+
+        SeedHelper seedHelper{brand};
+        for (const auto seed: {0u, 12345u, static_cast<uint32_t>(seedsCount - 1)}) {
+            // Exactly `k` rolls (many matches), and more rolls (verified).
+            for (const auto sequenceLength: {static_cast<size_t>(rollsCount), static_cast<size_t>(rollsCount) + 6}) {
+                const auto rollSequence = makeRollSequence(seedHelper, seed, sequenceLength);
+                ASSERT_TRUE(index.canFindSeed(rollSequence));
+
+                SearchStats stats{};
+                const auto results = index.findSeed(seedHelper, rollSequence, &stats);
+                EXPECT_EQ(results, seedHelper.findSeedInRange(rollSequence, 0, static_cast<uint32_t>(seedsCount - 1))) << brand << " " << seed;
+                EXPECT_NE(std::find(results.begin(), results.end(), seed), results.end());
+
+                // Only seeds with the fingerprint are evaluated, and rejected after the first `k` rolls.
+                EXPECT_EQ(stats.seedsMatched, results.size());
+                uint64_t rejectedCount = 0;
+                for (size_t i = 0; i < SearchStats::rejectionHistogramSize; i += 1) {
+                    EXPECT_TRUE((i >= static_cast<size_t>(rollsCount)) || (stats.rejectionHistogram[i] == 0)) << i;
+                    rejectedCount += stats.rejectionHistogram[i];
+                }
+                EXPECT_EQ(stats.seedsEvaluated, stats.seedsMatched + rejectedCount);
+                EXPECT_EQ(stats.workerTimings.size(), 1);
+            }
+        }
+    }
+}
+
+
+TEST(SeedIndexTest, CanFindSeed) {
+    const TemporaryDirectory temporaryDirectory{"can_find"};
+    const auto directory = temporaryDirectory.getFilename();
+    const auto filename = SeedIndex::getFilename(directory, "Amiibo");
+    SeedIndex::build(filename, "Amiibo", 3, 1 << 10);
+    const SeedIndexView index{filename};
+    SeedHelper seedHelper{"Amiibo"};
+
+    // Too short.
+    RollSequence rollSequence{std::vector<Ability>{Ability::inkSaverMain, Ability::runSpeedUp}};
+    EXPECT_FALSE(index.canFindSeed(rollSequence));
+    EXPECT_THROW(static_cast<void>(index.findSeed(seedHelper, rollSequence)), std::invalid_argument);
+
+    // Unknown roll within the first `k`.
+    rollSequence = RollSequence{std::vector<Ability>{Ability::inkSaverMain, Ability::unknown, Ability::runSpeedUp}};
+    EXPECT_FALSE(index.canFindSeed(rollSequence));
+
+    // Unknown rolls after the first `k` are verified like any other roll.
+    rollSequence = RollSequence{std::vector<Ability>{Ability::inkSaverMain, Ability::runSpeedUp, Ability::runSpeedUp, Ability::unknown}};
+    EXPECT_TRUE(index.canFindSeed(rollSequence));
+
+    // Drinks.
+    rollSequence.addRoll(Ability::runSpeedUp, Ability::runSpeedUp);
+    EXPECT_FALSE(index.canFindSeed(rollSequence));
+
+    // Another table.
+    SeedHelper biasedSeedHelper{"Zink"};
+    rollSequence = RollSequence{std::vector<Ability>{Ability::inkSaverMain, Ability::runSpeedUp, Ability::runSpeedUp}};
+    EXPECT_THROW(static_cast<void>(index.findSeed(biasedSeedHelper, rollSequence)), std::invalid_argument);
+}
+
+
+TEST(SeedIndexTest, InvalidFiles) {
+    const TemporaryDirectory temporaryDirectory{"invalid"};
+    const auto directory = temporaryDirectory.getFilename();
+    const auto filename = SeedIndex::getFilename(directory, "Amiibo");
+
+    EXPECT_THROW(SeedIndexView{filename}, std::runtime_error);
+    EXPECT_THROW(SeedIndex::build(filename, "Amiibo", 1, 1 << 10), std::invalid_argument);
+    EXPECT_THROW(SeedIndex::build(filename, "Amiibo", 9, 1 << 10), std::invalid_argument);
+    EXPECT_THROW(SeedIndex::build(filename, "Not a brand", 4, 1 << 10), std::invalid_argument);
+
+    SeedIndex::build(filename, "Amiibo", 4, 1 << 10);
+    const auto size = std::filesystem::file_size(filename);
+
+    // Truncated.
+    std::filesystem::resize_file(filename, size - 1);
+    EXPECT_THROW(SeedIndexView{filename}, std::runtime_error);
+
+    // Wrong magic.
+    std::filesystem::resize_file(filename, size);
+    {
+        std::fstream file{filename, std::ios::in | std::ios::out | std::ios::binary};
+        file.write("S3GX", 4);
+    }
+    EXPECT_THROW(SeedIndexView{filename}, std::runtime_error);
+}
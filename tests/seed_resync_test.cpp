@@ -0,0 +1,145 @@
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "../prediction/seed_resync.h"
+
+#include "roll_randomizer.h"
+
+
+namespace {
+    struct Roll {
+        Ability ability;
+        Ability drink;
+        /// Seed after this roll.
+        uint32_t seed;
+    };
+
+    std::vector<Roll> generateRolls(const SeedHelper& seedHelper, uint32_t seed, RollRandomizer& randomizer, const size_t length) {
+        const auto drinks = randomizer.getDrinks(length, 0.3);
+        std::vector<Roll> returnValue{};
+        for (const auto drink: drinks) {
+            Ability ability;
+            std::tie(seed, ability) = (drink == Ability::noDrink) ? seedHelper.generateRoll(seed) : seedHelper.generateRollWithDrink(seed, drink);
+            returnValue.push_back(Roll{ability, drink, seed});
+        }
+        return returnValue;
+    }
+
+    /// Alignment ending at `finalSeed`, if any.
+    const SeedResync::Alignment* findAlignment(const std::vector<SeedResync::Alignment>& alignments, const uint32_t finalSeed) {
+        const auto it = std::find_if(alignments.begin(), alignments.end(), [&](const SeedResync::Alignment& alignment) {
+            return alignment.finalSeed == finalSeed;
+        });
+        return (it == alignments.end()) ? nullptr : &(*it);
+    }
+}
+
+
+TEST(SeedResyncTest, MatchingSequence) {
+    SeedHelper seedHelper{"Zink"};
+    seedHelper.cacheAllDrinkRollToAbilityMaps();
+    RollRandomizer randomizer{20221106};
+    const auto seed = randomizer.getSeed();
+    const auto rolls = generateRolls(seedHelper, seed, randomizer, 30);
+
+    RollSequence rollSequence{};
+    for (const auto& [ability, drink, nextSeed]: rolls) {
+        rollSequence.addRoll(ability, drink);
+    }
+    EXPECT_EQ(SeedResync::getVerifiedRollsCount(seedHelper, seed, rollSequence), rolls.size());
+
+    const auto alignments = SeedResync::findAlignments(seedHelper, seed, rollSequence, 0, 0);
+    ASSERT_EQ(alignments.size(), 1);
+    EXPECT_EQ(alignments[0].finalSeed, rolls.back().seed);
+    EXPECT_TRUE(alignments[0].edits.empty());
+
+    // The last verified seed in the middle of the sequence.
+    const auto startAlignments = SeedResync::findAlignments(seedHelper, rolls[9].seed, rollSequence, 10, 2);
+    ASSERT_FALSE(startAlignments.empty());
+    EXPECT_EQ(startAlignments[0].finalSeed, rolls.back().seed);
+    EXPECT_TRUE(startAlignments[0].edits.empty());
+}
+
+
+TEST(SeedResyncTest, UnloggedRollsAndDrinks) {
+    RollRandomizer randomizer{42};
+    for (const auto brandName: {"Zink", "Krak-On", "Toni Kensa"}) {
+        SeedHelper seedHelper{brandName};
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+
+        for (size_t testCase = 0; testCase < 20; testCase += 1) {
+            const auto seed = randomizer.getSeed();
+            const auto rolls = generateRolls(seedHelper, seed, randomizer, 40);
+
+            // Log all but 2 rolls, and log 1 drink as no drink.
+            const size_t firstSkippedIndex = 5 + testCase;
+            const size_t secondSkippedIndex = 30;
+            std::vector<SeedResync::Edit> expectedEdits{};
+            RollSequence rollSequence{};
+            for (size_t i = 0; i < rolls.size(); i += 1) {
+                const auto& [ability, drink, nextSeed] = rolls[i];
+                if ((i == firstSkippedIndex) || (i == secondSkippedIndex)) {
+                    expectedEdits.push_back(SeedResync::Edit{SeedResync::EditKind::unloggedRoll, rollSequence.size()});
+                    continue;
+                }
+                if ((i > secondSkippedIndex) && (drink != Ability::noDrink) && (expectedEdits.size() == 2)) {
+                    expectedEdits.push_back(SeedResync::Edit{SeedResync::EditKind::unloggedDrink, rollSequence.size()});
+                    rollSequence.addRoll(ability, Ability::noDrink);
+                    continue;
+                }
+                rollSequence.addRoll(ability, drink);
+            }
+            const std::string testCaseDescription = std::string{"Brand: "} + brandName + "; Test case: " + std::to_string(testCase);
+
+            EXPECT_LT(SeedResync::getVerifiedRollsCount(seedHelper, seed, rollSequence), rollSequence.size()) << testCaseDescription;
+
+            const auto alignments = SeedResync::findAlignments(seedHelper, seed, rollSequence, 0, expectedEdits.size());
+            ASSERT_FALSE(alignments.empty()) << testCaseDescription;
+            for (size_t i = 1; i < alignments.size(); i += 1) {
+                EXPECT_LE(alignments[i - 1].edits.size(), alignments[i].edits.size()) << testCaseDescription;
+            }
+
+            // The real alignment, or one as short that ends at the same seed.
+            const auto alignment = findAlignment(alignments, rolls.back().seed);
+            ASSERT_NE(alignment, nullptr) << testCaseDescription;
+            EXPECT_LE(alignment->edits.size(), expectedEdits.size()) << testCaseDescription;
+
+            // The logged rolls with the edits applied (as unknown rolls and drinks) reach the final seed without edits.
+            RollSequence editedRollSequence{};
+            auto edit = alignment->edits.begin();
+            for (size_t i = 0; i < rollSequence.size(); i += 1) {
+                auto [abilities, drinks] = *(rollSequence.begin() + static_cast<std::ptrdiff_t>(i));
+                for (; (edit != alignment->edits.end()) && (edit->rollIndex == i); edit++) {
+                    if (edit->kind == SeedResync::EditKind::unloggedRoll) {
+                        editedRollSequence.addRoll(Ability::unknown, AbilitySet::anyDrink());
+                    } else {
+                        drinks = AbilitySet::anyDrink();
+                    }
+                }
+                editedRollSequence.addRoll(abilities, drinks);
+            }
+            EXPECT_NE(findAlignment(SeedResync::findAlignments(seedHelper, seed, editedRollSequence, 0, 0), rolls.back().seed), nullptr) << testCaseDescription;
+
+            // Not within fewer edits, unless the skipped rolls weren't needed.
+            const auto fewerAlignments = SeedResync::findAlignments(seedHelper, seed, rollSequence, 0, expectedEdits.size() - 1);
+            if (alignment->edits.size() == expectedEdits.size()) {
+                EXPECT_EQ(findAlignment(fewerAlignments, rolls.back().seed), nullptr) << testCaseDescription;
+            }
+        }
+    }
+}
+
+
+TEST(SeedResyncTest, NoAlignment) {
+    SeedHelper seedHelper{"Zink"};
+    RollSequence rollSequence{};
+    for (size_t i = 0; i < 12; i += 1) {
+        rollSequence.addRoll(Ability::inkSaverMain, Ability::noDrink);
+    }
+    const auto seed = 0x12345678u;
+    EXPECT_TRUE(SeedResync::findAlignments(seedHelper, seed, rollSequence, 0, 2).empty());
+
+    EXPECT_THROW(SeedResync::findAlignments(seedHelper, seed, rollSequence, 13, 2), std::invalid_argument);
+    EXPECT_THROW(SeedResync::findAlignments(seedHelper, seed, rollSequence, 0, 256), std::invalid_argument);
+}
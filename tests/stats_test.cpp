@@ -0,0 +1,181 @@
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "../seed_helper.h"
+#include "../helpers/stats.h"
+#include "roll_randomizer.h"
+
+
+namespace {
+    /// Rolls generated from `initialSeed`, with each drink used with probability `drinkRatio`.
+    RollSequence makeRollSequence(const SeedHelper& seedHelper, RollRandomizer& randomizer, const uint32_t initialSeed, const size_t length, const double drinkRatio, const bool uncertainDrinks) {
+        RollSequence returnValue{};
+        auto seed = initialSeed;
+        for (const auto drink: randomizer.getDrinks(length, drinkRatio)) {
+            if (drink == Ability::noDrink) {
+                const auto [nextSeed, ability] = seedHelper.generateRoll(seed);
+                returnValue.addRoll(ability);
+                seed = nextSeed;
+                continue;
+            }
+
+            const auto [nextSeed, ability] = seedHelper.generateRollWithDrink(seed, drink);
+            if (uncertainDrinks) {
+                returnValue.addRoll(ability, AbilitySet::fromMask(AbilitySet{drink}.getMask() | AbilitySet::noDrinkMask));
+            } else {
+                returnValue.addRoll(ability, drink);
+            }
+            seed = nextSeed;
+        }
+
+        return returnValue;
+    }
+}
+
+
+#pragma mark Search counters
+TEST(StatsTest, SearchCounters) {
+    constexpr uint32_t seedsCount = 1 << 18;
+    constexpr size_t workersCount = 3;
+
+    RollRandomizer randomizer{41};
+    for (const auto [drinkRatio, uncertainDrinks]: {std::make_pair(0.0, false), std::make_pair(0.5, false), std::make_pair(1.0, false), std::make_pair(0.5, true)}) {
+        SeedHelper seedHelper{"Zink"};
+        seedHelper.cacheAllDrinkRollToAbilityMaps();
+        const auto initialSeed = randomizer.getSeed();
+        const auto rollSequence = makeRollSequence(seedHelper, randomizer, initialSeed, 6, drinkRatio, uncertainDrinks);
+        const auto seedStart = initialSeed - std::min(initialSeed, seedsCount / 2);
+        const auto seedStop = seedStart + (seedsCount - 1);
+
+        SearchStats stats{};
+        const auto results = seedHelper.findSeedInRange(rollSequence, seedStart, seedStop, workersCount, &stats);
+        EXPECT_EQ(results, seedHelper.findSeedInRange(rollSequence, seedStart, seedStop, workersCount));
+        EXPECT_NE(std::find(results.begin(), results.end(), initialSeed), results.end());
+
+        // Every seed is either matched or rejected at exactly 1 roll.
+        EXPECT_EQ(stats.seedsEvaluated, seedsCount);
+        EXPECT_EQ(stats.seedsMatched, results.size());
+        const auto rejectedCount = std::accumulate(stats.rejectionHistogram.begin(), stats.rejectionHistogram.end(), uint64_t{0});
+        EXPECT_EQ(rejectedCount + stats.seedsMatched, stats.seedsEvaluated);
+        EXPECT_GT(stats.rejectionHistogram[0], stats.rejectionHistogram[1]);
+        for (size_t i = rollSequence.size(); i < SearchStats::rejectionHistogramSize; i += 1) {
+            EXPECT_EQ(stats.rejectionHistogram[i], 0);
+        }
+
+        // Drinks are only counted with certain drinks. Drinks' abilities are rolled directly 30% of the time.
+        const auto drinkRolls = stats.drinkHits + stats.drinkMisses;
+        if ((drinkRatio == 0) || uncertainDrinks) {
+            EXPECT_EQ(drinkRolls, 0);
+        } else {
+            EXPECT_GE(drinkRolls, seedsCount / 2);
+            const auto hitRate = static_cast<double>(stats.drinkHits) / static_cast<double>(drinkRolls);
+            EXPECT_NEAR(hitRate, 0.3, 0.02);
+        }
+
+        EXPECT_EQ(stats.workerTimings.size(), workersCount);
+    }
+}
+
+
+TEST(StatsTest, MergeSearchStats) {
+    SearchStats lhs{};
+    lhs.seedsEvaluated = 10;
+    lhs.seedsMatched = 1;
+    lhs.countRejection(0);
+    lhs.countRejection(100);
+    lhs.workerTimings.push_back(Timing{1, 2});
+
+    SearchStats rhs{};
+    rhs.seedsEvaluated = 5;
+    rhs.countRejection(SearchStats::rejectionHistogramSize - 1);
+    rhs.drinkHits = 3;
+    rhs.workerTimings.push_back(Timing{3, 4});
+
+    lhs += rhs;
+    EXPECT_EQ(lhs.seedsEvaluated, 15);
+    EXPECT_EQ(lhs.seedsMatched, 1);
+    EXPECT_EQ(lhs.rejectionHistogram[0], 1);
+    EXPECT_EQ(lhs.rejectionHistogram[SearchStats::rejectionHistogramSize - 1], 2);
+    EXPECT_EQ(lhs.drinkHits, 3);
+    ASSERT_EQ(lhs.workerTimings.size(), 2);
+    EXPECT_EQ(lhs.workerTimings[1].cpuSeconds, 4);
+}
+
+
+#pragma mark Run stats
+TEST(StatsTest, Disabled) {
+    RunStats stats{false};
+    EXPECT_FALSE(stats.isEnabled());
+    EXPECT_EQ(stats.getSearchStats(), nullptr);
+    {
+        const auto phase = stats.startPhase("load");
+    }
+
+    std::ostringstream stream{};
+    stats.print(stream);
+    EXPECT_EQ(stream.str().find("load"), std::string::npos);
+}
+
+
+TEST(StatsTest, Phases) {
+    RunStats stats{true};
+    ASSERT_NE(stats.getSearchStats(), nullptr);
+    for (size_t i = 0; i < 2; i += 1) {
+        auto phase = stats.startPhase("tables");
+        phase.stop();
+        phase.stop();  // No-op.
+    }
+    {
+        const auto phase = stats.startPhase("search");
+    }
+
+    std::ostringstream stream{};
+    stats.print(stream);
+    const auto text = stream.str();
+    const auto tablesPosition = text.find("tables");
+    ASSERT_NE(tablesPosition, std::string::npos);
+    EXPECT_EQ(text.find("tables", tablesPosition + 1), std::string::npos);  // Added up.
+    EXPECT_GT(text.find("search"), tablesPosition);
+}
+
+
+TEST(StatsTest, Prometheus) {
+    RunStats stats{true};
+    {
+        const auto phase = stats.startPhase("load");
+    }
+    auto& searchStats = *stats.getSearchStats();
+    searchStats.seedsEvaluated = 100;
+    searchStats.seedsMatched = 2;
+    searchStats.countRejection(0);
+    searchStats.drinkMisses = 7;
+    searchStats.workerTimings = {Timing{1, 1}, Timing{3, 3}};
+
+    const auto filename = (std::filesystem::temp_directory_path() / "stats_test.prom").string();
+    stats.writePrometheus(filename, "find");
+    EXPECT_FALSE(std::filesystem::exists(filename + ".tmp"));
+
+    std::ifstream file{filename};
+    std::stringstream contents{};
+    contents << file.rdbuf();
+    const auto text = contents.str();
+    std::filesystem::remove(filename);
+
+    for (const auto line: {
+        "# TYPE splatoon_find_seeds_evaluated_total counter\n",
+        "splatoon_find_seeds_evaluated_total 100\n",
+        "splatoon_find_seeds_matched_total 2\n",
+        "splatoon_find_seeds_rejected_total{roll=\"0\"} 1\n",
+        "splatoon_find_seeds_rejected_total{roll=\"15+\"} 0\n",
+        "splatoon_find_drink_rolls_total{result=\"miss\"} 7\n",
+        "splatoon_find_worker_wall_seconds{worker=\"1\"} 3\n",
+        "splatoon_find_load_imbalance 1.5\n",
+        "splatoon_find_phase_wall_seconds{phase=\"load\"} ",
+    }) {
+        EXPECT_NE(text.find(line), std::string::npos) << line;
+    }
+}
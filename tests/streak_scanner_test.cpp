@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include "../prediction/streak_scanner.h"
+
+#include "roll_randomizer.h"
+
+
+/// Random rolls with some forced streaks (uniform rolls rarely have long ones).
+static std::vector<uint8_t> getRandomPackedRolls(size_t length) {
+    const auto abilities = getRandomRolls(length);
+    std::vector<uint8_t> returnValue(length, 0);
+    for (size_t i = 0; i < length; i += 1) {
+        returnValue[i] = static_cast<uint8_t>(abilities[i]);
+        if ((i > 0) && (AbilityHelper::getIndex(abilities[i]) < 6)) {
+            returnValue[i] = returnValue[i - 1];
+        }
+    }
+
+    return returnValue;
+}
+
+
+TEST(StreakScannerTest, KernelsMatchScalar) {
+    for (size_t length = 0; length < 300; length += 1) {
+        for (size_t streakLength = 2; streakLength <= 5; streakLength += 1) {
+            const auto rolls = getRandomPackedRolls(length);
+            const auto expectedStreaks = StreakScanner::Kernels::findFirstStreaksScalar(rolls.data(), rolls.size(), streakLength);
+            const std::string testCaseDescription = "Length: " + std::to_string(length) + "; Streak length: " + std::to_string(streakLength);
+
+            EXPECT_EQ(StreakScanner::Kernels::findFirstStreaksSwar(rolls.data(), rolls.size(), streakLength), expectedStreaks) << testCaseDescription;
+#ifdef __SSE2__
+            EXPECT_EQ(StreakScanner::Kernels::findFirstStreaksSse2(rolls.data(), rolls.size(), streakLength), expectedStreaks) << testCaseDescription;
+#endif
+            EXPECT_EQ(StreakScanner::findFirstStreaks(rolls, streakLength), expectedStreaks) << testCaseDescription;
+        }
+    }
+}
+
+
+TEST(StreakScannerTest, Scalar) {
+    const std::vector<uint8_t> rolls{0, 1, 1, 1, 2, 0, 0, 0, 0, 1, 1, 1, 3, 3};
+    const auto firstStreaks = StreakScanner::Kernels::findFirstStreaksScalar(rolls.data(), rolls.size(), 3);
+    EXPECT_EQ(firstStreaks[0], 5);
+    EXPECT_EQ(firstStreaks[1], 1);
+    EXPECT_EQ(firstStreaks[2], StreakScanner::notFound);
+    EXPECT_EQ(firstStreaks[3], StreakScanner::notFound);
+
+    const auto firstStreaks2 = StreakScanner::Kernels::findFirstStreaksScalar(rolls.data(), rolls.size(), 2);
+    EXPECT_EQ(firstStreaks2[3], 12);
+}
+
+
+TEST(StreakScannerTest, AllDrinksMatchGenerateRolls) {
+    constexpr size_t length = 20000;
+    constexpr uint32_t seed = 0x88554788;
+    SeedHelper seedHelper{"Toni Kensa"};
+
+    const auto firstStreaks = StreakScanner::findFirstStreaksForAllDrinks(seedHelper, seed, length, 3, 4);
+    for (size_t i = 0; i < AbilityHelper::drinkChoicesCount; i += 1) {
+        const auto drink = AbilityHelper::getDrinkChoice(i);
+        const auto rolls = (drink == Ability::noDrink) ? seedHelper.generateRolls(seed, length) : seedHelper.generateRollsWithDrink(seed, drink, length);
+
+        std::vector<uint8_t> packedRolls(length, 0);
+        for (size_t j = 0; j < length; j += 1) {
+            packedRolls[j] = static_cast<uint8_t>(rolls[j]);
+        }
+        EXPECT_EQ(firstStreaks[i], StreakScanner::Kernels::findFirstStreaksScalar(packedRolls.data(), length, 3)) << "Drink choice: " << i;
+    }
+}
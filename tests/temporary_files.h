@@ -0,0 +1,74 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_TEMPORARY_FILES_H
+#define SPLATOON_3_GEAR_HELPER_CPP_TEMPORARY_FILES_H
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "gtest/gtest.h"
+
+
+/// RAII
+class TemporaryFile {
+public:
+    std::filesystem::path path;
+
+    [[nodiscard]] std::string getFilename() const {
+        return path.string();
+    }
+
+    // Deleted constructors.
+    TemporaryFile() = delete;
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    /**
+     * Get a unique path in the gtest temporary directory, ending with `filename` (so that extensions are kept).
+     * The file isn't created.
+     */
+    explicit TemporaryFile(std::string_view filename) {
+        if (filename.empty()) {
+            throw std::invalid_argument("Filename is empty.");
+        }
+
+        path = std::filesystem::path(::testing::TempDir());
+        if (!std::filesystem::is_directory(path)) {
+            std::string errorMessage{"Temporary dir `"};
+            errorMessage += path;
+            errorMessage += "` doesn't exist!";
+            throw std::runtime_error(errorMessage);
+        }
+
+        // Tests of the same binary may be run in parallel (e.g. by `ctest -j`), so the name is prefixed by a timestamp.
+        path /= std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+        path += filename;
+        if (std::filesystem::exists(path)) {
+            std::string errorMessage{path};
+            errorMessage += " already exists!";
+            throw std::runtime_error(errorMessage);
+        } else {
+            std::cout << "RAII temporary file: " << getFilename() << std::endl;
+        }
+    }
+
+    /// Removes the file (or directory, with its contents) if it was created. Errors are ignored.
+    ~TemporaryFile() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+};
+
+/// A `TemporaryFile` created as an empty directory.
+class TemporaryDirectory: public TemporaryFile {
+public:
+    explicit TemporaryDirectory(std::string_view name): TemporaryFile{name} {
+        std::filesystem::create_directories(path);
+    }
+};
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_TEMPORARY_FILES_H
@@ -0,0 +1,93 @@
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "../helpers/parallel.h"
+#include "../helpers/trace.h"
+
+
+namespace {
+    std::string writeTrace() {
+        const auto filename = (std::filesystem::temp_directory_path() / "trace_test.json").string();
+        Trace::write(filename);
+
+        std::ifstream file{filename};
+        std::stringstream contents{};
+        contents << file.rdbuf();
+        std::filesystem::remove(filename);
+        return contents.str();
+    }
+
+    /// Each test starts with no events, also when all tests run in 1 process.
+    class TraceTest: public testing::Test {
+    protected:
+        void SetUp() override {
+            Trace::reset();
+        }
+
+        void TearDown() override {
+            Trace::reset();
+        }
+    };
+
+    size_t countOccurrences(const std::string& text, const std::string_view substring) {
+        size_t returnValue = 0;
+        for (auto position = text.find(substring); position != std::string::npos; position = text.find(substring, position + 1)) {
+            returnValue += 1;
+        }
+        return returnValue;
+    }
+}
+
+
+TEST_F(TraceTest, Disabled) {
+    EXPECT_FALSE(Trace::isEnabled());
+    {
+        const Trace::Scope scope{"scan"};
+    }
+    Trace::begin("load");
+    Trace::end("load");
+
+    const auto text = writeTrace();
+    EXPECT_EQ(text.find("\"ph\":"), std::string::npos);
+}
+
+
+TEST_F(TraceTest, Workers) {
+    Trace::enable();
+    ASSERT_TRUE(Trace::isEnabled());
+
+    Trace::begin("search", 42);
+    Parallel::forEachRange(4, 4, [](const size_t start, const size_t) {
+        const Trace::Scope scope{"scan", static_cast<int64_t>(start)};
+    });
+    Trace::end("search");
+
+    const auto text = writeTrace();
+    EXPECT_EQ(text.rfind("{\"traceEvents\":[\n", 0), 0);
+    EXPECT_EQ(countOccurrences(text, "\"ph\":\"M\""), 5);
+    EXPECT_EQ(countOccurrences(text, R"("args":{"name":"main"})"), 1);
+    EXPECT_EQ(countOccurrences(text, R"({"name":"scan","ph":"B")"), 4);
+    EXPECT_EQ(countOccurrences(text, R"({"name":"scan","ph":"E")"), 4);
+    EXPECT_EQ(countOccurrences(text, R"("args":{"value":42})"), 1);
+    EXPECT_EQ(countOccurrences(text, R"("args":{"value":3})"), 1);
+
+    // Main thread events stay in order.
+    EXPECT_LT(text.find(R"({"name":"search","ph":"B")"), text.find(R"({"name":"search","ph":"E")"));
+}
+
+
+TEST_F(TraceTest, RingBuffer) {
+    Trace::enable();
+    for (size_t i = 0; i < Trace::threadCapacity + 10; i += 1) {
+        Trace::begin("scan", static_cast<int64_t>(i));
+    }
+
+    // Only the latest events are kept.
+    const auto text = writeTrace();
+    EXPECT_EQ(countOccurrences(text, R"({"name":"scan","ph":"B")"), Trace::threadCapacity);
+    EXPECT_EQ(text.find(R"("args":{"value":9})"), std::string::npos);
+    EXPECT_NE(text.find(R"("args":{"value":10})"), std::string::npos);
+}
@@ -4,69 +4,13 @@
 
 
 #include <filesystem>
-#include <iostream>
 #include <stdexcept>
 
 #include "gtest/gtest.h"
 #include "../yaml/yaml_helper.h"
 
 #include "roll_randomizer.h"
-
-
-#pragma mark Helpers
-/// RAII
-class TemporaryFile {
-public:
-    std::filesystem::path path;
-
-    [[nodiscard]] std::string getFilename() const {
-        return path.string();
-    }
-
-    // Deleted constructors.
-    TemporaryFile() = delete;
-    TemporaryFile(const TemporaryFile&) = delete;
-    TemporaryFile& operator=(const TemporaryFile&) = delete;
-
-    /**
-     * Get the filename of the specified temporary file if it doesn't exist.
-     */
-    explicit TemporaryFile(std::string_view filename) {
-        if (filename.empty()) {
-            throw std::invalid_argument("Filename is empty.");
-        }
-
-        path = std::filesystem::path(::testing::TempDir());
-        if (!std::filesystem::is_directory(path)) {
-            std::string errorMessage{"Temporary dir `"};
-            errorMessage += path;
-            errorMessage += "` doesn't exist!";
-            throw std::runtime_error(errorMessage);
-        }
-
-        path /= filename;
-        if (std::filesystem::exists(path)) {
-            std::string errorMessage{path};
-            errorMessage += " already exists!";
-            throw std::runtime_error(errorMessage);
-        } else {
-            // NOTE: I should actually create the file here (which involves using a mutex).
-            // But since this class isn't multi-threaded, I'll just omit this part 😂.
-            std::cout << "RAII temporary file: " << getFilename() << std::endl;
-        }
-    }
-
-    ~TemporaryFile() {
-        // Check if `path` is indeed initialized before deleting it.
-        // TODO: Is this check really needed? The destructor won't get called if the constructor failed.
-        if ((!path.empty()) && (std::filesystem::is_regular_file(path))) {
-            // In fact, I'm too afraid to delete a file. So I'll just rename it here instead.
-            auto newPath = path;
-            newPath += ".old";  // Hmm although `filesystem::path` has `/`, it doesn't support `+`.
-            std::filesystem::rename(path, newPath);
-        }
-    }
-};
+#include "temporary_files.h"
 
 
 #pragma mark Tests
@@ -146,3 +90,64 @@ TEST(YamlHelperTest, CreateSaveLoadWithDrink) {
         it2 += 1;
     }
 }
+
+
+TEST(YamlHelperTest, CreateSaveLoadAbilityAndDrinkSets) {
+    TemporaryFile temporaryFile{"splatoon_ability_sets.yaml"};
+    const auto filename = temporaryFile.getFilename();
+    std::string testCaseDescription = "Temporary file: " + filename;
+
+    // Create and save.
+    const std::string name{"Annaki Drive Tee"};
+    const std::string brand{"Annaki"};
+    auto rollsAndDrinks = getRandomRollsAndDrinks(100);
+    for (size_t i = 0; i < rollsAndDrinks.size(); i += 3) {
+        // Some partially known rolls, and some completely unknown rolls.
+        if (i % 2 == 0) {
+            rollsAndDrinks[i].first.insert(getRandomAbility());
+        } else {
+            rollsAndDrinks[i].first = Ability::unknown;
+        }
+    }
+    for (size_t i = 0; i < rollsAndDrinks.size(); i += 5) {
+        // Some uncertain drinks.
+        if (i % 2 == 0) {
+            rollsAndDrinks[i].second = AbilitySet::anyDrink();
+        } else {
+            rollsAndDrinks[i].second.insert(Ability::noDrink);
+            rollsAndDrinks[i].second.insert(getRandomAbility());
+        }
+    }
+
+    {
+        YamlFile yamlFile{filename, name, brand, {}};
+        for (const auto& [roll, drink]: rollsAndDrinks) {
+            yamlFile.addRoll(roll, drink);
+        }
+    }
+
+    // Load.
+    YamlFile yamlFile{filename};
+    ASSERT_EQ(yamlFile.getRollSequence().size(), rollsAndDrinks.size()) << testCaseDescription;
+
+    auto it1 = rollsAndDrinks.begin();
+    auto it2 = yamlFile.getRollSequence().begin();
+    while (it1 != rollsAndDrinks.end()) {
+        EXPECT_EQ(it1->first, it2->first) << testCaseDescription;
+        EXPECT_EQ(it1->second, it2->second) << testCaseDescription;
+
+        it1 += 1;
+        it2 += 1;
+    }
+}
+
+
+TEST(YamlHelperTest, MissingFile) {
+    const TemporaryFile file{"missing.yaml"};
+    try {
+        YamlFile yamlFile{file.getFilename()};
+        FAIL() << "Loaded a missing file.";
+    } catch (const std::runtime_error& error) {
+        EXPECT_NE(std::string_view{error.what()}.find(file.getFilename()), std::string_view::npos) << error.what();
+    }
+}
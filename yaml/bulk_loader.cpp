@@ -0,0 +1,121 @@
+#include "bulk_loader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "yaml_helper.h"
+#include "../binary/gear_file.h"
+#include "../helpers/parallel.h"
+
+
+namespace BulkLoader {
+    /// Read the whole file into `buffer`, reusing its capacity.
+    static void readFile(const std::string& filename, std::string& buffer) {
+        const auto fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+        if (fileDescriptor < 0) {
+            throw std::runtime_error("Failed to open file.");
+        }
+
+        struct stat fileStatus{};
+        if (::fstat(fileDescriptor, &fileStatus) != 0) {
+            ::close(fileDescriptor);
+            throw std::runtime_error("Failed to read file.");
+        }
+
+        buffer.resize(static_cast<size_t>(fileStatus.st_size));
+        size_t readSize = 0;
+        while (readSize < buffer.size()) {
+            const auto result = ::read(fileDescriptor, buffer.data() + readSize, buffer.size() - readSize);
+            if ((result < 0) && (errno == EINTR)) {
+                continue;
+            } else if (result <= 0) {
+                ::close(fileDescriptor);
+                throw std::runtime_error("Failed to read file.");
+            }
+            readSize += static_cast<size_t>(result);
+        }
+
+        ::close(fileDescriptor);
+    }
+
+    std::string_view Collection::getBrand(const size_t gearIndex) const {
+        return GearFile::getBrand(gears[gearIndex].brandIndex);
+    }
+
+    RollSequence Collection::getRollSequence(const size_t gearIndex) const {
+        const auto& gear = gears[gearIndex];
+
+        RollSequence returnValue{};
+        for (size_t i = gear.rollsStart; i < gear.rollsStart + gear.rollsCount; i += 1) {
+            returnValue.addRoll(rolls[i].first, rolls[i].second);
+        }
+
+        return returnValue;
+    }
+
+    std::vector<std::string> listGearFiles(const std::string& directory) {
+        std::vector<std::string> returnValue{};
+        for (const auto& entry: std::filesystem::directory_iterator(directory)) {
+            const auto extension = entry.path().extension();
+            if (entry.is_regular_file() && ((extension == ".yaml") || (extension == ".yml") || (extension == GearFile::extension))) {
+                returnValue.push_back(entry.path().string());
+            }
+        }
+        std::sort(returnValue.begin(), returnValue.end());
+
+        return returnValue;
+    }
+
+    Collection loadFiles(const std::vector<std::string>& filenames, const size_t workersCount) {
+        // Each worker loads a range of files into its own collection.
+        auto workerCollections = Parallel::mapRanges(filenames.size(), workersCount, [&filenames](const size_t start, const size_t stop) {
+            Collection collection{};
+            std::string buffer{};
+            for (size_t i = start; i < stop; i += 1) {
+                const auto& filename = filenames[i];
+                try {
+                    const auto addGear = [&](const std::string_view name, const std::string_view brand, const std::optional<uint32_t> initialSeed, const RollSequence& rollSequence) {
+                        const auto brandIndex = GearFile::getBrandIndex(brand);
+                        collection.gears.push_back(GearRecord{filename, std::string{name}, brandIndex, initialSeed, collection.rolls.size(), rollSequence.size()});
+                        collection.rolls.insert(collection.rolls.end(), rollSequence.begin(), rollSequence.end());
+                    };
+
+                    if (std::filesystem::path{filename}.extension() == GearFile::extension) {
+                        const GearFileView gearFile{filename};
+                        addGear(gearFile.getName(), gearFile.getBrand(), gearFile.getInitialSeed(), gearFile.getRollSequence());
+                    } else {
+                        readFile(filename, buffer);
+                        const auto contents = GearYaml::parse(buffer, filename);
+                        addGear(contents.name, contents.brand, contents.initialSeed, contents.rollSequence);
+                    }
+                } catch (const std::exception& e) {
+                    collection.errors.push_back(LoadError{filename, e.what()});
+                }
+            }
+            return collection;
+        });
+
+        // Merge in range order.
+        Collection returnValue{};
+        for (auto& collection: workerCollections) {
+            for (auto& gear: collection.gears) {
+                gear.rollsStart += returnValue.rolls.size();
+                returnValue.gears.push_back(std::move(gear));
+            }
+            returnValue.rolls.insert(returnValue.rolls.end(), collection.rolls.begin(), collection.rolls.end());
+            returnValue.errors.insert(returnValue.errors.end(), collection.errors.begin(), collection.errors.end());
+        }
+
+        return returnValue;
+    }
+
+    Collection loadDirectory(const std::string& directory, const size_t workersCount) {
+        return loadFiles(listGearFiles(directory), workersCount);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_BULK_LOADER_H
+#define SPLATOON_3_GEAR_HELPER_CPP_BULK_LOADER_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../data/roll_sequence.h"
+
+
+/**
+ * Loads many gear files (YAML or `.gear`) at once.
+ *
+ * Each worker reads its files into one reused buffer (1 `read` per file) and parses them in memory.
+ * Rolls of all gears are packed into 1 array.
+ */
+namespace BulkLoader {
+    struct GearRecord {
+        std::string filename;
+        std::string name;
+        /// `GearFile::getBrandIndex`.
+        uint8_t brandIndex;
+        std::optional<uint32_t> initialSeed;
+
+        /// Rolls: `Collection::rolls[rollsStart, rollsStart + rollsCount)`.
+        size_t rollsStart;
+        size_t rollsCount;
+    };
+
+    struct LoadError {
+        std::string filename;
+        std::string message;
+    };
+
+    struct Collection {
+        /// In input order (sorted by filename for directories).
+        std::vector<GearRecord> gears;
+        /// (rolled abilities, drinks) of all gears.
+        RollSequence::DataType rolls;
+        std::vector<LoadError> errors;
+
+        [[nodiscard]] std::string_view getBrand(size_t gearIndex) const;
+        [[nodiscard]] RollSequence getRollSequence(size_t gearIndex) const;
+    };
+
+    /// `.yaml`/`.yml`/`.gear` files in `directory` (not recursive), sorted.
+    std::vector<std::string> listGearFiles(const std::string& directory);
+
+    /**
+     * Load `filenames` in parallel.
+     * Files that can't be read or parsed (including unknown brands) are reported in `errors` instead.
+     */
+    Collection loadFiles(const std::vector<std::string>& filenames, size_t workersCount = 0);
+
+    /// `loadFiles(listGearFiles(directory))`.
+    Collection loadDirectory(const std::string& directory, size_t workersCount = 0);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_BULK_LOADER_H
@@ -0,0 +1,543 @@
+#include "gear_yaml.h"
+
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+#include "../helpers/output_buffer.h"
+
+
+#pragma mark - Ability and drink sets
+namespace GearYaml {
+    /// "No drink", as a single drink or in drink lists.
+    static constexpr std::string_view noDrinkId = "none";
+
+    /// yaml-cpp's text of null scalars.
+    static constexpr std::string_view nullText = "null";
+
+    enum class SetKind {
+        /**
+         * Either:
+         *
+         * - A single ability ID (`unknown` for any ability)
+         * - A list of ability IDs: The roll is one of these abilities
+         */
+        abilities,
+
+        /**
+         * Either:
+         *
+         * - A single drink ID (`none` for no drink, like an absent `drink` key)
+         * - `unknown`: Any drink, or no drink
+         * - A list of drink IDs (and `none` for no drink): One of these drinks was used
+         */
+        drinks,
+    };
+
+    static Ability getListElement(const SetKind kind, const std::string_view id) {
+        if ((kind == SetKind::drinks) && (id == noDrinkId)) {
+            return Ability::noDrink;
+        }
+        return AbilityHelper::fromId(id);
+    }
+
+    static AbilitySet getSingle(const SetKind kind, const std::string_view id) {
+        if ((kind == SetKind::drinks) && (id == noDrinkId)) {
+            return Ability::noDrink;
+        }
+        const auto ability = AbilityHelper::fromId(id);
+        if ((kind == SetKind::drinks) && (ability == Ability::unknown)) {
+            return AbilitySet::anyDrink();
+        }
+        return ability;
+    }
+
+    static void checkListNotEmpty(const SetKind kind, const AbilitySet set) {
+        if (set.empty()) {
+            throw std::runtime_error((kind == SetKind::abilities) ? "Empty ability list." : "Empty drink list.");
+        }
+    }
+}
+
+
+#pragma mark - Parser
+namespace GearYaml {
+    static constexpr bool isBlank(const char c) {
+        return (c == ' ') || (c == '\t');
+    }
+
+    static std::string_view skipBlanks(std::string_view text) {
+        while (!text.empty() && isBlank(text.front())) {
+            text.remove_prefix(1);
+        }
+        return text;
+    }
+
+    /// Only blanks and a comment remain.
+    static bool isAtEnd(const std::string_view text) {
+        const auto rest = skipBlanks(text);
+        return rest.empty() || (rest.front() == '#');
+    }
+
+    /// The character of an escape sequence after `\`, and the sequence's length: `"`, `\`, or `xXX` (below `x80`).
+    static std::optional<std::pair<char, size_t>> getEscapedCharacter(const std::string_view text) {
+        if (!text.empty() && ((text.front() == '"') || (text.front() == '\\'))) {
+            return std::pair{text.front(), size_t{1}};
+        }
+
+        unsigned int code = 0;
+        if ((text.size() >= 3) && (text.front() == 'x')) {
+            const auto [end, error] = std::from_chars(text.data() + 1, text.data() + 3, code, 16);
+            if ((error == std::errc{}) && (end == text.data() + 3) && (code < 0x80)) {
+                return std::pair{static_cast<char>(code), size_t{3}};
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// A non-empty, non-comment line.
+    struct Line {
+        size_t number;
+        size_t indent;
+        /// From the first non-space character.
+        std::string_view content;
+
+        /// `- ` of a block sequence entry, followed by the entry.
+        [[nodiscard]] bool isSequenceEntry() const {
+            return (content.front() == '-') && ((content.size() == 1) || isBlank(content[1]));
+        }
+    };
+
+    /// `key: value`
+    struct KeyValue {
+        std::string_view key;
+        /// Rest of the line, after the `:`.
+        std::string_view value;
+    };
+
+    class Parser {
+    private:
+        std::string_view contents;
+        const std::string& filename;
+
+        /// Start of the next source line.
+        size_t position;
+        std::optional<Line> line;
+
+        /// For unescaping quoted scalars.
+        std::string buffer;
+
+    public:
+        Parser(const std::string_view contents, const std::string& filename): contents{contents}, filename{filename}, position{0}, line{}, buffer{} {
+            readLine();
+        }
+
+#pragma mark Errors
+    private:
+        [[noreturn]] void fail(const std::string_view message) const {
+            std::string exceptionMessage{"Invalid YAML file "};
+            exceptionMessage += filename;
+            if (line.has_value()) {
+                exceptionMessage += " (line ";
+                exceptionMessage += std::to_string(line->number);
+                exceptionMessage += ")";
+            }
+            exceptionMessage += ": ";
+            exceptionMessage += message;
+            throw std::runtime_error(exceptionMessage);
+        }
+
+#pragma mark Lines
+    private:
+        /// Next line, skipping blank and comment lines.
+        void readLine() {
+            auto lineNumber = line.has_value() ? line->number : 0;
+            line.reset();
+            while (position < contents.size()) {
+                const auto lineEnd = std::min(contents.find('\n', position), contents.size());
+                auto rawLine = contents.substr(position, lineEnd - position);
+                position = lineEnd + 1;
+                lineNumber += 1;
+                if (!rawLine.empty() && (rawLine.back() == '\r')) {
+                    rawLine.remove_suffix(1);
+                }
+
+                if (!isAtEnd(rawLine)) {
+                    const auto indent = rawLine.find_first_not_of(' ');
+                    line = Line{lineNumber, indent, rawLine.substr(indent)};
+                    return;
+                }
+            }
+        }
+
+        /// `key:` (lowercase letters and `_`), if `text` starts with one.
+        static std::optional<KeyValue> readKeyValue(const std::string_view text) {
+            const auto keyEnd = text.find(':');
+            if ((keyEnd == std::string_view::npos) || (keyEnd == 0) || ((keyEnd + 1 < text.size()) && !isBlank(text[keyEnd + 1]))) {
+                return std::nullopt;
+            }
+
+            const auto key = text.substr(0, keyEnd);
+            if (key.find_first_not_of("abcdefghijklmnopqrstuvwxyz_") != std::string_view::npos) {
+                return std::nullopt;
+            }
+            return KeyValue{key, text.substr(keyEnd + 1)};
+        }
+
+        KeyValue expectKeyValue(const std::string_view text) {
+            const auto keyValue = readKeyValue(text);
+            if (!keyValue.has_value()) {
+                fail("Expected a key.");
+            }
+            return keyValue.value();
+        }
+
+#pragma mark Scalars
+    private:
+        /**
+         * Plain or quoted scalar on a single line, followed by blanks or a comment.
+         *
+         * @return Empty optional for null (`~`, `null`, or nothing).
+         */
+        std::optional<std::string_view> readScalar(std::string_view text) {
+            text = skipBlanks(text);
+            if (isAtEnd(text)) {
+                return std::nullopt;
+            }
+
+            const auto quote = text.front();
+            if ((quote == '\'') || (quote == '"')) {
+                buffer.clear();
+                for (size_t i = 1; i < text.size(); i += 1) {
+                    if ((quote == '\'') && (text.substr(i, 2) == "''")) {
+                        buffer += '\'';
+                        i += 1;
+                    } else if ((quote == '"') && (text[i] == '\\')) {
+                        const auto escapedCharacter = getEscapedCharacter(text.substr(i + 1));
+                        if (!escapedCharacter.has_value()) {
+                            fail("Unsupported escape sequence.");
+                        }
+                        buffer += escapedCharacter->first;
+                        i += escapedCharacter->second;
+                    } else if (text[i] == quote) {
+                        if (!isAtEnd(text.substr(i + 1))) {
+                            fail("Unexpected characters after a quoted string.");
+                        }
+                        return std::string_view{buffer};
+                    } else {
+                        buffer += text[i];
+                    }
+                }
+                fail("Multi-line strings are not supported.");
+            }
+
+            if ((std::string_view{"[]{},&*!|>%@`"}.find(quote) != std::string_view::npos) || (((quote == '-') || (quote == '?') || (quote == ':')) && ((text.size() == 1) || isBlank(text[1])))) {
+                fail("Flow collections, anchors, tags, and block scalars are not supported.");
+            }
+
+            auto end = text.size();
+            for (size_t i = 1; i < text.size(); i += 1) {
+                if ((text[i] == '#') && isBlank(text[i - 1])) {
+                    end = i;
+                    break;
+                }
+            }
+            auto returnValue = text.substr(0, end);
+            while (isBlank(returnValue.back())) {
+                returnValue.remove_suffix(1);
+            }
+
+            if ((returnValue.back() == ':') || (returnValue.find(": ") != std::string_view::npos) || (returnValue.find(":\t") != std::string_view::npos)) {
+                fail("Nested maps are not supported.");
+            } else if ((returnValue == "~") || (returnValue == "null") || (returnValue == "Null") || (returnValue == "NULL")) {
+                return std::nullopt;
+            }
+            return returnValue;
+        }
+
+        /// yaml-cpp reads null as "null".
+        std::string readString(const std::string_view value) {
+            return std::string{readScalar(value).value_or(nullText)};
+        }
+
+        /// Decimal only (yaml-cpp reads leading zeros as octal).
+        std::optional<uint32_t> readInitialSeed(const std::string_view value) {
+            const auto text = readScalar(value);
+            if (!text.has_value()) {
+                return std::nullopt;
+            }
+
+            uint32_t returnValue = 0;
+            const auto [end, error] = std::from_chars(text->data(), text->data() + text->size(), returnValue);
+            if ((error != std::errc{}) || (end != text->data() + text->size()) || ((text->size() > 1) && (text->front() == '0'))) {
+                fail("Invalid initial seed.");
+            }
+            return returnValue;
+        }
+
+        /// A single ID, or a list of IDs on a single line.
+        AbilitySet readSet(std::string_view value, const SetKind kind) {
+            value = skipBlanks(value);
+            if (value.empty() || (value.front() != '[')) {
+                const auto id = readScalar(value);
+                if (!id.has_value()) {
+                    fail("Expected an ID or a list.");
+                }
+                return getSingle(kind, id.value());
+            }
+
+            const auto listEnd = value.find(']');
+            if (listEnd == std::string_view::npos) {
+                fail("Multi-line lists are not supported.");
+            } else if (!isAtEnd(value.substr(listEnd + 1))) {
+                fail("Unexpected characters after a list.");
+            }
+
+            AbilitySet returnValue{};
+            auto elements = skipBlanks(value.substr(1, listEnd - 1));
+            while (!elements.empty()) {
+                const auto separator = std::min(elements.find(','), elements.size());
+                auto id = elements.substr(0, separator);
+                while (!id.empty() && isBlank(id.back())) {
+                    id.remove_suffix(1);
+                }
+                if (id.empty()) {
+                    fail("Expected an ID.");
+                }
+                returnValue.insert(getListElement(kind, id));
+                elements = skipBlanks(elements.substr(std::min(separator + 1, elements.size())));
+            }
+
+            checkListNotEmpty(kind, returnValue);
+            return returnValue;
+        }
+
+#pragma mark Rolls
+    private:
+        /// Roll map at `mapIndent`, after its first key. Keys other than `ability` and `drink` (e.g. `next_seed`) are ignored.
+        void readRollMap(KeyValue keyValue, const size_t mapIndent, RollSequence& rollSequence) {
+            std::optional<AbilitySet> ability{};
+            std::optional<AbilitySet> drinks{};
+
+            while (true) {
+                if (keyValue.key == "ability") {
+                    if (ability.has_value()) {
+                        fail("Duplicate `ability` key.");
+                    }
+                    ability = readSet(keyValue.value, SetKind::abilities);
+                } else if (keyValue.key == "drink") {
+                    if (drinks.has_value()) {
+                        fail("Duplicate `drink` key.");
+                    }
+                    drinks = readSet(keyValue.value, SetKind::drinks);
+                }
+
+                readLine();
+                if (!line.has_value() || (line->indent != mapIndent)) {
+                    break;
+                }
+                keyValue = expectKeyValue(line->content);
+            }
+
+            if (!ability.has_value()) {
+                throw std::runtime_error("No ability key in map.");
+            }
+
+            if (drinks.has_value()) {
+                // Drink used.
+                rollSequence.addRoll(ability.value(), drinks.value());
+            } else {
+                // No drink used.
+                rollSequence.addRoll(ability.value());
+            }
+        }
+
+        /// Block sequence of rolls after `abilities:`, at the key's indentation or deeper.
+        void readRolls(RollSequence& rollSequence) {
+            if (!line.has_value() || !line->isSequenceEntry()) {
+                // Null: No rolls.
+                return;
+            }
+
+            const auto sequenceIndent = line->indent;
+            while (line.has_value() && (line->indent == sequenceIndent) && line->isSequenceEntry()) {
+                const auto entry = skipBlanks(line->content.substr(1));
+                const auto keyValue = readKeyValue(entry);
+                if (keyValue.has_value()) {
+                    // Variant 2.
+                    readRollMap(keyValue.value(), line->indent + line->content.size() - entry.size(), rollSequence);
+                } else {
+                    // Variants 1 and 3.
+                    rollSequence.addRoll(readSet(entry, SetKind::abilities));
+                    readLine();
+                }
+            }
+        }
+
+#pragma mark Document
+    public:
+        GearYamlContents parseDocument() {
+            GearYamlContents returnValue{};
+            bool hasName = false;
+            bool hasBrand = false;
+            bool hasInitialSeed = false;
+            bool hasAbilities = false;
+            const auto setFound = [&](bool& isFound) {
+                if (isFound) {
+                    fail("Duplicate key.");
+                }
+                isFound = true;
+            };
+
+            while (line.has_value()) {
+                if (line->indent != 0) {
+                    fail("Unexpected indentation.");
+                }
+
+                const auto [key, value] = expectKeyValue(line->content);
+                if (key == "name") {
+                    setFound(hasName);
+                    returnValue.name = readString(value);
+                } else if (key == "brand") {
+                    setFound(hasBrand);
+                    returnValue.brand = readString(value);
+                } else if (key == "initial_seed") {
+                    setFound(hasInitialSeed);
+                    returnValue.initialSeed = readInitialSeed(value);
+                } else if (key == "abilities") {
+                    setFound(hasAbilities);
+                    if (!isAtEnd(value)) {
+                        fail("Expected a block list.");
+                    }
+                    readLine();
+                    readRolls(returnValue.rollSequence);
+                    continue;
+                }
+                // Other keys (with single line values) are ignored.
+                readLine();
+            }
+
+            if (!hasName) {
+                throw std::runtime_error("`name` absent from YAML file " + filename);
+            }
+            if (!hasBrand) {
+                throw std::runtime_error("`brand` absent from YAML file " + filename);
+            }
+
+            return returnValue;
+        }
+    };
+
+    GearYamlContents parse(const std::string_view contents, const std::string& filename) {
+        Parser parser{contents, filename};
+        return parser.parseDocument();
+    }
+}
+
+
+#pragma mark - Emitter
+namespace GearYaml {
+    /**
+     * Text that yaml-cpp also writes as is, e.g. gear names: Starting with a letter, a digit, or a non-ASCII character,
+     * without control characters, `: `, ` #`, or a trailing space or `:`.
+     */
+    static bool isPlainScalar(const std::string_view str) {
+        if (str.empty() || (str == "null") || (str == "Null") || (str == "NULL")) {
+            return false;
+        }
+
+        const auto first = static_cast<unsigned char>(str.front());
+        if (!(((first >= '0') && (first <= '9')) || ((first >= 'a') && (first <= 'z')) || ((first >= 'A') && (first <= 'Z')) || (first >= 0x80))) {
+            return false;
+        } else if ((str.back() == ' ') || (str.back() == ':') || (str.find(": ") != std::string_view::npos) || (str.find(" #") != std::string_view::npos)) {
+            return false;
+        }
+        for (const auto c: str) {
+            if ((static_cast<unsigned char>(c) < 0x20) || (c == 0x7F)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Double quoted, with the escape sequences read by `Parser::readScalar`.
+    static void emitDoubleQuotedScalar(OutputBuffer& output, const std::string_view str) {
+        static constexpr std::string_view hexDigits = "0123456789abcdef";
+
+        output << '"';
+        for (const auto c: str) {
+            const auto byte = static_cast<unsigned char>(c);
+            if ((c == '"') || (c == '\\')) {
+                output << '\\' << c;
+            } else if ((byte < 0x20) || (byte == 0x7F)) {
+                // Control characters.
+                output << "\\x" << hexDigits[byte >> 4] << hexDigits[byte & 0xF];
+            } else {
+                output << c;
+            }
+        }
+        output << '"';
+    }
+
+    static void emitScalar(OutputBuffer& output, const std::string_view str) {
+        if (isPlainScalar(str)) {
+            output << str;
+        } else {
+            emitDoubleQuotedScalar(output, str);
+        }
+    }
+
+    /// Inverse of the ability and drink set formats.
+    static void emitSet(OutputBuffer& output, const AbilitySet set, const SetKind kind) {
+        if (((kind == SetKind::abilities) && set.isUnknown()) || ((kind == SetKind::drinks) && (set == AbilitySet::anyDrink()))) {
+            output << AbilityHelper::placeholderId;
+            return;
+        }
+
+        const auto getElementId = [](const Ability ability) {
+            return (ability == Ability::noDrink) ? noDrinkId : AbilityHelper::getId(ability);
+        };
+        if (set.size() == 1) {
+            output << getElementId(set.getSingle());
+            return;
+        }
+
+        output << '[';
+        bool isFirst = true;
+        for (size_t i = 0; i < 16; i += 1) {
+            if ((set.getMask() >> i) & 1) {
+                if (!isFirst) {
+                    output << ", ";
+                }
+                output << getElementId(static_cast<Ability>(i));
+                isFirst = false;
+            }
+        }
+        output << ']';
+    }
+
+    void emit(OutputBuffer& output, const std::string_view name, const std::string_view brand, const std::optional<uint32_t> initialSeed, const RollSequence& rollSequence) {
+        output << "name: ";
+        emitScalar(output, name);
+        output << "\nbrand: ";
+        emitScalar(output, brand);
+        if (initialSeed.has_value()) {
+            output << "\ninitial_seed: " << initialSeed.value();
+        }
+
+        if (!rollSequence.empty()) {
+            output << "\nabilities:";
+            for (const auto [ability, drinks]: rollSequence) {
+                output << "\n  - ";
+                if (drinks == Ability::noDrink) {
+                    emitSet(output, ability, SetKind::abilities);
+                } else {
+                    output << "ability: ";
+                    emitSet(output, ability, SetKind::abilities);
+                    output << "\n    drink: ";
+                    emitSet(output, drinks, SetKind::drinks);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SPLATOON_3_GEAR_HELPER_CPP_GEAR_YAML_H
+#define SPLATOON_3_GEAR_HELPER_CPP_GEAR_YAML_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "../data/roll_sequence.h"
+
+
+class OutputBuffer;
+
+
+/// Contents of a gear YAML file.
+struct GearYamlContents {
+    std::string name;
+    std::string brand;
+    std::optional<uint32_t> initialSeed;
+    RollSequence rollSequence;
+};
+
+/**
+ * Single pass parser and emitter for gear YAML files (`tests/test_yaml/template.yaml`), without a YAML library.
+ *
+ * Only the gear schema is supported:
+ *
+ * - Top-level `name`, `brand`, `initial_seed` (decimal), and `abilities` keys, without indentation
+ * - `abilities` as a block list of IDs, lists of IDs on a single line, or `ability` and `drink` maps
+ * - Plain and quoted scalars on a single line, and comments
+ *
+ * Other keys are ignored if their values fit on a single line. Everything else is rejected.
+ * Supported files are read the same as yaml-cpp (`null` initial seeds are treated as absent).
+ */
+namespace GearYaml {
+    /**
+     * Parse the contents of a gear YAML file.
+     *
+     * Only allocates for the name, brand, and roll sequence.
+     *
+     * @param filename Only used in error messages.
+     * @throws std::runtime_error for invalid or unsupported contents, or `std::invalid_argument` for invalid ability IDs.
+     */
+    GearYamlContents parse(std::string_view contents, const std::string& filename);
+
+    /// Same text as yaml-cpp's emitter (block style, 2 space indentation, no trailing line break), except that unusual names are double quoted.
+    void emit(OutputBuffer& output, std::string_view name, std::string_view brand, std::optional<uint32_t> initialSeed, const RollSequence& rollSequence);
+}
+
+
+#endif //SPLATOON_3_GEAR_HELPER_CPP_GEAR_YAML_H
@@ -5,75 +5,47 @@
 #include "yaml_helper.h"
 
 #include <fstream>
+#include <sstream>
 #include <filesystem>
 
-#include "yaml-cpp/yaml.h"
+#include <fcntl.h>
+#include <unistd.h>
 
+#include "../helpers/output_buffer.h"
 
+
+#pragma mark YamlFile
 void YamlFile::setInitialSeed(uint32_t seed) {
     initialSeed = seed;
     dirty = true;
 }
 
-void YamlFile::addRoll(Ability ability) {
+void YamlFile::addRoll(AbilitySet ability) {
     rollSequence.addRoll(ability);
     dirty = true;
 }
 
-void YamlFile::addRoll(Ability ability, Ability drink) {
+void YamlFile::addRoll(AbilitySet ability, AbilitySet drink) {
     rollSequence.addRoll(ability, drink);
     dirty = true;
 }
 
 void YamlFile::load() {
-    auto root = YAML::LoadFile(filename);
-
-    if (root["name"]) {
-        name = root["name"].as<std::string>();
-    } else {
-        throw std::runtime_error("`name` absent from YAML file " + filename);
+    std::ifstream f(filename);
+    if (!f) {
+        throw std::runtime_error("Failed to open YAML file: " + filename);
     }
-
-    if (root["brand"]) {
-        brand = root["brand"].as<std::string>();
-    } else {
-        throw std::runtime_error("`brand` absent from YAML file " + filename);
+    std::stringstream contents{};
+    contents << f.rdbuf();
+    if (f.bad()) {
+        throw std::runtime_error("Failed to read YAML file: " + filename);
     }
 
-    if (root["initial_seed"]) {
-        initialSeed = root["initial_seed"].as<uint32_t>();
-    }
-
-    const auto& abilitiesNode = root["abilities"];
-    if (abilitiesNode) {
-        for (YAML::const_iterator it = abilitiesNode.begin(); it != abilitiesNode.end(); it ++) {
-            if (it->IsMap()) {
-                // Ability and drink.
-                const auto abilityNode = (*it)["ability"];
-                if (!abilityNode) {
-                    throw std::runtime_error("No ability key in map.");
-                }
-                const auto abilityId = abilityNode.as<std::string>();
-                const auto ability = AbilityHelper::fromId(abilityId);
-
-                const auto drinkNode = (*it)["drink"];
-                if (drinkNode) {
-                    // Drink used.
-                    const auto drinkId = drinkNode.as<std::string>();
-                    const auto drink = AbilityHelper::fromId(drinkId);
-                    rollSequence.addRoll(ability, drink);
-                } else {
-                    // No drink used.
-                    rollSequence.addRoll(ability);
-                }
-            } else {
-                // Ability only.
-                const auto abilityId = it->as<std::string>();
-                const auto ability = AbilityHelper::fromId(abilityId);
-                rollSequence.addRoll(ability);
-            }
-        }
-    }
+    auto [loadedName, loadedBrand, loadedInitialSeed, loadedRollSequence] = GearYaml::parse(contents.str(), filename);
+    name = std::move(loadedName);
+    brand = std::move(loadedBrand);
+    initialSeed = loadedInitialSeed;
+    rollSequence = std::move(loadedRollSequence);
 }
 
 void YamlFile::saveIfDirty() {
@@ -81,31 +53,20 @@ void YamlFile::saveIfDirty() {
         return;
     }
 
-    YAML::Node root{};
-    root["name"] = name;
-    root["brand"] = brand;
-    if (initialSeed.has_value()) {
-        root["initial_seed"] = initialSeed.value();
-    }
-    if (!rollSequence.empty()) {
-        for (const auto [ability, drink]: rollSequence) {
-            const std::string abilityId{AbilityHelper::getId(ability)};
-            if (drink == Ability::noDrink) {
-                root["abilities"].push_back(abilityId);
-            } else {
-                const std::string drinkId{AbilityHelper::getId(drink)};
-
-                YAML::Node currentNode{};
-                currentNode["ability"] = abilityId;
-                currentNode["drink"] = drinkId;
-                root["abilities"].push_back(currentNode);
-            }
-        }
+    const auto fileDescriptor = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0) {
+        throw std::runtime_error("Failed to create YAML file: " + filename);
     }
 
-    std::ofstream f(filename);
-    f << root;
-    f.close();
+    try {
+        OutputBuffer output{fileDescriptor};
+        GearYaml::emit(output, name, brand, initialSeed, rollSequence);
+        output.flush();
+    } catch (...) {
+        ::close(fileDescriptor);
+        throw;
+    }
+    ::close(fileDescriptor);
 
     dirty = false;
 }
@@ -114,12 +75,16 @@ YamlFile::YamlFile(std::string_view filename): filename{filename}, dirty{false},
     if (std::filesystem::is_regular_file(filename)) {
         load();
     } else {
-        throw std::runtime_error("YAML file doesn't exist.");
+        throw std::runtime_error("YAML file doesn't exist: " + this->filename);
     }
 }
 
 YamlFile::~YamlFile() {
-    saveIfDirty();
+    try {
+        saveIfDirty();
+    } catch (const std::runtime_error&) {
+        // Destructors can't throw. Call `saveIfDirty` directly to handle errors.
+    }
 }
 
 
@@ -9,6 +9,7 @@
 #include <string>
 #include <optional>
 
+#include "gear_yaml.h"
 #include "../data/roll_sequence.h"
 
 
@@ -36,18 +37,26 @@ public:
         return initialSeed;
     }
     void setInitialSeed(uint32_t seed);
-    void addRoll(Ability ability);
-    void addRoll(Ability ability, Ability drink);
+    void addRoll(AbilitySet ability);
+    void addRoll(AbilitySet ability, AbilitySet drink);
     inline const RollSequence& getRollSequence() {
         return rollSequence;
     }
 
 private:
-    /// Load file contents.
+    /**
+     * Load file contents.
+     *
+     * @throws std::runtime_error if the file can't be read, or isn't a valid gear file.
+     */
     void load();
 
 public:
-    /// Save file contents if dirty.
+    /**
+     * Save file contents if dirty.
+     *
+     * @throws std::runtime_error if the file can't be written.
+     */
     void saveIfDirty();
 
 #pragma mark Constructors
@@ -57,8 +66,9 @@ public:
     YamlFile& operator=(const YamlFile&) = delete;
 
     /**
-     * Load the contents of `filename` if it exists.
-     * Otherwise, load empty file contents, and create the file until `dirty` is set.
+     * Load the contents of `filename`.
+     *
+     * @throws std::runtime_error if the file doesn't exist, can't be read, or isn't a valid gear file. The message names the file.
      */
     explicit YamlFile(std::string_view filename);
 